@@ -6,7 +6,12 @@
  ******************************************************************************/
 // std
 #include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <memory>
 #include <string_view>
+#include <vector>
 
 // 3rd
 #include <fmt/base.h>
@@ -15,16 +20,27 @@
 #include <fmt/ranges.h>
 #include <fmt/std.h>
 #include <re2/re2.h>
+#include <spdlog/sinks/stderr_color_sinks.h>
 #include <spdlog/spdlog.h>
 
 // local
 #include <sharif/core/app.hpp>
 #include <sharif/core/config.hpp>
 #include <sharif/parse/compile_command.hpp>
+#include <sharif/parse/sarif.hpp>
+#include <sharif/report/baseline.hpp>
+#include <sharif/report/columns.hpp>
+#include <sharif/report/fingerprint.hpp>
+#include <sharif/report/merge.hpp>
+#include <sharif/report/result_table.hpp>
+#include <sharif/report/tables.hpp>
+#include <sharif/tool/clang_tidy.hpp>
 #include <sharif/tool/git.hpp>
 #include <sharif/util/filesystem.hpp>
+#include <sharif/util/log.hpp>
 #include <sharif/util/proc.hpp>
 #include <sharif/util/ranges.hpp>
+#include <sharif/util/source_cache.hpp>
 
 // namespace
 namespace sharif {
@@ -42,6 +58,112 @@ auto to_vector(int argc, char** argv) -> std::vector<std::string>
   }
   return args;
 }
+
+auto write_output(const Config& config, Sarif& sarif) -> void
+{
+  if (config.compact())
+  {
+    for (auto& run : sarif.runs)
+    {
+      compact(run);
+    }
+  }
+
+  // One buffer holds each result in turn on its way to the output
+  std::string buffer;
+  if (config.output().empty())
+  {
+    sarif.write(std::cout, buffer);
+    return;
+  }
+
+  std::ofstream file{ config.output(), std::ios::binary };
+  if (!sarif.write(file, buffer))
+  {
+    log::error("Failed to write '{}'", config.output());
+  }
+}
+
+/** Drops the rows of results in files matching `--exclude`, such as headers of dependencies
+ * that are reached from included sources. Each file is matched once.
+ *
+ * @returns the number of rows removed.
+ */
+auto drop_excluded(const Config& config, ResultTable& table) -> size_t
+{
+  if (config.exclude().empty())
+  {
+    return 0;
+  }
+
+  std::vector<int8_t> excluded(table.strings().size(), -1);
+  return table.filter([&](uint32_t row) {
+    const auto file = table.files()[row];
+    if (file == ResultTable::NONE)
+    {
+      return true;
+    }
+    if (excluded[file] < 0)
+    {
+      excluded[file] = (config.exclude_matches(sarif::from_uri(table.strings()[file]))) ? (1) : (0);
+    }
+    return excluded[file] == 0;
+  });
+}
+
+/** Classifies the results of `config.input()` against `config.baseline()`.
+ *
+ * @returns 1 if any result is new, so CI can gate on regressions while tolerating known issues.
+ */
+auto diff(const Config& config) -> int
+{
+  auto baseline = Baseline::from_file(config.baseline());
+  if (!baseline)
+  {
+    log::error("Failed to read '{}'", config.baseline());
+    return 2;
+  }
+
+  std::ofstream file;
+  if (!config.output().empty())
+  {
+    file.open(config.output(), std::ios::binary);
+  }
+  auto& out   = (config.output().empty()) ? (std::cout) : (static_cast<std::ostream&>(file));
+  auto  added = write_diff(config.input(), *baseline, out, config.compact());
+  if (!added)
+  {
+    log::error("Failed to diff '{}'", config.input());
+    return 2;
+  }
+
+  log::info("{} new result(s) compared to {} baseline result(s)", *added, baseline->size());
+  return (*added > 0) ? (1) : (0);
+}
+
+auto merge(const Config& config) -> int
+{
+  auto merger = Merger{};
+  auto count  = merger.with_jobs(config.jobs()).with_compact(config.compact()).read(config.inputs() | view::transform([](const auto& file) { return fs::path{ file }; }) | range::to<std::vector>());
+  if (!count)
+  {
+    return 2;
+  }
+  log::info("Merged {} result(s) from {} log(s) into {} run(s)", *count, config.inputs().size(), merger.runs());
+
+  if (config.output().empty())
+  {
+    return merger.write(std::cout) ? (0) : (2);
+  }
+
+  std::ofstream file{ config.output(), std::ios::binary };
+  if (!merger.write(file))
+  {
+    log::error("Failed to write '{}'", config.output());
+    return 2;
+  }
+  return 0;
+}
 }  // namespace
 
 struct App::Impl {
@@ -98,8 +220,21 @@ auto App::argv() noexcept -> char**
 
 auto App::exec() -> int
 {
+  // stdout carries the SARIF output when no --output is given
+  log::set_default_logger(std::make_shared<log::logger>("sharif", std::make_shared<log::sinks::stderr_color_sink_mt>()));
+
   _self->config = Config::from_cli(argc(), argv());
-  auto git      = Git{};
+  Process::set_default_backend(_self->config.process_backend());
+  if (_self->config.command() == Config::Command::DIFF)
+  {
+    return diff(_self->config);
+  }
+  if (_self->config.command() == Config::Command::MERGE)
+  {
+    return merge(_self->config);
+  }
+
+  auto git = Git{};
 
   _self->files = git.get_repo_files(_self->config.include());
   if (_self->config.troubleshoot().files)
@@ -108,16 +243,46 @@ auto App::exec() -> int
   }
 
   // fmt::println("{}", git.root_dir());
-  auto commands =
-    CompileCommand::from_file("build/debug/compile_commands.json") | view::filter([this](const auto& cmd) {
+  const auto build_dir = fs::path{ "build/debug" };
+  auto       commands =
+    CompileCommand::from_file((build_dir / "compile_commands.json").string()) | view::filter([this](const auto& cmd) {
       return !_self->config.exclude_matches(cmd.file);
     }) |
-    view::transform([this](const auto& cmd) {
-      return cmd.file_as_path(&project_dir());
-    }) |
     range::to<std::vector>();
 
-  fmt::println("{}", commands);
+  log::debug("Compile commands: {}", commands | view::transform([this](const auto& cmd) { return cmd.file_as_path(&project_dir()); }));
+
+  if (_self->config.command() == Config::Command::LINT)
+  {
+    auto sarif = Sarif{};
+    sarif.runs.push_back(
+      ClangTidy{}
+        .with_build_dir(build_dir)
+        .with_jobs(_self->config.jobs())
+        .with_history(build_dir / "sharif" / "clang-tidy.json")
+        .with_limits(_self->config.tool_limits())
+        .run(commands)
+    );
+
+    auto sources   = SourceCache{};
+    auto hasher    = Fingerprinter{ sources, project_dir().string() };
+    auto converter = ColumnConverter{ sources, project_dir().string() };
+    for (auto& run : sarif.runs)
+    {
+      hasher.apply(*run.results);
+      // clang-tidy reports byte columns; UTF-16 units are what most SARIF viewers assume
+      converter.apply(run, sarif::ColumnKind::utf16CodeUnits);
+
+      auto table = ResultTable::from(*run.results);
+      if (const auto removed = drop_excluded(_self->config, table); removed > 0)
+      {
+        log::debug("Dropped {} result(s) in excluded files", removed);
+      }
+      table.sort_by_location();
+      *run.results = table.select(std::move(*run.results));
+    }
+    write_output(_self->config, sarif);
+  }
 
   // auto proc = sharif::Process("tree");
   // proc.with_args({"/home"});
@@ -6,11 +6,15 @@
 /* Includes
  ******************************************************************************/
 // std
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <filesystem>
+#include <map>
 #include <optional>
 #include <ranges>
 #include <string_view>
+#include <thread>
 
 // 3rd
 #include <CLI/App.hpp>
@@ -193,8 +197,25 @@ auto Config::from_cli(int argc, char** argv) -> Config
   // cli.add_option("-f,--format", self._format, "Input/output format");
   cli.add_option("-p,--project", self._project, "Path to compile_commands.json");
   cli.add_option("--preset", self._preset, "CMakePresets.json configuration preset used to lookup 'compile_commands.json'");
+  cli.add_flag("--compact", self._compact, "Write each rule and artifact once and reference them by index from results");
+  cli.add_option("--process-backend", self._process_backend, "How child processes are run: 'asio', 'uvw' (one libuv loop shared by all children) or 'spawn' (posix_spawn)")
+    ->transform(CLI::CheckedTransformer(std::map<std::string, Process::Backend>{ { "asio", Process::Backend::ASIO }, { "uvw", Process::Backend::UVW }, { "spawn", Process::Backend::SPAWN } }, CLI::ignore_case));
+  cli.add_option("-j,--jobs", self._jobs, "Maximum number of tools to run in parallel")->default_val(std::max(std::thread::hardware_concurrency(), 1U));
 
   CLI::App* lint = cli.add_subcommand("lint");
+  lint->description("Run static analyzers over the compilation database");
+  lint->add_option("--timeout", self._tool_timeout, "Seconds each analyzer process may run before it is terminated (0: no limit)");
+  lint->add_option("--max-memory", self._tool_memory, "Address space each analyzer process may use, in MiB (0: no limit)");
+  lint->add_option("--max-cpu", self._tool_cpu, "CPU seconds each analyzer process may use (0: no limit)");
+
+  CLI::App* diff = cli.add_subcommand("diff");
+  diff->description("Compare a SARIF log against a baseline, failing if it has new results");
+  diff->add_option("-b,--baseline", self._baseline, "SARIF log of the previous run")->required()->check(CLI::ExistingFile);
+  diff->add_option("input", self._input, "SARIF log of the current run")->required()->check(CLI::ExistingFile);
+
+  CLI::App* merge = cli.add_subcommand("merge");
+  merge->description("Combine SARIF logs into one run per tool with shared rule and artifact tables");
+  merge->add_option("inputs", self._inputs, "SARIF logs to merge")->required()->check(CLI::ExistingFile);
 
   CLI::App* inspect = cli.add_subcommand("inspect");
   inspect->description("Inspect the sharif application for troubleshooting");
@@ -231,9 +252,25 @@ auto Config::from_cli(int argc, char** argv) -> Config
       log::warn("Found unrecognized arguments: {}", extra);
     }
 
+    if (lint->parsed())
+    {
+      self._command = Command::LINT;
+    }
+
+    if (diff->parsed())
+    {
+      self._command = Command::DIFF;
+    }
+
+    if (merge->parsed())
+    {
+      self._command = Command::MERGE;
+    }
+
     // Handle inspect sub-command
     if (inspect->parsed())
     {
+      self._command = Command::INSPECT;
       if (self._troubleshoot.config)
       {
         fmt::println("{}", cli.config_to_str(true));
@@ -297,6 +334,50 @@ auto Config::verbosity() const noexcept -> unsigned
   return _verbosity;
 }
 
+auto Config::jobs() const noexcept -> unsigned
+{
+  return _jobs;
+}
+
+auto Config::compact() const noexcept -> bool
+{
+  return _compact;
+}
+
+auto Config::process_backend() const noexcept -> Process::Backend
+{
+  return _process_backend;
+}
+
+auto Config::tool_limits() const noexcept -> Process::Limits
+{
+  return {
+    .timeout       = std::chrono::seconds{ _tool_timeout },
+    .address_space = uint64_t{ _tool_memory } << 20U,
+    .cpu_time      = _tool_cpu,
+  };
+}
+
+auto Config::command() const noexcept -> Command
+{
+  return _command;
+}
+
+auto Config::baseline() const noexcept -> const std::string&
+{
+  return _baseline;
+}
+
+auto Config::input() const noexcept -> const std::string&
+{
+  return _input;
+}
+
+auto Config::inputs() const noexcept -> const std::vector<std::string>&
+{
+  return _inputs;
+}
+
 auto Config::troubleshoot() const noexcept -> const Troubleshoot&
 {
   return _troubleshoot;
@@ -6,12 +6,15 @@
 /* Includes
  ******************************************************************************/
 // std
+#include <cstdint>
 #include <string>
+#include <string_view>
 #include <vector>
 
 // 3rd
 
 // local
+#include <sharif/util/proc.hpp>
 
 // namespace
 namespace sharif {
@@ -20,6 +23,14 @@ namespace sharif {
  ******************************************************************************/
 class Config {
 public:
+  enum class Command : uint8_t {
+    NONE = 0,
+    LINT,
+    INSPECT,
+    DIFF,
+    MERGE,
+  };
+
   Config();
   static auto from_cli(int argc, char** argv) -> Config;
 
@@ -32,6 +43,14 @@ public:
   auto project() const noexcept -> const std::string&;
   auto preset() const noexcept -> const std::string&;
   auto verbosity() const noexcept -> unsigned;
+  auto jobs() const noexcept -> unsigned;
+  auto compact() const noexcept -> bool;
+  auto process_backend() const noexcept -> Process::Backend;
+  auto tool_limits() const noexcept -> Process::Limits;
+  auto command() const noexcept -> Command;
+  auto baseline() const noexcept -> const std::string&;
+  auto input() const noexcept -> const std::string&;
+  auto inputs() const noexcept -> const std::vector<std::string>&;
 
   struct Troubleshoot {
     bool config;
@@ -48,6 +67,16 @@ private:
   std::string _project;
   std::string _preset;
   unsigned    _verbosity;
+  unsigned    _jobs;
+  bool        _compact{ false };
+  Process::Backend _process_backend{ Process::default_backend() };
+  unsigned    _tool_timeout{ 0 };
+  unsigned    _tool_memory{ 0 };
+  unsigned    _tool_cpu{ 0 };
+  Command     _command{ Command::NONE };
+  std::string _baseline;
+  std::string _input;
+  std::vector<std::string> _inputs;
 
   Troubleshoot _troubleshoot{};
 };
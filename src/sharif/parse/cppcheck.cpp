@@ -5,7 +5,10 @@
 /* Includes
  ******************************************************************************/
 // std
+#include <algorithm>
 #include <cassert>
+#include <functional>
+#include <string>
 #include <unordered_set>
 
 // 3rd
@@ -126,4 +129,37 @@ auto Report::from(const fs::path& xml) -> Result<Report>
   };
 }
 
+auto merge(std::vector<Report> reports) -> Report
+{
+  Report merged{ .errors = {}, .version = 2 };
+  merged.errors.reserve(range::fold_left(reports | view::transform([](const auto& r) { return r.errors.size(); }), size_t{ 0 }, std::plus{}));
+
+  std::unordered_set<std::string> seen;
+  std::string                     key;
+  for (auto& report : reports)
+  {
+    for (auto& error : report.errors)
+    {
+      key = error.id;
+      key += '\0';
+      if (!error.locations.empty())
+      {
+        const auto& primary = error.locations.front();
+        key += primary.file;
+        key += '\0';
+        key += std::to_string(primary.line);
+        key += ':';
+        key += std::to_string(primary.column);
+      }
+
+      if (seen.insert(key).second)
+      {
+        merged.errors.push_back(std::move(error));
+      }
+    }
+  }
+
+  return merged;
+}
+
 }  // namespace sharif::cppcheck
@@ -75,6 +75,12 @@ struct Report {
  ******************************************************************************/
 auto parse_severity(std::string_view severity) noexcept -> Severity;
 
+/** Combines reports from several cppcheck invocations (e.g. one per shard of the compilation
+ * database). Errors reported by more than one report are kept once, keyed on their id and
+ * primary location (file, line, column).
+ */
+auto merge(std::vector<Report> reports) -> Report;
+
 };  // namespace sharif::cppcheck
 
 namespace SHARIF_ERROR_NAMESPACE {
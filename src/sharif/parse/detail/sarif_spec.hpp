@@ -31,7 +31,7 @@ constexpr size_t           HEAP_OPTION_THRESHOLD            = 32;
 /* Types
  ******************************************************************************/
 template <typename T>
-using optional_t = std::conditional_t<(sizeof(T) > HEAP_OPTION_THRESHOLD), heap_optional<T>, std::optional<T>>;
+using optional_t = std::conditional_t<(sizeof(T) > HEAP_OPTION_THRESHOLD), pooled_optional<T>, std::optional<T>>;
 
 template <typename Key, typename Value>
 using map_t = std::flat_map<Key, Value>;
@@ -15,6 +15,13 @@
 // namespace
 namespace sharif {
 
+/* Constants
+ ******************************************************************************/
+namespace {
+/// A `file:line:column: severity:` field: up to and past the colon, then any spaces
+constexpr auto FIELD = Parser::PASS | Parser::RTRIM;
+}  // namespace
+
 /* Functions
  ******************************************************************************/
 auto Diagnostic::consume_from_string(std::string_view& str) -> std::optional<Diagnostic>
@@ -25,7 +32,7 @@ auto Diagnostic::consume_from_string(std::string_view& str) -> std::optional<Dia
 
   Diagnostic diagnostic{};
 
-  if (auto file = parse.until_and_past(":").and_rtrim().consume_str(); file)
+  if (auto file = parse.consume<":", FIELD>(); file)
   {
     diagnostic.file = *file;
   }
@@ -37,7 +44,7 @@ auto Diagnostic::consume_from_string(std::string_view& str) -> std::optional<Dia
   // Avoid mistaking Windows drive letter for the full file path before the colon:
   if (parse.pos() == "C:"sv.length())
   {
-    if (auto file = parse.until_and_past(":").and_rtrim().consume_str(); file)
+    if (auto file = parse.consume<":", FIELD>(); file)
     {
       diagnostic.file += ':';
       diagnostic.file += *file;
@@ -48,18 +55,18 @@ auto Diagnostic::consume_from_string(std::string_view& str) -> std::optional<Dia
     }
   }
 
-  if (auto line = parse.until_and_past(":").and_rtrim().consume_uint(); line)
+  if (auto line = parse.consume_uint<":", FIELD>(); line)
   {
     diagnostic.line = *line;
 
-    if (auto col = parse.until_and_past(":").and_rtrim().consume_uint(); col)
+    if (auto col = parse.consume_uint<":", FIELD>(); col)
     {
       diagnostic.column = *col;
     }
   }
 
   auto pos = parse.pos();
-  if (auto severity = parse.until_and_past(":").and_rtrim().consume_str(); severity)
+  if (auto severity = parse.consume<":", FIELD>(); severity)
   {
     if ((*severity == "warning") || (*severity == "error") || (*severity == "note") || (*severity == "fatal error") || (*severity == "internal compiler error") || (*severity == "sorry, unimplemented"))
     {
@@ -71,7 +78,7 @@ auto Diagnostic::consume_from_string(std::string_view& str) -> std::optional<Dia
     }
   }
 
-  if (auto message = parse.to_newline().to_eof().consume_str(); message)
+  if (auto message = parse.consume<"", Parser::TO_CRLF>(); message)
   {
     diagnostic.message = *message;
     if (diagnostic.message.ends_with(']'))
@@ -98,9 +105,9 @@ auto Diagnostic::consume_from_string(std::string_view& str) -> std::optional<Dia
   }
 
   // Parse source as long as the line starts with space
-  while (parse.to_newline().to_eof().peek() == ' ')
+  while (parse.peek() == ' ')
   {
-    if (auto source = parse.consume_str(); source)
+    if (auto source = parse.consume<"", Parser::TO_CRLF>(); source)
     {
       diagnostic.source += *source;
       diagnostic.source += '\n';
@@ -126,6 +133,66 @@ auto Diagnostic::parse_all(std::string_view str) -> std::vector<Diagnostic>
   return diagnostics;
 }
 
+auto Diagnostic::clear() noexcept -> void
+{
+  file.clear();
+  line   = 0;
+  column = 0;
+  severity.clear();
+  message.clear();
+  category.clear();
+  source.clear();
+}
+
+auto DiagnosticStream::feed(std::string_view chunk) -> void
+{
+  _buffer.append(chunk);
+  if (!chunk.ends_with('\n'))
+  {
+    _buffer += '\n';
+  }
+  parse(false);
+}
+
+auto DiagnosticStream::finish() -> void
+{
+  parse(true);
+  _buffer.clear();
+}
+
+auto DiagnosticStream::diagnostics() noexcept -> std::vector<Diagnostic>&
+{
+  return _diagnostics;
+}
+
+auto DiagnosticStream::parse(bool eof) -> void
+{
+  auto pending = std::string_view{ _buffer };
+  while (!pending.empty())
+  {
+    auto rest       = pending;
+    auto diagnostic = Diagnostic::consume_from_string(rest);
+    if (!diagnostic || diagnostic->file.contains('\n'))
+    {
+      // Not a diagnostic (e.g. "3 warnings generated."); drop the line and keep going
+      auto eol = pending.find('\n');
+      pending.remove_prefix((eol == std::string_view::npos) ? (pending.size()) : (eol + 1));
+      continue;
+    }
+
+    if (rest.empty() && !eof)
+    {
+      // Source context lines for the last diagnostic may still arrive with the next chunk
+      break;
+    }
+
+    _diagnostics.push_back(std::move(*diagnostic));
+    pending = rest;
+  }
+
+  _buffer.erase(0, _buffer.size() - pending.size());
+}
+
 }  // namespace sharif
 
 auto fmt::formatter<sharif::Diagnostic>::format(const sharif::Diagnostic& self, format_context& ctx) const -> format_context::iterator
@@ -59,6 +59,32 @@ C:/Users/vagrant/My Documents/diagnostic.cpp:10:8: warning: variable ‘parse’
   static auto consume_from_string(std::string_view& str) -> std::optional<Diagnostic>;
 
   static auto parse_all(std::string_view str) -> std::vector<Diagnostic>;
+
+  /** Empties every field but keeps the strings' buffers, e.g. for `ObjectPool<Diagnostic>`. */
+  auto clear() noexcept -> void;
+};
+
+/** Parses diagnostics from output that arrives in chunks of whole lines, such as a `Process`'
+ * stdout. Lines that do not start a diagnostic are skipped instead of ending the parse.
+ *
+ * A diagnostic is only emitted once the line following it has arrived (or `finish()` is called),
+ * since its source context lines may still be in flight.
+ */
+class DiagnosticStream {
+public:
+  /** Appends a chunk of one or more complete lines (the trailing newline may be omitted). */
+  auto feed(std::string_view chunk) -> void;
+
+  /** Parses whatever is left in the buffer; call once the producer is done. */
+  auto finish() -> void;
+
+  auto diagnostics() noexcept -> std::vector<Diagnostic>&;
+
+private:
+  auto parse(bool eof) -> void;
+
+  std::string             _buffer;
+  std::vector<Diagnostic> _diagnostics;
 };
 
 }  // namespace sharif
@@ -6,7 +6,11 @@
 /* Includes
  ******************************************************************************/
 // std
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <optional>
 #include <string_view>
 
@@ -64,6 +68,22 @@ constexpr auto accept_any_char(char /*chr*/) noexcept -> bool
  ******************************************************************************/
 using check_char = bool (&)(char);
 
+/** A string literal usable as a template argument, e.g. the delimiter in `Parser::consume<":">()`. */
+template <size_t N>
+struct FixedString {
+  constexpr FixedString(const char (&str)[N]) noexcept  // NOLINT(google-explicit-constructor, *-avoid-c-arrays)
+  {
+    std::copy_n(str, N, chars);
+  }
+
+  constexpr auto view() const noexcept -> std::string_view
+  {
+    return { chars, N - 1 };
+  }
+
+  char chars[N]{};  // NOLINT(*-avoid-c-arrays)
+};
+
 class Parser {
 public:
   explicit Parser(std::string_view source);
@@ -119,6 +139,18 @@ public:
 
   auto consume_str(check_char accept_char = accept_any_char) -> std::optional<std::string_view>;
 
+  /** Same as `until(Delimiter)` with `Opts` followed by `consume_str()`, but with the delimiter
+   * and options fixed at compile time, so the scan is a single `memchr` or `find` with no option
+   * checks. An empty `Delimiter` parses to the end of the line or input, as with `to_newline()`.
+   * Options left pending by the builder methods are not used, but discarded like any consume.
+   */
+  template <FixedString Delimiter, Options Opts = DEFAULT>
+  auto consume() noexcept -> std::optional<std::string_view>;
+
+  /** Same as `until(Delimiter)` with `Opts` followed by `consume_uint()`, specialized like `consume()`. */
+  template <FixedString Delimiter, Options Opts = DEFAULT>
+  auto consume_uint() noexcept -> std::optional<uint32_t>;
+
   /** Move the cursor forward `n` chars */
   auto skip(uint32_t n) noexcept -> void;
 
@@ -136,6 +168,18 @@ public:
   auto delimiter() const noexcept -> char;
 
 private:
+  /// Length of a token stopped at some index, and where the cursor moves past it.
+  struct Stop {
+    size_t end;
+    size_t next;
+  };
+
+  template <FixedString Delimiter, Options Opts>
+  static auto find_stop(std::string_view rest) noexcept -> size_t;
+
+  template <FixedString Delimiter, Options Opts>
+  static constexpr auto stop_at(std::string_view rest, size_t stop) noexcept -> Stop;
+
   auto reset_options() noexcept -> void;
   auto skip_space_tab() noexcept -> void;
 
@@ -145,6 +189,137 @@ private:
   Options          _options{ Options::DEFAULT };
 };
 
+/* Functions
+ ******************************************************************************/
+template <FixedString Delimiter, Parser::Options Opts>
+auto Parser::find_stop(std::string_view rest) noexcept -> size_t
+{
+  constexpr auto delimiter = Delimiter.view();
+  constexpr bool crlf      = (static_cast<uint8_t>(Opts) & TO_CRLF) != 0U;
+
+  if constexpr (delimiter.empty() && !crlf)
+  {
+    return rest.size();
+  }
+  else if constexpr (delimiter.size() == 1 && !crlf)
+  {
+    const auto* hit = static_cast<const char*>(std::memchr(rest.data(), delimiter.front(), rest.size()));
+    return (hit != nullptr) ? (static_cast<size_t>(hit - rest.data())) : (rest.size());
+  }
+  else if constexpr (delimiter.size() <= 1)
+  {
+    // `find_first_of` would search its set once per char; these compares fold into the loop
+    constexpr char target = (delimiter.empty()) ? ('\n') : (delimiter.front());
+    const auto     stop   = std::ranges::find_if(rest, [](char chr) { return chr == target || chr == '\n' || chr == '\r'; });
+    return static_cast<size_t>(stop - rest.begin());
+  }
+  else
+  {
+    auto stop = std::min(rest.size(), rest.find(delimiter));
+    if constexpr (crlf)
+    {
+      stop = std::min(stop, rest.find_first_of("\r\n"));
+    }
+    return stop;
+  }
+}
+
+template <FixedString Delimiter, Parser::Options Opts>
+constexpr auto Parser::stop_at(std::string_view rest, size_t stop) noexcept -> Stop
+{
+  constexpr auto delimiter = Delimiter.view();
+  constexpr auto options   = static_cast<uint8_t>(Opts);
+
+  if (!delimiter.empty() && rest.substr(stop).starts_with(delimiter))
+  {
+    if constexpr ((options & PASS) != 0U)
+    {
+      return { stop, stop + delimiter.size() };
+    }
+    else if constexpr ((options & INCLUDE) != 0U)
+    {
+      return { stop + delimiter.size(), stop + delimiter.size() };
+    }
+    else
+    {
+      return { stop, stop };
+    }
+  }
+
+  if constexpr ((options & TO_CRLF) != 0U)
+  {
+    if (stop < rest.size() && rest[stop] == '\n')
+    {
+      return { stop, stop + 1 };
+    }
+    if (stop < rest.size() && rest[stop] == '\r')
+    {
+      return { stop, (stop + 1 < rest.size() && rest[stop + 1] == '\n') ? (stop + 2) : (stop + 1) };
+    }
+  }
+  return { stop, stop };
+}
+
+template <FixedString Delimiter, Parser::Options Opts>
+auto Parser::consume() noexcept -> std::optional<std::string_view>
+{
+  constexpr auto options = static_cast<uint8_t>(Opts);
+  reset_options();
+  if (_pos >= _source.size())
+  {
+    return std::nullopt;
+  }
+  if constexpr ((options & LTRIM) != 0U)
+  {
+    skip_space_tab();
+  }
+
+  const auto rest        = string();
+  const auto [end, next] = stop_at<Delimiter, Opts>(rest, find_stop<Delimiter, Opts>(rest));
+  _pos += next;
+
+  if constexpr ((options & RTRIM) != 0U)
+  {
+    skip_space_tab();
+  }
+  return rest.substr(0, end);
+}
+
+template <FixedString Delimiter, Parser::Options Opts>
+auto Parser::consume_uint() noexcept -> std::optional<uint32_t>
+{
+  static_assert(Delimiter.view().empty() || !is_decimal(Delimiter.view().front()), "the delimiter would be read as a digit");
+
+  constexpr auto options = static_cast<uint8_t>(Opts);
+  reset_options();
+  if (_pos >= _source.size())
+  {
+    return std::nullopt;
+  }
+  if constexpr ((options & LTRIM) != 0U)
+  {
+    skip_space_tab();
+  }
+
+  const auto rest        = string();
+  const auto digits      = static_cast<size_t>(std::ranges::find_if_not(rest, is_decimal) - rest.begin());
+  const auto [end, next] = stop_at<Delimiter, Opts>(rest, digits);
+  _pos += next;
+
+  if constexpr ((options & RTRIM) != 0U)
+  {
+    skip_space_tab();
+  }
+
+  uint32_t value{};
+  auto [ptr, err] = std::from_chars(rest.data(), rest.data() + end, value);
+  if (err == std::errc{} && ptr == rest.data() + end)
+  {
+    return value;
+  }
+  return std::nullopt;
+}
+
 }  // namespace sharif
 
 SHARIF_DECLARE_FLAGS(sharif::Parser::Options);
@@ -5,12 +5,18 @@
 /* Includes
  ******************************************************************************/
 // std
+#include <algorithm>
+#include <fstream>
+#include <utility>
+#include <vector>
 
 // 3rd
 
 // local
+#include <sharif/parse/parser.hpp>
 #include <sharif/parse/sarif.hpp>
 #include <sharif/util/json.hpp>
+#include <sharif/util/log.hpp>
 
 // using
 
@@ -19,14 +25,292 @@ namespace sharif {
 
 /* Functions
  ******************************************************************************/
+auto Sarif::from_file(const fs::path& file) -> Result<Sarif>
+{
+  if (!fs::exists(file))
+  {
+    return Code::no_such_file_or_directory;
+  }
+
+  Sarif       sarif;
+  std::string buffer;
+  if (auto err = json::read_file_json<sarif::READ_OPTS>(sarif, file.string(), buffer); err)
+  {
+    log::error("{}: {}", file.string(), json::format_error(err, buffer));
+    return Code::bad_message;
+  }
+  return sarif;
+}
+
+auto Sarif::write(std::string& buffer) const -> bool
+{
+  return sarif::write(*this, buffer);
+}
+
+auto Sarif::write(std::ostream& out, std::string& buffer) -> bool
+{
+  if (!sarif::write(version, buffer))
+  {
+    return false;
+  }
+
+  out << R"({"version":)" << buffer << R"(,"runs":[)";
+  for (size_t idx = 0; idx < runs.size(); ++idx)
+  {
+    out << ((idx > 0) ? (",") : (""));
+    if (!sarif::write(runs[idx], buffer, out))
+    {
+      return false;
+    }
+  }
+  out << "]}\n";
+  return static_cast<bool>(out);
+}
+
 auto Sarif::to_string() const -> std::string
 {
-  return json::write_json(*this).value_or("");
+  std::string buffer;
+  if (!write(buffer))
+  {
+    log::error("Failed to serialize the SARIF log");
+    buffer.clear();
+  }
+  return buffer;
+}
+
+namespace sarif {
+
+auto to_level(std::string_view severity) noexcept -> Level
+{
+  if ((severity == "error") || (severity == "fatal error") || (severity == "internal compiler error"))
+  {
+    return Level::error;
+  }
+  if (severity == "warning")
+  {
+    return Level::warning;
+  }
+  if (severity == "note")
+  {
+    return Level::note;
+  }
+  return Level::none;
+}
+
+auto to_severity(Level level) noexcept -> std::string_view
+{
+  switch (level)
+  {
+    case Level::error:
+      return "error";
+    case Level::warning:
+      return "warning";
+    case Level::note:
+      return "note";
+    case Level::none:
+      break;
+  }
+  return "";
+}
+
+auto to_uri(std::string_view path) -> std::string
+{
+  std::string uri;
+  uri.reserve(path.size() + sizeof("file:///"));
+
+  const bool is_posix_absolute = path.starts_with('/') && !path.starts_with("//");
+  const bool is_drive_absolute = (path.size() >= 2) && is_letter(path[0]) && (path[1] == ':');
+  const bool is_unc            = path.starts_with("//") || path.starts_with("\\\\");
+  if (is_posix_absolute)
+  {
+    uri = "file://";
+  }
+  else if (is_drive_absolute)
+  {
+    uri = "file:///";
+  }
+  else if (is_unc)
+  {
+    // \\server\share\file -> file://server/share/file
+    uri = "file:";
+  }
+
+  for (const char chr : path)
+  {
+    switch (chr)
+    {
+      case '\\':
+        uri += '/';
+        break;
+      case ' ':
+        uri += "%20";
+        break;
+      case '%':
+        uri += "%25";
+        break;
+      case '#':
+        uri += "%23";
+        break;
+      default:
+        uri += chr;
+        break;
+    }
+  }
+  return uri;
+}
+
+auto from_uri(std::string_view uri) -> std::string
+{
+  using namespace std::string_view_literals;
+  if (uri.starts_with("file:///"sv) && (uri.size() >= 10) && is_letter(uri[8]) && (uri[9] == ':'))
+  {
+    // file:///C:/foo -> C:/foo
+    uri.remove_prefix("file:///"sv.size());
+  }
+  else if (uri.starts_with("file://"sv))
+  {
+    // file:///foo -> /foo, file://server/share -> //server/share
+    uri.remove_prefix("file:"sv.size());
+    if (uri.starts_with("///"sv))
+    {
+      uri.remove_prefix(2);
+    }
+  }
+  else if (uri.starts_with("file:"sv))
+  {
+    uri.remove_prefix("file:"sv.size());
+  }
+
+  auto hex = [](char chr) -> int {
+    if (is_decimal(chr))
+    {
+      return chr - '0';
+    }
+    chr = to_lower(chr);
+    return ('a' <= chr && chr <= 'f') ? (chr - 'a' + 10) : (-1);
+  };
+
+  std::string path;
+  path.reserve(uri.size());
+  for (size_t i = 0; i < uri.size(); ++i)
+  {
+    if ((uri[i] == '%') && (i + 2 < uri.size()) && (hex(uri[i + 1]) >= 0) && (hex(uri[i + 2]) >= 0))
+    {
+      path += static_cast<char>((hex(uri[i + 1]) << 4) | hex(uri[i + 2]));
+      i += 2;
+    }
+    else
+    {
+      path += uri[i];
+    }
+  }
+  return path;
+}
+
+auto to_result(const Diagnostic& diagnostic) -> Result
+{
+  Result result;
+  if (!diagnostic.category.empty())
+  {
+    result.ruleId = diagnostic.category;
+  }
+  result.level        = to_level(diagnostic.severity);
+  result.message.text = diagnostic.message;
+
+  Region region;
+  if (diagnostic.line != 0)
+  {
+    region.startLine = diagnostic.line;
+  }
+  if (diagnostic.column != 0)
+  {
+    region.startColumn = diagnostic.column;
+  }
+
+  PhysicalLocation physical;
+  physical.artifactLocation = ArtifactLocation{ .uri = to_uri(diagnostic.file) };
+  physical.region           = std::move(region);
+
+  Location location;
+  location.physicalLocation = std::move(physical);
+  result.locations          = std::vector<Location>{ std::move(location) };
+
+  return result;
+}
+
+auto to_diagnostic(const Result& result) -> Diagnostic
+{
+  Diagnostic diagnostic{};
+  diagnostic.severity = to_severity(result.level.value_or(Level::warning));
+  diagnostic.message  = result.message.text.value_or("");
+  diagnostic.category = result.ruleId.value_or("");
+
+  if (const auto* physical = primary_location(result); physical != nullptr)
+  {
+    if (physical->artifactLocation && physical->artifactLocation->uri)
+    {
+      diagnostic.file = from_uri(*physical->artifactLocation->uri);
+    }
+    if (physical->region)
+    {
+      diagnostic.line   = physical->region->startLine.value_or(0);
+      diagnostic.column = physical->region->startColumn.value_or(0);
+    }
+  }
+  return diagnostic;
+}
+
+auto write(Run& run, std::string& buffer, std::ostream& out) -> bool
+{
+  auto results = (run.results) ? (std::exchange(*run.results, {})) : (std::vector<Result>{});
+  run.results  = std::nullopt;
+
+  // The run is written without its closing brace, so the results can follow one at a time
+  if (!write(run, buffer) || !buffer.ends_with('}'))
+  {
+    return false;
+  }
+  buffer.pop_back();
+  out << buffer << ((buffer.size() > 1) ? (",") : ("")) << R"("results":[)";
+
+  for (size_t idx = 0; idx < results.size(); ++idx)
+  {
+    if (!write(results[idx], buffer))
+    {
+      return false;
+    }
+    out << ((idx > 0) ? (",") : ("")) << buffer;
+    results[idx] = Result{};
+  }
+  out << "]}";
+  return static_cast<bool>(out);
+}
+
+auto primary_location(const Result& result) noexcept -> const PhysicalLocation*
+{
+  if (!result.locations || result.locations->empty())
+  {
+    return nullptr;
+  }
+  const auto& location = result.locations->front();
+  return (location.physicalLocation) ? (&*location.physicalLocation) : (nullptr);
+}
+
+auto primary_location(Result& result) noexcept -> PhysicalLocation*
+{
+  return const_cast<PhysicalLocation*>(primary_location(std::as_const(result)));  // NOLINT(cppcoreguidelines-pro-type-const-cast)
 }
 
+}  // namespace sarif
 }  // namespace sharif
 
 auto fmt::formatter<sharif::Sarif>::format(const sharif::Sarif& self, format_context& ctx) const -> format_context::iterator
 {
-  return fmt::format_to(ctx.out(), "{}", self.to_string());
+  thread_local std::string buffer;
+  if (!self.write(buffer))
+  {
+    sharif::log::error("Failed to serialize the SARIF log");
+    buffer.clear();
+  }
+  return std::copy(buffer.begin(), buffer.end(), ctx.out());
 }
@@ -10,12 +10,14 @@
 /* Includes
  ******************************************************************************/
 // std
+#include <ostream>
 #include <string>
 
 // 3rd
 
 // local
 #include <sharif/parse/detail/sarif_spec.hpp>
+#include <sharif/parse/diagnostic.hpp>
 #include <sharif/util/filesystem.hpp>
 #include <sharif/util/fmt.hpp>
 #include <sharif/util/json.hpp>
@@ -24,16 +26,77 @@
 // namespace
 namespace sharif {
 
+/* Constants
+ ******************************************************************************/
+namespace sarif {
+/// Logs from other tools may carry properties sharif does not model.
+inline constexpr json::opts READ_OPTS{ .error_on_unknown_keys = false };
+}  // namespace sarif
+
 /* Types
  ******************************************************************************/
 class Sarif {
 public:
+  /** Reads a whole SARIF log into memory, ignoring properties sharif does not model. */
+  static auto from_file(const fs::path& file) -> Result<Sarif>;
+
+  /** Serializes the log into `buffer`, replacing its contents. Reusing the buffer across calls
+   * avoids growing a new string for every log.
+   */
+  auto write(std::string& buffer) const -> bool;
+
+  /** Writes the log to `out` one result at a time, each serialized into `buffer` first, so the
+   * whole log is never held serialized. Results are released as they are written.
+   */
+  auto write(std::ostream& out, std::string& buffer) -> bool;
+
+  /** @returns the serialized log, or an empty string if it could not be serialized. */
   auto to_string() const -> std::string;
 
   std::string             version{ "2.1.0" };
   std::vector<sarif::Run> runs;
 };
 
+namespace sarif {
+
+/* Functions
+ ******************************************************************************/
+/** @returns the SARIF level matching a GCC style severity such as "warning" or "fatal error". */
+auto to_level(std::string_view severity) noexcept -> Level;
+
+/** @returns the GCC style severity for `level`; the inverse of `to_level()`. */
+auto to_severity(Level level) noexcept -> std::string_view;
+
+/** @returns `path` as a relative URI, or a `file://` URI if `path` is absolute. */
+auto to_uri(std::string_view path) -> std::string;
+
+/** @returns the file path `uri` refers to; the inverse of `to_uri()`. */
+auto from_uri(std::string_view uri) -> std::string;
+
+/** Converts a compiler diagnostic into a result with a single physical location. */
+auto to_result(const Diagnostic& diagnostic) -> Result;
+
+/** Converts a result back into a compiler diagnostic using its primary location. */
+auto to_diagnostic(const Result& result) -> Diagnostic;
+
+/** Serializes a single SARIF object, such as a `Result`, into `buffer`, replacing its contents. */
+template <typename T>
+auto write(const T& value, std::string& buffer) -> bool
+{
+  buffer.clear();
+  return !json::write_json(value, buffer);
+}
+
+/** Writes `run` to `out` one result at a time through `buffer`, releasing its results as they
+ * are written. `run` is left without results.
+ */
+auto write(Run& run, std::string& buffer, std::ostream& out) -> bool;
+
+/** @returns the physical location of the result's first location, or `nullptr` if it has none. */
+auto primary_location(const Result& result) noexcept -> const PhysicalLocation*;
+auto primary_location(Result& result) noexcept -> PhysicalLocation*;
+
+}  // namespace sarif
 }  // namespace sharif
 
 template <>
@@ -0,0 +1,431 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+// 3rd
+
+// local
+#include <sharif/parse/sarif_reader.hpp>
+#include <sharif/util/json.hpp>
+#include <sharif/util/log.hpp>
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+namespace {
+constexpr size_t NPOS = std::string_view::npos;
+
+constexpr auto is_space(char chr) noexcept -> bool
+{
+  return chr == ' ' || chr == '\t' || chr == '\r' || chr == '\n';
+}
+
+constexpr auto is_scalar_end(char chr) noexcept -> bool
+{
+  return is_space(chr) || chr == ',' || chr == '}' || chr == ']';
+}
+
+auto skip_space(std::string_view doc, size_t pos) noexcept -> size_t
+{
+  while (pos < doc.size() && is_space(doc[pos]))
+  {
+    ++pos;
+  }
+  return pos;
+}
+
+/** @returns the position after the string whose opening quote is at `pos`, or `NPOS`. */
+auto skip_string(std::string_view doc, size_t pos) noexcept -> size_t
+{
+  for (size_t from = pos + 1; from < doc.size();)
+  {
+    const auto* found = static_cast<const char*>(std::memchr(doc.data() + from, '"', doc.size() - from));
+    if (found == nullptr)
+    {
+      return NPOS;
+    }
+
+    // The quote is escaped if it follows an odd number of backslashes
+    const auto quote   = static_cast<size_t>(found - doc.data());
+    size_t     slashes = 0;
+    while (doc[quote - 1 - slashes] == '\\')
+    {
+      ++slashes;
+    }
+    if (slashes % 2 == 0)
+    {
+      return quote + 1;
+    }
+    from = quote + 1;
+  }
+  return NPOS;
+}
+
+/** @returns the position after the value starting at `pos`, or `NPOS`. */
+auto skip_value(std::string_view doc, size_t pos) noexcept -> size_t
+{
+  if (pos >= doc.size())
+  {
+    return NPOS;
+  }
+
+  const char chr = doc[pos];
+  if (chr == '"')
+  {
+    return skip_string(doc, pos);
+  }
+  if (chr != '{' && chr != '[')
+  {
+    const auto begin = pos;
+    while (pos < doc.size() && !is_scalar_end(doc[pos]))
+    {
+      ++pos;
+    }
+    return (pos != begin) ? (pos) : (NPOS);
+  }
+
+  size_t depth = 0;
+  while (pos < doc.size())
+  {
+    switch (doc[pos])
+    {
+      case '"':
+        pos = skip_string(doc, pos);
+        if (pos == NPOS)
+        {
+          return NPOS;
+        }
+        continue;
+      case '{':
+      case '[':
+        ++depth;
+        break;
+      case '}':
+      case ']':
+        if (--depth == 0)
+        {
+          return pos + 1;
+        }
+        break;
+      default:
+        break;
+    }
+    ++pos;
+  }
+  return NPOS;
+}
+
+/** Calls `fn(property, value)` for each member of the object at `pos` until it returns false.
+ *
+ * @returns the position after the object, or after the value `fn` stopped at, or `NPOS` if the
+ * object is malformed.
+ */
+template <typename Fn>
+auto for_each_member(std::string_view doc, size_t pos, Fn&& fn) -> size_t
+{
+  if (pos >= doc.size() || doc[pos] != '{')
+  {
+    return NPOS;
+  }
+
+  pos = skip_space(doc, pos + 1);
+  if (pos < doc.size() && doc[pos] == '}')
+  {
+    return pos + 1;
+  }
+
+  while (pos < doc.size() && doc[pos] == '"')
+  {
+    const auto name_end = skip_string(doc, pos);
+    if (name_end == NPOS)
+    {
+      return NPOS;
+    }
+    const auto name = doc.substr(pos + 1, name_end - pos - 2);
+
+    pos = skip_space(doc, name_end);
+    if (pos >= doc.size() || doc[pos] != ':')
+    {
+      return NPOS;
+    }
+
+    const auto begin = skip_space(doc, pos + 1);
+    const auto end   = skip_value(doc, begin);
+    if (end == NPOS)
+    {
+      return NPOS;
+    }
+    if (!fn(name, doc.substr(begin, end - begin)))
+    {
+      return end;
+    }
+
+    pos = skip_space(doc, end);
+    if (pos < doc.size() && doc[pos] == '}')
+    {
+      return pos + 1;
+    }
+    if (pos >= doc.size() || doc[pos] != ',')
+    {
+      return NPOS;
+    }
+    pos = skip_space(doc, pos + 1);
+  }
+  return NPOS;
+}
+
+/** Moves past whitespace and the separator between array elements. */
+auto next_element(std::string_view doc, size_t pos) noexcept -> size_t
+{
+  pos = skip_space(doc, pos);
+  if (pos < doc.size() && doc[pos] == ',')
+  {
+    pos = skip_space(doc, pos + 1);
+  }
+  return pos;
+}
+}  // namespace
+
+SarifReader::SarifReader(std::string_view document)
+  : _document{ document }
+  , _skipped{ std::begin(DEFAULT_SKIPPED), std::end(DEFAULT_SKIPPED) }
+{
+}
+
+auto SarifReader::open(const fs::path& file) -> Result<SarifReader>
+{
+  SHARIF_TRY(auto mapping, MappedFile::open(file));
+
+  // The mapping's pages do not move with it, so the view stays valid
+  SarifReader reader{ mapping.view() };
+  reader._file = std::move(mapping);
+  return reader;
+}
+
+auto SarifReader::skip(std::string property) -> SarifReader&
+{
+  if (!is_skipped(property))
+  {
+    _skipped.push_back(std::move(property));
+  }
+  return *this;
+}
+
+auto SarifReader::keep(std::string_view property) -> SarifReader&
+{
+  std::erase(_skipped, property);
+  return *this;
+}
+
+auto SarifReader::next(sarif::Result& result) -> Result<bool>
+{
+  while (true)
+  {
+    if (_state == State::RESULTS)
+    {
+      SHARIF_TRY(auto more, next_result(result));
+      if (more)
+      {
+        return true;
+      }
+    }
+    SHARIF_TRY(auto more, next_run());
+    if (!more)
+    {
+      return false;
+    }
+  }
+}
+
+auto SarifReader::next_run() -> Result<bool>
+{
+  if (_state == State::LOG && !start_log())
+  {
+    return fail("log");
+  }
+  if (_state == State::RESULTS)
+  {
+    _pos   = _run_end;
+    _state = State::RUNS;
+  }
+  if (_state == State::DONE)
+  {
+    return false;
+  }
+
+  _pos = next_element(_document, _pos);
+  if (_pos >= _document.size())
+  {
+    return fail("runs");
+  }
+  if (_document[_pos] == ']')
+  {
+    _state = State::DONE;
+    return false;
+  }
+  if (!start_run())
+  {
+    return fail("run");
+  }
+  return true;
+}
+
+auto SarifReader::next_result(sarif::Result& result) -> Result<bool>
+{
+  if (_state != State::RESULTS)
+  {
+    return false;
+  }
+
+  _pos = next_element(_document, _pos);
+  if (_pos >= _document.size())
+  {
+    return fail("results");
+  }
+  if (_document[_pos] == ']')
+  {
+    _pos   = _run_end;
+    _state = State::RUNS;
+    return false;
+  }
+
+  _scratch = '{';
+  auto end = for_each_member(_document, _pos, [&](std::string_view property, std::string_view value) {
+    append(property, value);
+    return true;
+  });
+  if (end == NPOS)
+  {
+    return fail("result");
+  }
+  _scratch += '}';
+
+  result = sarif::Result{};
+  if (auto err = json::read<sarif::READ_OPTS>(result, _scratch); err)
+  {
+    log::error("Invalid SARIF result near offset {}: {}", _pos, json::format_error(err, _scratch));
+    return Code::bad_message;
+  }
+  _pos = end;
+  return true;
+}
+
+auto SarifReader::run() const noexcept -> const sarif::Run&
+{
+  return _run;
+}
+
+auto SarifReader::run_index() const noexcept -> size_t
+{
+  return (_runs > 0) ? (_runs - 1) : (0);
+}
+
+auto SarifReader::version() const noexcept -> std::string_view
+{
+  return _version;
+}
+
+auto SarifReader::start_log() -> bool
+{
+  auto runs = NPOS;
+  auto end  = for_each_member(_document, skip_space(_document, 0), [&](std::string_view property, std::string_view value) {
+    if (property == "version" && value.size() >= 2)
+    {
+      _version = value.substr(1, value.size() - 2);
+    }
+    if (property == "runs")
+    {
+      runs = static_cast<size_t>(value.data() - _document.data());
+      return false;
+    }
+    return true;
+  });
+  if (end == NPOS)
+  {
+    return false;
+  }
+
+  _state = (runs != NPOS && _document[runs] == '[') ? (State::RUNS) : (State::DONE);
+  _pos   = runs + 1;
+  return true;
+}
+
+auto SarifReader::start_run() -> bool
+{
+  auto results = NPOS;
+  _scratch     = '{';
+  auto end     = for_each_member(_document, _pos, [&](std::string_view property, std::string_view value) {
+    if (property == "results")
+    {
+      results = static_cast<size_t>(value.data() - _document.data());
+    }
+    else
+    {
+      append(property, value);
+    }
+    return true;
+  });
+  if (end == NPOS)
+  {
+    return false;
+  }
+  _scratch += '}';
+
+  _run = sarif::Run{};
+  if (auto err = json::read<sarif::READ_OPTS>(_run, _scratch); err)
+  {
+    log::error("Invalid SARIF run near offset {}: {}", _pos, json::format_error(err, _scratch));
+    return false;
+  }
+
+  ++_runs;
+  _run_end = end;
+  if (results != NPOS && _document[results] == '[')
+  {
+    _pos   = results + 1;
+    _state = State::RESULTS;
+  }
+  else
+  {
+    _pos = end;
+  }
+  return true;
+}
+
+auto SarifReader::fail(std::string_view what) const -> Code
+{
+  log::error("Malformed SARIF {} near offset {}", what, _pos);
+  return Code::bad_message;
+}
+
+auto SarifReader::is_skipped(std::string_view property) const noexcept -> bool
+{
+  return std::ranges::find(_skipped, property) != _skipped.end();
+}
+
+auto SarifReader::append(std::string_view property, std::string_view value) -> void
+{
+  if (is_skipped(property))
+  {
+    return;
+  }
+  if (_scratch.size() > 1)
+  {
+    _scratch += ',';
+  }
+  _scratch += '"';
+  _scratch += property;
+  _scratch += "\":";
+  _scratch += value;
+}
+
+}  // namespace sharif
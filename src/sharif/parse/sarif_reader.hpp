@@ -0,0 +1,116 @@
+/** @file
+ *
+ * Pull parser for SARIF logs too large to hold in memory as `Sarif`.
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/parse/sarif.hpp>
+#include <sharif/util/filesystem.hpp>
+#include <sharif/util/mapped_file.hpp>
+#include <sharif/util/result.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Walks `runs[].results[]` of a SARIF log, yielding one `sarif::Result` at a time.
+ *
+ * The document is memory mapped and scanned without building a DOM. Only the result being
+ * returned and the properties of the current run (other than its results) are materialized;
+ * skipped properties such as `graphs` and `webRequests` are stepped over without allocating.
+ *
+ * @code
+ * SHARIF_TRY(auto reader, SarifReader::open("codeql.sarif"));
+ * sarif::Result result;
+ * while (*reader.next(result))
+ * {
+ *   use(reader.run().tool.driver.name, result);
+ * }
+ * @endcode
+ */
+class SarifReader {
+public:
+  /// Properties of runs and results that are skipped unless `keep()` is called.
+  static constexpr std::string_view DEFAULT_SKIPPED[] = {
+    "graphs", "graphTraversals", "webRequests", "webResponses", "webRequest", "webResponse",
+  };
+
+  /** Reads an in-memory document; `document` must outlive the reader. */
+  explicit SarifReader(std::string_view document);
+
+  static auto open(const fs::path& file) -> Result<SarifReader>;
+
+  /** Skips `property` of runs and results. */
+  auto skip(std::string property) -> SarifReader&;
+
+  /** Reads `property` of runs and results, even if it is skipped by default. */
+  auto keep(std::string_view property) -> SarifReader&;
+
+  /** Reads the next result into `result`, replacing its contents.
+   *
+   * @returns false once every run has been read.
+   */
+  auto next(sarif::Result& result) -> Result<bool>;
+
+  /** Moves to the next run, skipping the results of the current one that were not read.
+   * Unlike `next()`, this stops at runs without results.
+   *
+   * @returns false once every run has been read.
+   */
+  auto next_run() -> Result<bool>;
+
+  /** Reads the next result of the current run into `result`.
+   *
+   * @returns false once every result of the run has been read.
+   */
+  auto next_result(sarif::Result& result) -> Result<bool>;
+
+  /** Properties of the current run. `results` is never populated. */
+  auto run() const noexcept -> const sarif::Run&;
+
+  /** Index of the current run. */
+  auto run_index() const noexcept -> size_t;
+
+  /** The log's `version`, if it appears before `runs`. */
+  auto version() const noexcept -> std::string_view;
+
+private:
+  enum class State : uint8_t {
+    LOG,
+    RUNS,
+    RESULTS,
+    DONE,
+  };
+
+  auto start_log() -> bool;
+  auto start_run() -> bool;
+  auto fail(std::string_view what) const -> Code;
+  auto is_skipped(std::string_view property) const noexcept -> bool;
+  auto append(std::string_view property, std::string_view value) -> void;
+
+  MappedFile               _file;
+  std::string_view         _document;
+  size_t                   _pos{ 0 };
+  size_t                   _run_end{ 0 };
+  size_t                   _runs{ 0 };  ///< Runs started so far
+  State                    _state{ State::LOG };
+  std::string_view         _version;
+  sarif::Run               _run;
+  std::vector<std::string> _skipped;
+  std::string              _scratch;  ///< Kept properties of the object being read, reused between reads
+};
+
+}  // namespace sharif
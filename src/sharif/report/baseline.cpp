@@ -0,0 +1,448 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+
+// 3rd
+
+// local
+#include <sharif/parse/sarif_reader.hpp>
+#include <sharif/report/baseline.hpp>
+#include <sharif/report/fingerprint.hpp>
+#include <sharif/report/tables.hpp>
+#include <sharif/util/log.hpp>
+#include <sharif/util/ranges.hpp>
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+namespace {
+/** Hash of the properties that may change while the result keeps its identity. */
+auto detail(const sarif::Result& result) -> uint64_t
+{
+  Hasher hasher;
+  if (const auto* location = sarif::primary_location(result); location && location->region)
+  {
+    hasher.add((uint64_t{ location->region->startLine.value_or(0) } << 32U) | location->region->startColumn.value_or(0));
+  }
+  hasher.add(static_cast<uint64_t>(result.level.value_or(sarif::Level::warning)));
+  hasher.add((result.message.text) ? (std::string_view{ *result.message.text }) : (std::string_view{}));
+  return hasher.value();
+}
+
+auto find_fingerprint(const sarif::Result& result, std::string_view key) -> const std::string*
+{
+  if (!result.partialFingerprints)
+  {
+    return nullptr;
+  }
+  auto it = result.partialFingerprints->find(std::string{ key });
+  return (it != result.partialFingerprints->end()) ? (&it->second) : (nullptr);
+}
+
+/** @returns `location`, or the location of the artifact it references by index in `run` if it
+ * has no URI of its own.
+ */
+auto resolve(const sarif::ArtifactLocation& location, const sarif::Run* run) -> const sarif::ArtifactLocation*
+{
+  const auto idx = location.index.value_or(-1);
+  if (location.uri || run == nullptr || !run->artifacts || idx < 0 || static_cast<size_t>(idx) >= run->artifacts->size())
+  {
+    return &location;
+  }
+  const auto& artifact = (*run->artifacts)[static_cast<size_t>(idx)];
+  return (artifact.location) ? (&*artifact.location) : (&location);
+}
+
+/** @returns the rule id of `result`, looked up in the driver rules of `run` if it only has an index. */
+auto rule_id(const sarif::Result& result, const sarif::Run* run) -> std::string_view
+{
+  const auto idx = result.ruleIndex.value_or(-1);
+  if (result.ruleId)
+  {
+    return *result.ruleId;
+  }
+  if (run == nullptr || !run->tool.driver.rules || (result.rule && result.rule->toolComponent) || idx < 0 || static_cast<size_t>(idx) >= run->tool.driver.rules->size())
+  {
+    return {};
+  }
+  return (*run->tool.driver.rules)[static_cast<size_t>(idx)].id;
+}
+
+/** Marks `result`, read from the baseline run `run`, as absent and replaces its references
+ * into the tables of `run` with the URIs and rule id they stand for.
+ */
+auto to_absent(sarif::Result& result, const sarif::Run* run) -> void
+{
+  result.baselineState = std::string{ to_string(sarif::BaselineState::absent) };
+
+  if (const auto rule = rule_id(result, run); !result.ruleId && !rule.empty())
+  {
+    result.ruleId = std::string{ rule };
+  }
+  result.ruleIndex = std::nullopt;
+  if (result.rule)
+  {
+    result.rule->index = std::nullopt;
+    if (result.rule->toolComponent)
+    {
+      result.rule->toolComponent->index = std::nullopt;
+    }
+  }
+
+  for_each_artifact_location(result, [&](sarif::ArtifactLocation& location) {
+    if (const auto* artifact = resolve(location, run); artifact != &location)
+    {
+      location.uri       = artifact->uri;
+      location.uriBaseId = artifact->uriBaseId;
+    }
+    location.index = std::nullopt;
+  });
+}
+
+/** @returns the tool of each run of `file`. */
+auto read_drivers(const fs::path& file) -> Result<std::vector<std::string>>
+{
+  SHARIF_TRY(auto reader, SarifReader::open(file));
+
+  std::vector<std::string> drivers;
+  while (true)
+  {
+    SHARIF_TRY(auto more, reader.next_run());
+    if (!more)
+    {
+      break;
+    }
+    drivers.push_back(reader.run().tool.driver.name);
+  }
+  return drivers;
+}
+}  // namespace
+
+auto to_string(sarif::BaselineState state) noexcept -> std::string_view
+{
+  switch (state)
+  {
+    case sarif::BaselineState::new_:
+      return "new";
+    case sarif::BaselineState::unchanged:
+      return "unchanged";
+    case sarif::BaselineState::updated:
+      return "updated";
+    case sarif::BaselineState::absent:
+      return "absent";
+  }
+  return "new";
+}
+
+auto write_diff(const fs::path& file, Baseline& baseline, std::ostream& out, bool compact) -> Result<size_t>
+{
+  // A first pass over the run headers finds the last run of each tool, where its absent results go
+  SHARIF_TRY(auto drivers, read_drivers(file));
+  SHARIF_TRY(auto reader, SarifReader::open(file));
+
+  size_t        added = 0;
+  std::string   buffer;
+  sarif::Result result;
+  RunTables     tables;
+  TableMap      map;
+
+  out << R"({"version":"2.1.0","runs":[)";
+  for (size_t idx = 0;; ++idx)
+  {
+    SHARIF_TRY(auto more, reader.next_run());
+    if (!more)
+    {
+      break;
+    }
+
+    auto       run    = reader.run();
+    const auto driver = (drivers.size() == 1) ? (std::string_view{}) : (std::string_view{ drivers[idx] });
+    if (compact)
+    {
+      map = absorb_tables(run, tables);
+    }
+
+    // Results are written before the run's own properties, as compacting adds to its tables
+    size_t count = 0;
+    auto   emit  = [&](sarif::Result& value) {
+      if (compact)
+      {
+        reindex(value, map, tables);
+        strip_indexed_uris(value);
+      }
+      if (!sarif::write(value, buffer))
+      {
+        return false;
+      }
+      out << ((count++ > 0) ? (",") : ("")) << buffer;
+      return true;
+    };
+
+    out << ((idx > 0) ? (",") : ("")) << R"({"results":[)";
+    while (true)
+    {
+      SHARIF_TRY(auto found, reader.next_result(result));
+      if (!found)
+      {
+        break;
+      }
+      added += (baseline.classify(result, driver, &reader.run()) == sarif::BaselineState::new_) ? (1U) : (0U);
+      if (!emit(result))
+      {
+        return Code::bad_message;
+      }
+    }
+
+    if (std::find(drivers.begin() + static_cast<ptrdiff_t>(idx) + 1, drivers.end(), drivers[idx]) == drivers.end())
+    {
+      SHARIF_TRY(auto absent, baseline.absent(driver));
+      for (auto& missing : absent)
+      {
+        if (!emit(missing))
+        {
+          return Code::bad_message;
+        }
+      }
+    }
+    out << ']';
+
+    if (compact)
+    {
+      emplace_tables(run, tables);
+    }
+    if (!baseline.guid().empty())
+    {
+      run.baselineGuid = baseline.guid();
+    }
+    if (!sarif::write(run, buffer) || !buffer.starts_with('{'))
+    {
+      return Code::bad_message;
+    }
+    out << ((buffer.size() > 2) ? (",") : ("")) << std::string_view{ buffer }.substr(1);
+  }
+  out << "]}\n";
+
+  if (!out)
+  {
+    return Code::io_error;
+  }
+  return added;
+}
+
+auto Baseline::from_file(const fs::path& file) -> Result<Baseline>
+{
+  SHARIF_TRY(auto reader, SarifReader::open(file));
+
+  // Only what is needed to match results is read; absent() reads the rest again
+  for (const auto* property : { "codeFlows", "stacks", "fixes", "attachments", "relatedLocations", "invocations", "logicalLocations", "threadFlowLocations" })
+  {
+    reader.skip(property);
+  }
+
+  Baseline      baseline;
+  sarif::Result result;
+  baseline._file = file;
+  while (true)
+  {
+    SHARIF_TRY(auto more, reader.next(result));
+    if (!more)
+    {
+      break;
+    }
+
+    const auto& run = reader.run();
+    if (baseline._guid.empty() && run.automationDetails && run.automationDetails->guid)
+    {
+      baseline._guid = *run.automationDetails->guid;
+    }
+    baseline.insert(identity(result, &run), detail(result), run.tool.driver.name);
+  }
+  return baseline;
+}
+
+auto Baseline::identity(const sarif::Result& result, const sarif::Run* run) -> uint64_t
+{
+  const auto rule = rule_id(result, run);
+  if (const auto* fingerprint = find_fingerprint(result, FINGERPRINT_KEY))
+  {
+    return hash_bytes(*fingerprint);
+  }
+  if (const auto* line_hash = find_fingerprint(result, LINE_HASH_KEY))
+  {
+    return Hasher{}.add(rule).add(*line_hash).value();
+  }
+
+  Hasher hasher;
+  hasher.add(rule);
+  if (const auto* location = sarif::primary_location(result); location && location->artifactLocation)
+  {
+    if (const auto* artifact = resolve(*location->artifactLocation, run); artifact->uri)
+    {
+      hasher.add(*artifact->uri);
+    }
+  }
+  hasher.add(Fingerprinter::message_template((result.message.text) ? (std::string_view{ *result.message.text }) : (std::string_view{})));
+  return hasher.value();
+}
+
+auto Baseline::add(sarif::Result result, std::string_view driver) -> void
+{
+  insert(identity(result), detail(result), driver);
+  _results.push_back(std::move(result));
+}
+
+auto Baseline::insert(uint64_t id, uint64_t properties, std::string_view driver) -> void
+{
+  auto tool = static_cast<uint32_t>(range::find(_drivers, driver) - _drivers.begin());
+  if (tool == _drivers.size())
+  {
+    _drivers.emplace_back(driver);
+  }
+
+  const auto idx    = static_cast<uint32_t>(_entries.size());
+  const auto append = [&](Chains& chains, uint64_t key, uint32_t Entry::* next) {
+    auto [it, inserted] = chains.try_emplace(key, Chain{ .first = idx, .last = idx });
+    auto& chain         = it->second;
+    if (!inserted)
+    {
+      if (chain.first == NONE)
+      {
+        chain.first = idx;
+      }
+      else
+      {
+        _entries[chain.last].*next = idx;
+      }
+      chain.last = idx;
+    }
+  };
+
+  _entries.push_back(Entry{ .detail = properties, .driver = tool });
+  const auto key = Hasher{}.add(id).add(uint64_t{ tool }).value();
+  append(_index, key, &Entry::next);
+  append(_exact, Hasher{}.add(key).add(properties).value(), &Entry::next_exact);
+}
+
+auto Baseline::take(Chains& chains, uint64_t key, uint32_t Entry::* next) -> uint32_t
+{
+  auto it = chains.find(key);
+  if (it == chains.end())
+  {
+    return NONE;
+  }
+
+  // Entries matched through the other chain are passed over once, then never seen again
+  auto& first = it->second.first;
+  while (first != NONE && _entries[first].matched)
+  {
+    first = _entries[first].*next;
+  }
+  const auto idx = first;
+  if (idx != NONE)
+  {
+    _entries[idx].matched = true;
+    first                 = _entries[idx].*next;
+  }
+  return idx;
+}
+
+auto Baseline::classify(sarif::Result& result, std::string_view driver, const sarif::Run* run) -> sarif::BaselineState
+{
+  // Results of a log with a single run match results of any tool
+  auto first = uint32_t{ 0 };
+  auto last  = static_cast<uint32_t>(_drivers.size());
+  if (!driver.empty())
+  {
+    first = static_cast<uint32_t>(range::find(_drivers, driver) - _drivers.begin());
+    last  = std::min(first + 1, last);
+  }
+
+  // Prefer an identical unmatched result over one that merely shares the identity
+  const auto id         = identity(result, run);
+  const auto properties = detail(result);
+  auto       state      = sarif::BaselineState::new_;
+  for (auto tool = first; tool < last && state == sarif::BaselineState::new_; ++tool)
+  {
+    const auto key = Hasher{}.add(id).add(uint64_t{ tool }).value();
+    if (take(_exact, Hasher{}.add(key).add(properties).value(), &Entry::next_exact) != NONE)
+    {
+      state = sarif::BaselineState::unchanged;
+    }
+  }
+  for (auto tool = first; tool < last && state == sarif::BaselineState::new_; ++tool)
+  {
+    if (take(_index, Hasher{}.add(id).add(uint64_t{ tool }).value(), &Entry::next) != NONE)
+    {
+      state = sarif::BaselineState::updated;
+    }
+  }
+
+  result.baselineState = std::string{ to_string(state) };
+  return state;
+}
+
+auto Baseline::absent(std::string_view driver) const -> Result<std::vector<sarif::Result>>
+{
+  const auto is_absent = [&](size_t idx) { return !_entries[idx].matched && (driver.empty() || _drivers[_entries[idx].driver] == driver); };
+  const auto count     = static_cast<size_t>(range::count_if(view::iota(size_t{ 0 }, _entries.size()), is_absent));
+
+  std::vector<sarif::Result> results;
+  results.reserve(count);
+  if (_file.empty())
+  {
+    for (size_t idx = 0; idx < _results.size(); ++idx)
+    {
+      if (is_absent(idx))
+      {
+        to_absent(results.emplace_back(_results[idx]), nullptr);
+      }
+    }
+    return results;
+  }
+  if (count == 0)
+  {
+    return results;
+  }
+
+  // Results are numbered in the order from_file() read them
+  SHARIF_TRY(auto reader, SarifReader::open(_file));
+  sarif::Result result;
+  for (size_t idx = 0; results.size() < count; ++idx)
+  {
+    SHARIF_TRY(auto more, reader.next(result));
+    if (!more || idx >= _entries.size())
+    {
+      log::error("'{}' changed since it was read as a baseline", _file.string());
+      return Code::bad_message;
+    }
+    if (is_absent(idx))
+    {
+      to_absent(result, &reader.run());
+      results.push_back(std::move(result));
+    }
+  }
+  return results;
+}
+
+auto Baseline::guid() const noexcept -> const std::string&
+{
+  return _guid;
+}
+
+auto Baseline::size() const noexcept -> size_t
+{
+  return _entries.size();
+}
+
+}  // namespace sharif
@@ -0,0 +1,121 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/parse/sarif.hpp>
+#include <sharif/util/filesystem.hpp>
+#include <sharif/util/hash.hpp>
+#include <sharif/util/result.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Results of a previous run, indexed by fingerprint so that each result of the current run
+ * can be classified as new, unchanged or updated in constant time.
+ *
+ * Results are identified by their `sharif/v1` partial fingerprint when present (see
+ * `Fingerprinter`), falling back to the line hash, then to (rule, file, message).
+ * A matching result whose line, column, level or message differ is "updated".
+ *
+ * Only a few bytes of keys are kept per result of a baseline read with `from_file()`; the
+ * results that end up absent are read again from the file by `absent()`.
+ */
+class Baseline {
+public:
+  /** Indexes the results of every run in a SARIF log. */
+  static auto from_file(const fs::path& file) -> Result<Baseline>;
+
+  /** @returns the hash results are matched on. A `ruleIndex` without a `ruleId`, and an
+   * `ArtifactLocation.index` without a URI, are resolved against the tables of `run`.
+   */
+  static auto identity(const sarif::Result& result, const sarif::Run* run = nullptr) -> uint64_t;
+
+  /** Adds a result of the previous run produced by the tool `driver`. Unlike those read by
+   * `from_file()`, the result is kept in memory.
+   */
+  auto add(sarif::Result result, std::string_view driver = {}) -> void;
+
+  /** Sets `result.baselineState` and marks the baseline result it matched, if any. A non-empty
+   * `driver` only matches results of that tool. `run` is the run of `result`, see `identity()`.
+   */
+  auto classify(sarif::Result& result, std::string_view driver = {}, const sarif::Run* run = nullptr) -> sarif::BaselineState;
+
+  /** @returns the baseline results produced by `driver` that no `classify()` call matched,
+   * with `baselineState` set to "absent". An empty `driver` returns absent results of all tools.
+   *
+   * Their URIs are resolved and their rule and artifact indices dropped, as they point into the
+   * baseline's tables.
+   */
+  auto absent(std::string_view driver = {}) const -> Result<std::vector<sarif::Result>>;
+
+  /** The `automationDetails.guid` of the baseline run, if it had one. */
+  auto guid() const noexcept -> const std::string&;
+
+  auto size() const noexcept -> size_t;
+
+private:
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+  /// Entry `i` is the `i`-th result of the baseline.
+  struct Entry {
+    uint64_t detail;
+    uint32_t driver;
+    uint32_t next{ NONE };        ///< Next entry with the same identity and tool
+    uint32_t next_exact{ NONE };  ///< Next entry with the same identity, tool and detail
+    bool     matched{ false };
+  };
+
+  /// Entries sharing a key, in the order they were added. `first` skips past matched entries
+  /// as they are found, so that each entry is visited once.
+  struct Chain {
+    uint32_t first;
+    uint32_t last;
+  };
+
+  using Chains = std::unordered_map<uint64_t, Chain, IdentityHash>;
+
+  auto insert(uint64_t id, uint64_t properties, std::string_view driver) -> void;
+  auto take(Chains& chains, uint64_t key, uint32_t Entry::* next) -> uint32_t;
+
+  fs::path                   _file;     ///< Where the results were read from, if not added
+  std::vector<sarif::Result> _results;  ///< Results passed to `add()`
+  std::vector<Entry>         _entries;
+  Chains                     _index;  ///< Identity and tool -> entries
+  Chains                     _exact;  ///< Identity, tool and detail -> entries
+  std::vector<std::string>   _drivers;
+  std::string                _guid;
+};
+
+/* Functions
+ ******************************************************************************/
+/** @returns the SARIF spelling of `state`, e.g. "new". */
+auto to_string(sarif::BaselineState state) noexcept -> std::string_view;
+
+/** Copies the log `file` to `out` with each result classified against `baseline`, and each
+ * baseline result no longer reported appended as "absent" to the last run of its tool.
+ *
+ * The log is streamed one result at a time. Results of a log with several runs only match
+ * baseline results of the same tool; those of a single run match any. With `compact`, each run
+ * is written as `compact()` would.
+ *
+ * @returns the number of new results.
+ */
+auto write_diff(const fs::path& file, Baseline& baseline, std::ostream& out, bool compact = false) -> Result<size_t>;
+
+}  // namespace sharif
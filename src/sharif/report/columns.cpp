@@ -0,0 +1,191 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/report/columns.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+namespace {
+/// A region to convert, with the file it refers to.
+struct Pending {
+  std::string_view uri;
+  sarif::Region*   region;
+};
+
+/// Counts of the UTF-8 bytes that do not map to one code point or one UTF-16 unit each.
+struct Utf8Counts {
+  size_t continuations{ 0 };  ///< 10xxxxxx bytes, which add no code point
+  size_t four_byte_leads{ 0 };  ///< 11110xxx bytes, whose code point needs a surrogate pair
+};
+}  // namespace
+
+/* Functions
+ ******************************************************************************/
+namespace {
+auto count_utf8(std::string_view text) noexcept -> Utf8Counts
+{
+  constexpr uint64_t HIGH = 0x8080'8080'8080'8080;
+
+  Utf8Counts counts;
+  size_t     pos = 0;
+  for (; pos + sizeof(uint64_t) <= text.size(); pos += sizeof(uint64_t))
+  {
+    uint64_t word = 0;
+    std::memcpy(&word, text.data() + pos, sizeof(word));
+    if ((word & HIGH) == 0)
+    {
+      continue;
+    }
+
+    // Shifting a byte left moves its lower bits under its own high bit; bits that cross into
+    // the next byte land below that byte's high bit and are masked off
+    counts.continuations += static_cast<size_t>(std::popcount(word & ~(word << 1U) & HIGH));
+    counts.four_byte_leads += static_cast<size_t>(std::popcount(word & (word << 1U) & (word << 2U) & (word << 3U) & HIGH));
+  }
+  for (; pos < text.size(); ++pos)
+  {
+    const auto byte = static_cast<uint8_t>(text[pos]);
+    counts.continuations += static_cast<size_t>((byte & 0xC0U) == 0x80U);
+    counts.four_byte_leads += static_cast<size_t>(byte >= 0xF0U);
+  }
+  return counts;
+}
+
+template <typename Fn>
+auto for_each_region(sarif::Result& result, Fn&& fn) -> void
+{
+  auto visit = [&](sarif::optional_t<std::vector<sarif::Location>>& locations) {
+    if (!locations)
+    {
+      return;
+    }
+    for (auto& location : *locations)
+    {
+      auto& physical = location.physicalLocation;
+      if (physical && physical->artifactLocation && physical->artifactLocation->uri && physical->region)
+      {
+        fn(std::string_view{ *physical->artifactLocation->uri }, *physical->region);
+      }
+    }
+  };
+  visit(result.locations);
+  visit(result.relatedLocations);
+}
+}  // namespace
+
+ColumnConverter::ColumnConverter(SourceCache& sources, std::string root)
+  : _sources{ &sources }
+  , _root{ std::move(root) }
+{
+}
+
+auto ColumnConverter::apply(sarif::Run& run, sarif::ColumnKind kind) -> void
+{
+  if (run.columnKind)
+  {
+    return;
+  }
+  run.columnKind = std::string{ to_string(kind) };
+  if (!run.results)
+  {
+    return;
+  }
+
+  std::vector<Pending> pending;
+  for (auto& result : *run.results)
+  {
+    for_each_region(result, [&](std::string_view uri, sarif::Region& region) {
+      if (region.startLine && (region.startColumn || region.endColumn))
+      {
+        pending.push_back({ .uri = uri, .region = &region });
+      }
+    });
+  }
+  std::ranges::sort(pending, {}, [](const Pending& item) { return std::tuple{ item.uri, *item.region->startLine }; });
+
+  fs::path file;
+  for (size_t i = 0; i < pending.size(); ++i)
+  {
+    if (i == 0 || pending[i].uri != pending[i - 1].uri)
+    {
+      file = fs::path{ sarif::from_uri(pending[i].uri) };
+      if (file.is_relative() && !_root.empty())
+      {
+        file = _root / file;
+      }
+    }
+
+    auto&      region = *pending[i].region;
+    const auto start  = _sources->line(file, *region.startLine).value_or(std::string_view{});
+    if (region.startColumn)
+    {
+      region.startColumn = convert(start, *region.startColumn, kind);
+    }
+    if (region.endColumn)
+    {
+      const auto end_line = region.endLine.value_or(*region.startLine);
+      const auto end      = (end_line == *region.startLine) ? (start) : (_sources->line(file, end_line).value_or(std::string_view{}));
+      region.endColumn    = convert(end, *region.endColumn, kind);
+    }
+  }
+}
+
+auto ColumnConverter::convert(std::string_view line, uint32_t byte_column, sarif::ColumnKind kind) noexcept -> uint32_t
+{
+  if (byte_column <= 1)
+  {
+    return byte_column;
+  }
+
+  const size_t skip   = byte_column - 1;
+  const auto   prefix = line.substr(0, skip);
+  const auto   counts = count_utf8(prefix);
+  auto         units  = prefix.size() - counts.continuations;
+  if (kind == sarif::ColumnKind::utf16CodeUnits)
+  {
+    units += counts.four_byte_leads;
+  }
+  return static_cast<uint32_t>(units + (skip - prefix.size()) + 1);
+}
+
+auto count_code_points(std::string_view text) noexcept -> size_t
+{
+  return text.size() - count_utf8(text).continuations;
+}
+
+auto count_utf16_units(std::string_view text) noexcept -> size_t
+{
+  const auto counts = count_utf8(text);
+  return text.size() - counts.continuations + counts.four_byte_leads;
+}
+
+auto to_string(sarif::ColumnKind kind) noexcept -> std::string_view
+{
+  switch (kind)
+  {
+    case sarif::ColumnKind::utf16CodeUnits:
+      return "utf16CodeUnits";
+    case sarif::ColumnKind::unicodeCodePoints:
+      return "unicodeCodePoints";
+  }
+  return "";
+}
+
+}  // namespace sharif
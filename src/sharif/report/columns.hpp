@@ -0,0 +1,60 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// 3rd
+
+// local
+#include <sharif/parse/sarif.hpp>
+#include <sharif/util/source_cache.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Rewrites the byte columns that GCC, clang-tidy and cppcheck report into the unit named by a
+ * run's `columnKind`, using the source lines in a `SourceCache`.
+ *
+ * Regions are grouped by file and line before converting, so each file is mapped once and each
+ * line's prefix is measured without decoding it character by character.
+ */
+class ColumnConverter {
+public:
+  /** @param root Directory relative artifact URIs are resolved against. */
+  explicit ColumnConverter(SourceCache& sources, std::string root = {});
+
+  /** Converts the columns of every result's locations and related locations to `kind` and sets
+   * `run.columnKind`. Runs that already declare a `columnKind` are left as they are.
+   */
+  auto apply(sarif::Run& run, sarif::ColumnKind kind) -> void;
+
+  /** @returns the 1-based `kind` column of 1-based `byte_column` within `line`. Columns past the
+   * end of the line count one unit per byte.
+   */
+  static auto convert(std::string_view line, uint32_t byte_column, sarif::ColumnKind kind) noexcept -> uint32_t;
+
+private:
+  SourceCache* _sources;
+  fs::path     _root;
+};
+
+/* Functions
+ ******************************************************************************/
+/** @returns the number of code points in UTF-8 `text`. */
+auto count_code_points(std::string_view text) noexcept -> size_t;
+
+/** @returns the number of UTF-16 code units needed for UTF-8 `text`. */
+auto count_utf16_units(std::string_view text) noexcept -> size_t;
+
+auto to_string(sarif::ColumnKind kind) noexcept -> std::string_view;
+
+}  // namespace sharif
@@ -0,0 +1,140 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+// 3rd
+
+// local
+#include <sharif/report/dedup.hpp>
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+namespace {
+/** Writes `path` to `out` using '/' as the only separator. */
+auto normalize_path(std::string_view path, std::string& out) -> std::string_view
+{
+  out.assign(path);
+  std::ranges::replace(out, '\\', '/');
+  return out;
+}
+
+/** Writes `message` to `out` with leading/trailing whitespace removed and inner runs of
+ * whitespace collapsed to a single space.
+ */
+auto normalize_message(std::string_view message, std::string& out) -> std::string_view
+{
+  out.clear();
+  bool space = false;
+  for (const char chr : message)
+  {
+    if (chr == ' ' || chr == '\t' || chr == '\r' || chr == '\n')
+    {
+      space = !out.empty();
+      continue;
+    }
+    if (space)
+    {
+      out += ' ';
+      space = false;
+    }
+    out += chr;
+  }
+  return out;
+}
+}  // namespace
+
+auto Deduplicator::key(const Diagnostic& diagnostic) -> uint64_t
+{
+  thread_local std::string scratch;
+
+  Hasher hasher;
+  hasher.add(normalize_path(diagnostic.file, scratch));
+  hasher.add((uint64_t{ diagnostic.line } << 32U) | diagnostic.column);
+  hasher.add(diagnostic.category);
+  hasher.add(normalize_message(diagnostic.message, scratch));
+  return hasher.value();
+}
+
+auto Deduplicator::add(Diagnostic diagnostic) -> bool
+{
+  const auto hash = key(diagnostic);
+  return insert(hash, std::move(diagnostic), 1);
+}
+
+auto Deduplicator::add_all(std::vector<Diagnostic> diagnostics) -> void
+{
+  for (auto& diagnostic : diagnostics)
+  {
+    add(std::move(diagnostic));
+  }
+}
+
+auto Deduplicator::merge(Deduplicator&& other) -> void
+{
+  if (_diagnostics.empty())
+  {
+    *this = std::move(other);
+    return;
+  }
+
+  _index.reserve(_index.size() + other._index.size());
+  for (size_t i = 0; i < other._diagnostics.size(); ++i)
+  {
+    insert(other._keys[i], std::move(other._diagnostics[i]), other._occurrences[i]);
+  }
+  other = Deduplicator{};
+}
+
+auto Deduplicator::diagnostics() const noexcept -> const std::vector<Diagnostic>&
+{
+  return _diagnostics;
+}
+
+auto Deduplicator::occurrences() const noexcept -> const std::vector<uint32_t>&
+{
+  return _occurrences;
+}
+
+auto Deduplicator::size() const noexcept -> size_t
+{
+  return _diagnostics.size();
+}
+
+auto Deduplicator::to_results() const -> std::vector<sarif::Result>
+{
+  std::vector<sarif::Result> results;
+  results.reserve(_diagnostics.size());
+  for (size_t i = 0; i < _diagnostics.size(); ++i)
+  {
+    auto& result           = results.emplace_back(sarif::to_result(_diagnostics[i]));
+    result.occurrenceCount = _occurrences[i];
+  }
+  return results;
+}
+
+auto Deduplicator::insert(uint64_t hash, Diagnostic&& diagnostic, uint32_t count) -> bool
+{
+  auto [it, inserted] = _index.try_emplace(hash, _diagnostics.size());
+  if (!inserted)
+  {
+    _occurrences[it->second] += count;
+    return false;
+  }
+
+  _diagnostics.push_back(std::move(diagnostic));
+  _occurrences.push_back(count);
+  _keys.push_back(hash);
+  return true;
+}
+
+}  // namespace sharif
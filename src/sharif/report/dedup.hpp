@@ -0,0 +1,69 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/parse/diagnostic.hpp>
+#include <sharif/parse/sarif.hpp>
+#include <sharif/util/hash.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Collapses diagnostics that are reported more than once, such as a header warning emitted
+ * by every translation unit that includes the header.
+ *
+ * Diagnostics are keyed on a 64-bit hash of (file, line, column, category, message), with path
+ * separators and whitespace runs normalized. Use one instance per thread and `merge()` them
+ * afterwards to de-duplicate in parallel.
+ */
+class Deduplicator {
+public:
+  /** @returns the key `diagnostic` is de-duplicated on. */
+  static auto key(const Diagnostic& diagnostic) -> uint64_t;
+
+  /** Records one occurrence of `diagnostic`.
+   * @returns true if this is the first occurrence.
+   */
+  auto add(Diagnostic diagnostic) -> bool;
+
+  /** Records all of `diagnostics`, e.g. the output of `Diagnostic::parse_all()`. */
+  auto add_all(std::vector<Diagnostic> diagnostics) -> void;
+
+  /** Folds the diagnostics of another shard into this one, summing occurrence counts. */
+  auto merge(Deduplicator&& other) -> void;
+
+  /** Unique diagnostics in order of first occurrence. */
+  auto diagnostics() const noexcept -> const std::vector<Diagnostic>&;
+
+  /** Number of times each of `diagnostics()` was seen. */
+  auto occurrences() const noexcept -> const std::vector<uint32_t>&;
+
+  auto size() const noexcept -> size_t;
+
+  /** Converts the unique diagnostics to results with `occurrenceCount` set. */
+  auto to_results() const -> std::vector<sarif::Result>;
+
+private:
+  auto insert(uint64_t hash, Diagnostic&& diagnostic, uint32_t count) -> bool;
+
+  std::vector<Diagnostic>                            _diagnostics;
+  std::vector<uint32_t>                              _occurrences;
+  std::vector<uint64_t>                              _keys;
+  std::unordered_map<uint64_t, size_t, IdentityHash> _index;
+};
+
+}  // namespace sharif
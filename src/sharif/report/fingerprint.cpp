@@ -0,0 +1,216 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+
+// 3rd
+
+// local
+#include <sharif/parse/parser.hpp>
+#include <sharif/report/fingerprint.hpp>
+#include <sharif/util/fmt.hpp>
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+namespace {
+constexpr auto is_space(char chr) noexcept -> bool
+{
+  return chr == ' ' || chr == '\t' || chr == '\r' || chr == '\n';
+}
+
+/** Hashes `text` as if leading/trailing whitespace were removed and inner runs collapsed. */
+auto hash_normalized(std::string_view text) -> uint64_t
+{
+  thread_local std::string scratch;
+  scratch.clear();
+
+  bool space = false;
+  for (const char chr : text)
+  {
+    if (is_space(chr))
+    {
+      space = !scratch.empty();
+      continue;
+    }
+    if (space)
+    {
+      scratch += ' ';
+      space = false;
+    }
+    scratch += chr;
+  }
+  return hash_bytes(scratch);
+}
+
+auto set_fingerprint(sarif::Result& result, std::string_view key, std::string value) -> void
+{
+  if (!result.partialFingerprints)
+  {
+    result.partialFingerprints = sarif::map_t<std::string, std::string>{};
+  }
+  result.partialFingerprints->insert_or_assign(std::string{ key }, std::move(value));
+}
+}  // namespace
+
+Fingerprinter::Fingerprinter(SourceCache& sources, std::string root)
+  : _sources{ &sources }
+  , _root{ std::move(root) }
+{
+  std::ranges::replace(_root, '\\', '/');
+  if (!_root.empty() && !_root.ends_with('/'))
+  {
+    _root += '/';
+  }
+}
+
+auto Fingerprinter::apply(std::vector<sarif::Result>& results) -> void
+{
+  for (auto& result : results)
+  {
+    apply(result);
+  }
+}
+
+auto Fingerprinter::message_template(std::string_view message) -> std::string
+{
+  std::string text;
+  text.reserve(message.size());
+
+  for (size_t i = 0; i < message.size(); ++i)
+  {
+    const char chr = message[i];
+    if (is_decimal(chr))
+    {
+      text += '0';
+      while (i + 1 < message.size() && is_decimal(message[i + 1]))
+      {
+        ++i;
+      }
+      continue;
+    }
+
+    // Quoted names: 'x', "x", `x' and GCC's ‘x’ (U+2018/U+2019, E2 80 98/99 in UTF-8)
+    std::string_view close;
+    size_t           open_len = 1;
+    if (chr == '\'' || chr == '"')
+    {
+      close = message.substr(i, 1);
+    }
+    else if (chr == '`')
+    {
+      close = "'";
+    }
+    else if (message.substr(i).starts_with("‘"))
+    {
+      close    = "’";
+      open_len = close.size();
+    }
+
+    if (!close.empty())
+    {
+      if (auto end = message.find(close, i + open_len); end != std::string_view::npos)
+      {
+        text += "'{}'";
+        i = end + close.size() - 1;
+        continue;
+      }
+    }
+
+    text += chr;
+  }
+  return text;
+}
+
+auto Fingerprinter::apply(sarif::Result& result) -> void
+{
+  uint64_t line    = hash_normalized({});
+  uint32_t ordinal = 1;
+  if (const auto source = source_file(result); source)
+  {
+    const auto& [hashes, ordinals] = lines(source->first);
+    if (source->second <= hashes.size())
+    {
+      line    = hashes[source->second - 1];
+      ordinal = ordinals[source->second - 1];
+    }
+  }
+
+  const auto path = relative_path(result);
+  const auto text = (result.message.text) ? (std::string_view{ *result.message.text }) : (std::string_view{});
+  const auto rule = (result.ruleId) ? (std::string_view{ *result.ruleId }) : (std::string_view{});
+
+  const auto fingerprint = Hasher{}.add(rule).add(path).add(line).add(message_template(text)).value();
+  set_fingerprint(result, FINGERPRINT_KEY, fmt::format("{:016x}", fingerprint));
+  set_fingerprint(result, LINE_HASH_KEY, fmt::format("{:016x}:{}", line, ordinal));
+}
+
+auto Fingerprinter::lines(const fs::path& file) -> const Lines&
+{
+  const auto key = file.string();
+  if (auto it = _lines.find(key); it != _lines.end())
+  {
+    return it->second;
+  }
+
+  // Identical lines within a file are told apart by the order they appear in
+  Lines                                                lines;
+  std::unordered_map<uint64_t, uint32_t, IdentityHash> seen;
+  const auto                                           count = _sources->line_count(file);
+  lines.hashes.reserve(count);
+  lines.ordinals.reserve(count);
+  for (uint32_t n = 1; n <= count; ++n)
+  {
+    const auto hash = hash_normalized(_sources->line(file, n).value_or(std::string_view{}));
+    lines.hashes.push_back(hash);
+    lines.ordinals.push_back(++seen[hash]);
+  }
+  return _lines.emplace(key, std::move(lines)).first->second;
+}
+
+auto Fingerprinter::source_file(const sarif::Result& result) const -> std::optional<std::pair<fs::path, uint32_t>>
+{
+  const auto* location = sarif::primary_location(result);
+  if (location == nullptr || !location->artifactLocation || !location->artifactLocation->uri || !location->region || !location->region->startLine || *location->region->startLine == 0)
+  {
+    return std::nullopt;
+  }
+
+  auto file = fs::path{ sarif::from_uri(*location->artifactLocation->uri) };
+  if (file.is_relative() && !_root.empty())
+  {
+    file = fs::path{ _root } / file;
+  }
+  return std::pair{ std::move(file), *location->region->startLine };
+}
+
+auto Fingerprinter::relative_path(const sarif::Result& result) -> std::string
+{
+  const auto* location = sarif::primary_location(result);
+  if (location == nullptr || !location->artifactLocation || !location->artifactLocation->uri)
+  {
+    return {};
+  }
+
+  auto path = sarif::from_uri(*location->artifactLocation->uri);
+  std::ranges::replace(path, '\\', '/');
+  if (!_root.empty() && path.starts_with(_root))
+  {
+    path.erase(0, _root.size());
+  }
+  while (path.starts_with("./"))
+  {
+    path.erase(0, 2);
+  }
+  return path;
+}
+
+}  // namespace sharif
@@ -0,0 +1,79 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/parse/sarif.hpp>
+#include <sharif/util/hash.hpp>
+#include <sharif/util/source_cache.hpp>
+
+// namespace
+namespace sharif {
+
+/* Constants
+ ******************************************************************************/
+/// `partialFingerprints` key for the hash of the result's identity (rule, file, line text, message).
+inline constexpr std::string_view FINGERPRINT_KEY = "sharif/v1";
+
+/// `partialFingerprints` key for the hash of the primary location's source line, as used by GitHub.
+inline constexpr std::string_view LINE_HASH_KEY = "primaryLocationLineHash";
+
+/* Types
+ ******************************************************************************/
+/** Computes `partialFingerprints` that stay stable while unrelated code moves around.
+ *
+ * The fingerprint hashes the rule id, the file path relative to `root`, the whitespace-normalized
+ * text of the primary location's line and the message with quoted names and numbers replaced by
+ * placeholders. Line numbers are deliberately left out, so inserting code above a result does not
+ * change its fingerprint.
+ *
+ * `primaryLocationLineHash` follows GitHub's `hash:ordinal` scheme, where the ordinal counts the
+ * lines of the file up to and including this one whose text hashes the same. Unlike GitHub, which
+ * hashes a window of the next 100 non-whitespace characters, only the line itself is hashed.
+ */
+class Fingerprinter {
+public:
+  /** @param root Prefix stripped from file paths so fingerprints match across checkouts. */
+  explicit Fingerprinter(SourceCache& sources, std::string root = {});
+
+  /** Fingerprints a single result. */
+  auto apply(sarif::Result& result) -> void;
+
+  /** Fingerprints a run's results. */
+  auto apply(std::vector<sarif::Result>& results) -> void;
+
+  /** @returns `message` with quoted text replaced by `'{}'` and digit runs replaced by `0`. */
+  static auto message_template(std::string_view message) -> std::string;
+
+private:
+  /// Hash and ordinal of each line of a file, both 0-based by line.
+  struct Lines {
+    std::vector<uint64_t> hashes;
+    std::vector<uint32_t> ordinals;
+  };
+
+  auto lines(const fs::path& file) -> const Lines&;
+  auto source_file(const sarif::Result& result) const -> std::optional<std::pair<fs::path, uint32_t>>;
+  auto relative_path(const sarif::Result& result) -> std::string;
+
+  SourceCache*                                                        _sources;
+  std::string                                                         _root;
+  std::unordered_map<std::string, Lines, StringHash, std::equal_to<>> _lines;  ///< Keyed by path
+};
+
+}  // namespace sharif
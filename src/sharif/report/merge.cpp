@@ -0,0 +1,229 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <optional>
+#include <utility>
+
+// 3rd
+
+// local
+#include <sharif/parse/sarif_reader.hpp>
+#include <sharif/report/merge.hpp>
+#include <sharif/util/log.hpp>
+#include <sharif/util/parallel.hpp>
+#include <sharif/util/ranges.hpp>
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+namespace {
+/** Reads every run of a log, including runs without results. */
+auto read_runs(const fs::path& file) -> std::optional<std::vector<sarif::Run>>
+{
+  auto reader = SarifReader::open(file);
+  if (!reader)
+  {
+    log::error("Failed to open '{}'", file.string());
+    return std::nullopt;
+  }
+
+  std::vector<sarif::Run> runs;
+  sarif::Result           result;
+  while (true)
+  {
+    auto more = reader->next_run();
+    if (more && !*more)
+    {
+      break;
+    }
+
+    if (more)
+    {
+      auto& run   = runs.emplace_back(reader->run());
+      run.results = std::vector<sarif::Result>{};
+      while ((more = reader->next_result(result)) && *more)
+      {
+        run.results->push_back(std::move(result));
+      }
+    }
+    if (!more)
+    {
+      log::error("Failed to read '{}'", file.string());
+      return std::nullopt;
+    }
+  }
+  return runs;
+}
+
+/** @returns whether the results of `run` mean the same as they would in `group`: columns count
+ * the same units, and base ids defined by both resolve to the same location.
+ */
+auto compatible(const sarif::Run& group, const sarif::Run& run) -> bool
+{
+  if (group.columnKind != run.columnKind)
+  {
+    return false;
+  }
+  if (!group.originalUriBaseIds || !run.originalUriBaseIds)
+  {
+    return true;
+  }
+  return range::all_of(*run.originalUriBaseIds, [&](const auto& entry) {
+    const auto& [id, location] = entry;
+    const auto it              = group.originalUriBaseIds->find(id);
+    return it == group.originalUriBaseIds->end() || (it->second.uri == location.uri && it->second.uriBaseId == location.uriBaseId);
+  });
+}
+
+/** Adds the base ids and invocations of `run` to `group`, pointing `results` at the invocations. */
+auto merge_context(sarif::Run& group, sarif::Run& run, std::vector<sarif::Result>& results) -> void
+{
+  if (run.originalUriBaseIds)
+  {
+    if (!group.originalUriBaseIds)
+    {
+      group.originalUriBaseIds.emplace();
+    }
+    for (auto&& [id, location] : *run.originalUriBaseIds)
+    {
+      group.originalUriBaseIds->try_emplace(id, std::move(location));
+    }
+  }
+
+  if (run.invocations)
+  {
+    const auto offset = static_cast<int32_t>((group.invocations) ? (group.invocations->size()) : (0));
+    for (auto& result : results)
+    {
+      if (result.provenance && result.provenance->invocationIndex.value_or(-1) >= 0)
+      {
+        *result.provenance->invocationIndex += offset;
+      }
+    }
+
+    if (!group.invocations)
+    {
+      group.invocations.emplace();
+    }
+    group.invocations->append_range(view::as_rvalue(*run.invocations));
+  }
+}
+}  // namespace
+
+auto Merger::with_jobs(unsigned jobs) -> Merger&
+{
+  _jobs = std::max(jobs, 1U);
+  return *this;
+}
+
+auto Merger::with_compact(bool compact) -> Merger&
+{
+  _compact = compact;
+  return *this;
+}
+
+auto Merger::read(const std::vector<fs::path>& files) -> Result<size_t>
+{
+  std::vector<std::optional<std::vector<sarif::Run>>> inputs(files.size());
+  parallel_for(files.size(), _jobs, [&](size_t idx) {
+    inputs[idx] = read_runs(files[idx]);
+  });
+
+  if (range::any_of(inputs, [](const auto& runs) { return !runs; }))
+  {
+    return Code::bad_message;
+  }
+
+  size_t count = 0;
+  for (auto& runs : inputs)
+  {
+    for (auto& run : *runs)
+    {
+      count += run.results->size();
+      add(std::move(run));
+    }
+    runs.reset();
+  }
+  return count;
+}
+
+auto Merger::add(sarif::Run run) -> void
+{
+  auto&      candidates = _index[run.tool.driver.name];
+  const auto it         = range::find_if(candidates, [&](size_t idx) { return compatible(_groups[idx].run, run); });
+  const bool inserted   = it == candidates.end();
+  if (inserted)
+  {
+    candidates.push_back(_groups.size());
+    _groups.emplace_back();
+  }
+  auto& group = _groups[(inserted) ? (candidates.back()) : (*it)];
+
+  const auto map     = absorb_tables(run, group.tables);
+  auto       results = (run.results) ? (std::exchange(*run.results, {})) : (std::vector<sarif::Result>{});
+  run.results        = std::nullopt;
+  for (auto& result : results)
+  {
+    reindex(result, map, group.tables);
+    if (_compact)
+    {
+      strip_indexed_uris(result);
+    }
+  }
+
+  if (inserted)
+  {
+    group.run = std::move(run);
+  }
+  else
+  {
+    merge_context(group.run, run, results);
+  }
+  if (group.results.empty())
+  {
+    group.results = std::move(results);
+  }
+  else
+  {
+    group.results.append_range(view::as_rvalue(results));
+  }
+}
+
+auto Merger::write(std::ostream& out) -> bool
+{
+  std::string buffer;
+  out << R"({"version":"2.1.0","runs":[)";
+  for (size_t idx = 0; idx < _groups.size(); ++idx)
+  {
+    auto& group = _groups[idx];
+    emplace_tables(group.run, group.tables);
+    group.run.results = std::move(group.results);
+    group.results     = {};
+
+    out << ((idx > 0) ? (",") : (""));
+    if (!sarif::write(group.run, buffer, out))
+    {
+      log::error("Failed to serialize the '{}' run", group.run.tool.driver.name);
+      return false;
+    }
+  }
+  out << "]}\n";
+
+  _groups.clear();
+  _index.clear();
+  return static_cast<bool>(out);
+}
+
+auto Merger::runs() const noexcept -> size_t
+{
+  return _groups.size();
+}
+
+}  // namespace sharif
@@ -0,0 +1,78 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <functional>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/parse/sarif.hpp>
+#include <sharif/report/tables.hpp>
+#include <sharif/util/filesystem.hpp>
+#include <sharif/util/hash.hpp>
+#include <sharif/util/result.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Combines SARIF logs into one with a single run per tool (`tool.driver.name`).
+ *
+ * The rules and artifacts of the merged runs are unified into shared tables: each rule id and
+ * artifact URI is stored once, and results are remapped to reference them through `ruleIndex`
+ * and `ArtifactLocation.index`.
+ *
+ * Runs of a tool share a run only when their results read the same in it: the same
+ * `columnKind`, and no base id of `originalUriBaseIds` that they define differently. Such runs
+ * contribute their base ids and invocations, and `provenance.invocationIndex` is remapped;
+ * other runs of the tool are kept apart. The remaining run properties are those of the first
+ * run of each group.
+ */
+class Merger {
+public:
+  auto with_jobs(unsigned jobs) -> Merger&;
+
+  /** Drops the URIs of artifact locations from results, leaving only their index. */
+  auto with_compact(bool compact) -> Merger&;
+
+  /** Reads `files` concurrently, then merges their runs in the order given.
+   *
+   * Every result is held in memory until `write()`, since the results of a tool across all files
+   * end up in one run; the inputs are released as their runs are merged.
+   *
+   * @returns the number of results read.
+   */
+  auto read(const std::vector<fs::path>& files) -> Result<size_t>;
+
+  /** Merges `run` into a compatible run of the same tool, or starts a new one. */
+  auto add(sarif::Run run) -> void;
+
+  /** Writes the merged log one result at a time, releasing results as they are written. */
+  auto write(std::ostream& out) -> bool;
+
+  auto runs() const noexcept -> size_t;
+
+private:
+  struct Group {
+    sarif::Run                 run;
+    RunTables                  tables;
+    std::vector<sarif::Result> results;
+  };
+
+  std::vector<Group>                                                                _groups;
+  std::unordered_map<std::string, std::vector<size_t>, StringHash, std::equal_to<>> _index;  ///< Driver name -> groups
+  unsigned                                                                          _jobs{ 1 };
+  bool                                                                              _compact{ false };
+};
+
+}  // namespace sharif
@@ -0,0 +1,510 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+
+// 3rd
+
+// local
+#include <sharif/report/result_store.hpp>
+#include <sharif/util/log.hpp>
+#include <sharif/util/ranges.hpp>
+
+// namespace
+namespace sharif {
+
+/* Constants
+ ******************************************************************************/
+namespace {
+constexpr std::array<char, 8> MAGIC{ 'S', 'H', 'A', 'R', 'I', 'F', 'R', 'S' };
+constexpr uint32_t            VERSION     = 1;
+constexpr uint32_t            ENDIAN_MARK = 0x01020304;  ///< Reads back differently on a host of the other byte order
+constexpr size_t              ALIGNMENT   = 8;
+}  // namespace
+
+/* Types
+ ******************************************************************************/
+namespace {
+struct Header {
+  std::array<char, 8> magic;
+  uint32_t            version;
+  uint32_t            byte_order;
+  uint32_t            rows;
+  uint32_t            strings;
+  uint32_t            file_entries;
+  uint32_t            file_rows;
+  uint32_t            rule_entries;
+  uint32_t            rule_rows;
+  uint32_t            driver_bytes;
+  uint32_t            reserved;
+  uint64_t            string_bytes;
+};
+static_assert(std::is_trivially_copyable_v<Header> && sizeof(Header) % ALIGNMENT == 0);
+static_assert(std::is_trivially_copyable_v<ResultStore::Entry> && sizeof(ResultStore::Entry) == 12);
+static_assert(sizeof(sarif::Level) == 1);
+
+/// Byte offset of each section, derived from the counts in the header.
+struct Layout {
+  size_t string_offsets;
+  size_t fingerprints;
+  size_t rules;
+  size_t files;
+  size_t lines;
+  size_t columns;
+  size_t messages;
+  size_t file_index;
+  size_t file_rows;
+  size_t rule_index;
+  size_t rule_rows;
+  size_t levels;
+  size_t string_data;
+  size_t driver;
+  size_t size;
+};
+
+struct Index {
+  std::vector<ResultStore::Entry> entries;
+  std::vector<uint32_t>           rows;
+};
+}  // namespace
+
+/* Functions
+ ******************************************************************************/
+namespace {
+auto layout(const Header& header) noexcept -> Layout
+{
+  size_t pos     = sizeof(Header);
+  auto   section = [&](size_t bytes) {
+    pos           = (pos + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    const auto at = pos;
+    pos += bytes;
+    return at;
+  };
+
+  const size_t rows = header.rows;
+  Layout       at{};
+  at.string_offsets = section((size_t{ header.strings } + 1) * sizeof(uint64_t));
+  at.fingerprints   = section(rows * sizeof(uint64_t));
+  at.rules          = section(rows * sizeof(uint32_t));
+  at.files          = section(rows * sizeof(uint32_t));
+  at.lines          = section(rows * sizeof(uint32_t));
+  at.columns        = section(rows * sizeof(uint32_t));
+  at.messages       = section(rows * sizeof(uint32_t));
+  at.file_index     = section(header.file_entries * sizeof(ResultStore::Entry));
+  at.file_rows      = section(header.file_rows * sizeof(uint32_t));
+  at.rule_index     = section(header.rule_entries * sizeof(ResultStore::Entry));
+  at.rule_rows      = section(header.rule_rows * sizeof(uint32_t));
+  at.levels         = section(rows * sizeof(sarif::Level));
+  at.string_data    = section(header.string_bytes);
+  at.driver         = section(header.driver_bytes);
+  at.size           = pos;
+  return at;
+}
+
+/** Groups the rows of `column` by string id, in id order. */
+auto build_index(std::span<const uint32_t> column, size_t strings) -> Index
+{
+  std::vector<uint32_t> counts(strings, 0);
+  for (const auto id : column)
+  {
+    if (id != ResultStore::NONE)
+    {
+      ++counts[id];
+    }
+  }
+
+  Index                 index;
+  std::vector<uint32_t> next(strings, 0);
+  uint32_t              first = 0;
+  for (uint32_t id = 0; id < strings; ++id)
+  {
+    if (counts[id] != 0)
+    {
+      index.entries.push_back({ .id = id, .first = first, .count = counts[id] });
+      next[id] = first;
+      first += counts[id];
+    }
+  }
+
+  index.rows.resize(first);
+  for (uint32_t row = 0; row < column.size(); ++row)
+  {
+    if (column[row] != ResultStore::NONE)
+    {
+      index.rows[next[column[row]]++] = row;
+    }
+  }
+  return index;
+}
+
+template <typename T>
+auto section(std::string_view bytes, size_t offset, size_t count) noexcept -> std::span<const T>
+{
+  return { reinterpret_cast<const T*>(bytes.data() + offset), count };  // NOLINT(*-reinterpret-cast)
+}
+
+/** @returns whether every entry refers to a valid string and a slice of `rows`, in id order. */
+auto is_valid_index(std::span<const ResultStore::Entry> index, std::span<const uint32_t> rows, size_t strings, size_t row_count) noexcept
+  -> bool
+{
+  uint64_t previous = 0;
+  for (const auto& entry : index)
+  {
+    if (entry.id >= strings || (&entry != index.data() && entry.id <= previous)
+        || uint64_t{ entry.first } + entry.count > rows.size())
+    {
+      return false;
+    }
+    previous = entry.id;
+  }
+  return range::all_of(rows, [&](uint32_t row) { return row < row_count; });
+}
+}  // namespace
+
+auto ResultStore::encode(const ResultTable& table, std::string_view driver) -> std::string
+{
+  // Sorting the string table lets `find()` binary search it without building a hash map
+  const auto&           pool = table.strings();
+  std::vector<uint32_t> order(pool.size());
+  std::iota(order.begin(), order.end(), 0U);
+  range::sort(order, {}, [&](uint32_t id) { return pool[id]; });
+
+  std::vector<uint32_t> rank(order.size());
+  for (uint32_t pos = 0; pos < order.size(); ++pos)
+  {
+    rank[order[pos]] = pos;
+  }
+  auto remap = [&](std::span<const uint32_t> column) {
+    std::vector<uint32_t> ids;
+    ids.reserve(column.size());
+    for (const auto id : column)
+    {
+      ids.push_back((id != NONE) ? (rank[id]) : (NONE));
+    }
+    return ids;
+  };
+  const auto rules    = remap(table.rules());
+  const auto files    = remap(table.files());
+  const auto messages = remap(table.messages());
+  const auto by_file  = build_index(files, order.size());
+  const auto by_rule  = build_index(rules, order.size());
+
+  std::vector<uint64_t> offsets;
+  offsets.reserve(order.size() + 1);
+  uint64_t string_bytes = 0;
+  for (const auto id : order)
+  {
+    offsets.push_back(string_bytes);
+    string_bytes += pool[id].size();
+  }
+  offsets.push_back(string_bytes);
+
+  const auto header = Header{
+    .magic        = MAGIC,
+    .version      = VERSION,
+    .byte_order   = ENDIAN_MARK,
+    .rows         = static_cast<uint32_t>(table.size()),
+    .strings      = static_cast<uint32_t>(order.size()),
+    .file_entries = static_cast<uint32_t>(by_file.entries.size()),
+    .file_rows    = static_cast<uint32_t>(by_file.rows.size()),
+    .rule_entries = static_cast<uint32_t>(by_rule.entries.size()),
+    .rule_rows    = static_cast<uint32_t>(by_rule.rows.size()),
+    .driver_bytes = static_cast<uint32_t>(driver.size()),
+    .reserved     = 0,
+    .string_bytes = string_bytes,
+  };
+  const auto at = layout(header);
+
+  std::string bytes(at.size, '\0');
+  auto        put = [&]<typename T>(size_t offset, std::span<const T> data) {
+    if (!data.empty())
+    {
+      std::memcpy(bytes.data() + offset, data.data(), data.size_bytes());
+    }
+  };
+  std::memcpy(bytes.data(), &header, sizeof(header));
+  put(at.string_offsets, std::span<const uint64_t>{ offsets });
+  put(at.fingerprints, table.fingerprints());
+  put(at.rules, std::span<const uint32_t>{ rules });
+  put(at.files, std::span<const uint32_t>{ files });
+  put(at.lines, table.lines());
+  put(at.columns, table.columns());
+  put(at.messages, std::span<const uint32_t>{ messages });
+  put(at.file_index, std::span<const Entry>{ by_file.entries });
+  put(at.file_rows, std::span<const uint32_t>{ by_file.rows });
+  put(at.rule_index, std::span<const Entry>{ by_rule.entries });
+  put(at.rule_rows, std::span<const uint32_t>{ by_rule.rows });
+  put(at.levels, table.levels());
+  put(at.driver, std::span<const char>{ driver });
+  for (uint32_t pos = 0; pos < order.size(); ++pos)
+  {
+    put(at.string_data + offsets[pos], std::span<const char>{ pool[order[pos]] });
+  }
+  return bytes;
+}
+
+auto ResultStore::write(const fs::path& file, const ResultTable& table, std::string_view driver) -> bool
+{
+  const auto    bytes = encode(table, driver);
+  std::ofstream stream{ file, std::ios::binary };
+  stream.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+  if (!stream)
+  {
+    log::error("Failed to write '{}'", file.string());
+    return false;
+  }
+  return true;
+}
+
+auto ResultStore::open(const fs::path& file) -> Result<ResultStore>
+{
+  SHARIF_TRY(auto mapping, MappedFile::open(file));
+  SHARIF_TRY(auto store, from(mapping.view()));
+
+  // The spans point into the mapping's pages, which do not move with it
+  store._file = std::move(mapping);
+  return store;
+}
+
+auto ResultStore::from(std::string_view bytes) -> Result<ResultStore>
+{
+  auto fail = [](std::string_view what) -> Code {
+    log::error("Invalid result store: {}", what);
+    return Code::bad_message;
+  };
+
+  if (bytes.size() < sizeof(Header))
+  {
+    return fail("truncated header");
+  }
+  if (reinterpret_cast<uintptr_t>(bytes.data()) % ALIGNMENT != 0)  // NOLINT(*-reinterpret-cast)
+  {
+    return fail("misaligned buffer");
+  }
+
+  Header header{};
+  std::memcpy(&header, bytes.data(), sizeof(header));
+  if (header.magic != MAGIC)
+  {
+    return fail("not a result store");
+  }
+  if (header.version != VERSION || header.byte_order != ENDIAN_MARK)
+  {
+    return fail("unsupported version or byte order");
+  }
+  if (header.string_bytes > bytes.size())
+  {
+    return fail("truncated strings");
+  }
+
+  const auto at = layout(header);
+  if (at.size > bytes.size())
+  {
+    return fail("truncated sections");
+  }
+
+  ResultStore store;
+  store._string_offsets = section<uint64_t>(bytes, at.string_offsets, size_t{ header.strings } + 1);
+  store._string_data    = bytes.substr(at.string_data, header.string_bytes);
+  store._driver         = bytes.substr(at.driver, header.driver_bytes);
+  store._fingerprints   = section<uint64_t>(bytes, at.fingerprints, header.rows);
+  store._rules          = section<uint32_t>(bytes, at.rules, header.rows);
+  store._files          = section<uint32_t>(bytes, at.files, header.rows);
+  store._lines          = section<uint32_t>(bytes, at.lines, header.rows);
+  store._columns        = section<uint32_t>(bytes, at.columns, header.rows);
+  store._messages       = section<uint32_t>(bytes, at.messages, header.rows);
+  store._file_index     = section<Entry>(bytes, at.file_index, header.file_entries);
+  store._file_rows      = section<uint32_t>(bytes, at.file_rows, header.file_rows);
+  store._rule_index     = section<Entry>(bytes, at.rule_index, header.rule_entries);
+  store._rule_rows      = section<uint32_t>(bytes, at.rule_rows, header.rule_rows);
+  store._levels         = section<sarif::Level>(bytes, at.levels, header.rows);
+
+  // Columns may hold any id since `string()` checks it, but offsets and indexes are trusted
+  if (store._string_offsets.front() != 0 || store._string_offsets.back() != header.string_bytes
+      || !range::is_sorted(store._string_offsets))
+  {
+    return fail("corrupt string table");
+  }
+  if (!is_valid_index(store._file_index, store._file_rows, header.strings, header.rows)
+      || !is_valid_index(store._rule_index, store._rule_rows, header.strings, header.rows))
+  {
+    return fail("corrupt index");
+  }
+  if (range::any_of(store._levels, [](sarif::Level level) { return std::to_underlying(level) > std::to_underlying(sarif::Level::error); }))
+  {
+    return fail("corrupt level");
+  }
+  return store;
+}
+
+auto ResultStore::size() const noexcept -> size_t
+{
+  return _rules.size();
+}
+
+auto ResultStore::empty() const noexcept -> bool
+{
+  return _rules.empty();
+}
+
+auto ResultStore::driver() const noexcept -> std::string_view
+{
+  return _driver;
+}
+
+auto ResultStore::rules() const noexcept -> std::span<const uint32_t>
+{
+  return _rules;
+}
+
+auto ResultStore::levels() const noexcept -> std::span<const sarif::Level>
+{
+  return _levels;
+}
+
+auto ResultStore::files() const noexcept -> std::span<const uint32_t>
+{
+  return _files;
+}
+
+auto ResultStore::lines() const noexcept -> std::span<const uint32_t>
+{
+  return _lines;
+}
+
+auto ResultStore::columns() const noexcept -> std::span<const uint32_t>
+{
+  return _columns;
+}
+
+auto ResultStore::messages() const noexcept -> std::span<const uint32_t>
+{
+  return _messages;
+}
+
+auto ResultStore::fingerprints() const noexcept -> std::span<const uint64_t>
+{
+  return _fingerprints;
+}
+
+auto ResultStore::string(uint32_t id) const noexcept -> std::string_view
+{
+  if (id >= string_count())
+  {
+    return {};
+  }
+  return _string_data.substr(_string_offsets[id], _string_offsets[id + 1] - _string_offsets[id]);
+}
+
+auto ResultStore::string_count() const noexcept -> size_t
+{
+  return (_string_offsets.empty()) ? (0) : (_string_offsets.size() - 1);
+}
+
+auto ResultStore::find(std::string_view str) const noexcept -> uint32_t
+{
+  const auto ids = view::iota(0U, static_cast<uint32_t>(string_count()));
+  const auto it  = range::lower_bound(ids, str, {}, [this](uint32_t id) { return string(id); });
+  return (it != ids.end() && string(*it) == str) ? (*it) : (NONE);
+}
+
+auto ResultStore::file_index() const noexcept -> std::span<const Entry>
+{
+  return _file_index;
+}
+
+auto ResultStore::rule_index() const noexcept -> std::span<const Entry>
+{
+  return _rule_index;
+}
+
+auto ResultStore::rows_for_file(std::string_view uri) const noexcept -> std::span<const uint32_t>
+{
+  return rows_for(_file_index, _file_rows, uri);
+}
+
+auto ResultStore::rows_for_rule(std::string_view rule) const noexcept -> std::span<const uint32_t>
+{
+  return rows_for(_rule_index, _rule_rows, rule);
+}
+
+auto ResultStore::row(size_t row) const noexcept -> ResultRow
+{
+  return ResultRow{
+    .rule        = string(_rules[row]),
+    .level       = _levels[row],
+    .file        = string(_files[row]),
+    .line        = _lines[row],
+    .column      = _columns[row],
+    .message     = string(_messages[row]),
+    .fingerprint = _fingerprints[row],
+  };
+}
+
+auto ResultStore::to_table() const -> ResultTable
+{
+  ResultTable table;
+  for (size_t i = 0; i < size(); ++i)
+  {
+    table.add(row(i));
+  }
+  return table;
+}
+
+auto ResultStore::to_sarif() const -> Sarif
+{
+  std::vector<sarif::Result> results;
+  results.reserve(size());
+  for (size_t i = 0; i < size(); ++i)
+  {
+    results.push_back(row(i).to_result());
+  }
+
+  sarif::Run run;
+  run.tool.driver.name = std::string{ driver() };
+  run.results          = std::move(results);
+
+  Sarif sarif;
+  sarif.runs.push_back(std::move(run));
+  return sarif;
+}
+
+auto ResultStore::to_diagnostics() const -> std::vector<Diagnostic>
+{
+  std::vector<Diagnostic> diagnostics;
+  diagnostics.reserve(size());
+  for (size_t i = 0; i < size(); ++i)
+  {
+    diagnostics.push_back(row(i).to_diagnostic());
+  }
+  return diagnostics;
+}
+
+auto ResultStore::rows_for(std::span<const Entry> index, std::span<const uint32_t> rows, std::string_view str) const noexcept
+  -> std::span<const uint32_t>
+{
+  const auto id = find(str);
+  if (id == NONE)
+  {
+    return {};
+  }
+
+  const auto it = range::lower_bound(index, id, {}, &Entry::id);
+  if (it == index.end() || it->id != id)
+  {
+    return {};
+  }
+  return rows.subspan(it->first, it->count);
+}
+
+}  // namespace sharif
@@ -0,0 +1,135 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/parse/sarif.hpp>
+#include <sharif/report/result_table.hpp>
+#include <sharif/util/filesystem.hpp>
+#include <sharif/util/mapped_file.hpp>
+#include <sharif/util/result.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Read-only, memory-mapped results in sharif's binary columnar format.
+ *
+ * A store file holds the columns of a `ResultTable`, a sorted string table and, for both files and
+ * rules, the rows that refer to each of them. Opening a store only validates the header and the
+ * section bounds; columns and indexes are read straight from the mapping, so slicing a large
+ * history by file or rule does not parse anything.
+ *
+ * Layout (native byte order, each section aligned to 8 bytes):
+ * - header: magic, version, byte order mark and the section sizes
+ * - string offsets (`uint64_t[strings + 1]`) and fingerprints (`uint64_t[rows]`)
+ * - rule, file, line, column and message columns (`uint32_t[rows]`)
+ * - file index (`Entry[]`) and the rows it refers to (`uint32_t[]`), then the same for rules
+ * - level column (`uint8_t[rows]`), string bytes and the driver name
+ */
+class ResultStore {
+public:
+  /// Rows `rows[first, first + count)` of an index refer to string `id`.
+  struct Entry {
+    uint32_t id;
+    uint32_t first;
+    uint32_t count;
+  };
+
+  static constexpr uint32_t NONE = StringPool::NONE;
+
+  /** @returns `table` in the store format, with strings sorted so readers can binary search them. */
+  static auto encode(const ResultTable& table, std::string_view driver = {}) -> std::string;
+
+  /** Writes `table` to `file` in the store format. */
+  static auto write(const fs::path& file, const ResultTable& table, std::string_view driver = {}) -> bool;
+
+  /** Maps `file` and validates its layout. */
+  static auto open(const fs::path& file) -> Result<ResultStore>;
+
+  /** Validates a store held in memory, including every level. `bytes` must outlive the store and
+   * be 8-byte aligned.
+   */
+  static auto from(std::string_view bytes) -> Result<ResultStore>;
+
+  auto size() const noexcept -> size_t;
+  auto empty() const noexcept -> bool;
+
+  /** @returns the name of the tool the results came from, if it was recorded. */
+  auto driver() const noexcept -> std::string_view;
+
+  auto rules() const noexcept -> std::span<const uint32_t>;
+  auto levels() const noexcept -> std::span<const sarif::Level>;
+  auto files() const noexcept -> std::span<const uint32_t>;
+  auto lines() const noexcept -> std::span<const uint32_t>;
+  auto columns() const noexcept -> std::span<const uint32_t>;
+  auto messages() const noexcept -> std::span<const uint32_t>;
+  auto fingerprints() const noexcept -> std::span<const uint64_t>;
+
+  /** @returns string `id`, or an empty string for `NONE` or an id out of range. */
+  auto string(uint32_t id) const noexcept -> std::string_view;
+  auto string_count() const noexcept -> size_t;
+
+  /** @returns the id of `str`, or `NONE`. */
+  auto find(std::string_view str) const noexcept -> uint32_t;
+
+  /** Distinct files and rules, ordered by string id, with the number of rows for each. */
+  auto file_index() const noexcept -> std::span<const Entry>;
+  auto rule_index() const noexcept -> std::span<const Entry>;
+
+  /** @returns the rows whose primary location is in `uri`, in ascending order. */
+  auto rows_for_file(std::string_view uri) const noexcept -> std::span<const uint32_t>;
+
+  /** @returns the rows reported by `rule`, in ascending order. */
+  auto rows_for_rule(std::string_view rule) const noexcept -> std::span<const uint32_t>;
+
+  auto row(size_t row) const noexcept -> ResultRow;
+
+  auto to_table() const -> ResultTable;
+
+  /** @returns a log with a single run of `driver()` holding a result per row.
+   *
+   * Only the columns of the store survive: the rule id, the level (warning for results that had
+   * none), the message text, the URI, start line and start column of the primary location, and
+   * the `sharif/v1` partial fingerprint. Everything else, such as other locations, end positions,
+   * rule and artifact tables and properties, was dropped when the table was built.
+   */
+  auto to_sarif() const -> Sarif;
+  auto to_diagnostics() const -> std::vector<Diagnostic>;
+
+private:
+  /** @returns the rows of `index` that refer to `str`. */
+  auto rows_for(std::span<const Entry> index, std::span<const uint32_t> rows, std::string_view str) const noexcept
+    -> std::span<const uint32_t>;
+
+  MappedFile                    _file;
+  std::span<const uint64_t>     _string_offsets;
+  std::string_view              _string_data;
+  std::string_view              _driver;
+  std::span<const uint64_t>     _fingerprints;
+  std::span<const uint32_t>     _rules;
+  std::span<const uint32_t>     _files;
+  std::span<const uint32_t>     _lines;
+  std::span<const uint32_t>     _columns;
+  std::span<const uint32_t>     _messages;
+  std::span<const Entry>        _file_index;
+  std::span<const uint32_t>     _file_rows;
+  std::span<const Entry>        _rule_index;
+  std::span<const uint32_t>     _rule_rows;
+  std::span<const sarif::Level> _levels;
+};
+
+}  // namespace sharif
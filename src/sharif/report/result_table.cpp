@@ -0,0 +1,329 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <charconv>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+
+// 3rd
+
+// local
+#include <sharif/report/fingerprint.hpp>
+#include <sharif/report/result_table.hpp>
+#include <sharif/util/fmt.hpp>
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+namespace {
+template <typename T>
+auto gather(std::vector<T>& column, std::span<const uint32_t> rows) -> void
+{
+  std::vector<T> sorted;
+  sorted.reserve(rows.size());
+  for (const auto row : rows)
+  {
+    sorted.push_back(column[row]);
+  }
+  column = std::move(sorted);
+}
+
+auto parse_fingerprint(const sarif::Result& result) -> uint64_t
+{
+  if (!result.partialFingerprints)
+  {
+    return 0;
+  }
+  auto it = result.partialFingerprints->find(std::string{ FINGERPRINT_KEY });
+  if (it == result.partialFingerprints->end())
+  {
+    return 0;
+  }
+
+  uint64_t value = 0;
+  std::from_chars(it->second.data(), it->second.data() + it->second.size(), value, 16);
+  return value;
+}
+}  // namespace
+
+auto ResultRow::to_result() const -> sarif::Result
+{
+  sarif::Result result;
+  if (!rule.empty())
+  {
+    result.ruleId = std::string{ rule };
+  }
+  result.level = level;
+  if (!message.empty())
+  {
+    result.message.text = std::string{ message };
+  }
+
+  if (!file.empty() || line != 0)
+  {
+    sarif::PhysicalLocation physical;
+    if (!file.empty())
+    {
+      physical.artifactLocation = sarif::ArtifactLocation{ .uri = std::string{ file } };
+    }
+    if (line != 0)
+    {
+      sarif::Region region;
+      region.startLine   = line;
+      region.startColumn = (column != 0) ? (std::optional{ column }) : (std::nullopt);
+      physical.region    = std::move(region);
+    }
+
+    sarif::Location location;
+    location.physicalLocation = std::move(physical);
+    result.locations          = std::vector<sarif::Location>{ std::move(location) };
+  }
+
+  if (fingerprint != 0)
+  {
+    result.partialFingerprints = sarif::map_t<std::string, std::string>{
+      { std::string{ FINGERPRINT_KEY }, fmt::format("{:016x}", fingerprint) },
+    };
+  }
+  return result;
+}
+
+auto ResultRow::to_diagnostic() const -> Diagnostic
+{
+  Diagnostic diagnostic{};
+  diagnostic.file     = (file.empty()) ? (std::string{}) : (sarif::from_uri(file));
+  diagnostic.line     = line;
+  diagnostic.column   = column;
+  diagnostic.severity = sarif::to_severity(level);
+  diagnostic.message  = message;
+  diagnostic.category = rule;
+  return diagnostic;
+}
+
+auto ResultTable::from(const std::vector<sarif::Result>& results) -> ResultTable
+{
+  ResultTable table;
+  table._rules.reserve(results.size());
+  table._levels.reserve(results.size());
+  table._files.reserve(results.size());
+  table._lines.reserve(results.size());
+  table._columns.reserve(results.size());
+  table._messages.reserve(results.size());
+  table._fingerprints.reserve(results.size());
+  table._origins.reserve(results.size());
+  for (const auto& result : results)
+  {
+    table.add(result);
+  }
+  return table;
+}
+
+auto ResultTable::add(const sarif::Result& result) -> void
+{
+  const auto* location = sarif::primary_location(result);
+  const auto  has_uri  = location != nullptr && location->artifactLocation && location->artifactLocation->uri;
+  const auto  region   = (location != nullptr && location->region) ? (&*location->region) : (nullptr);
+
+  _rules.push_back((result.ruleId) ? (intern(*result.ruleId)) : (NONE));
+  _levels.push_back(result.level.value_or(sarif::Level::warning));
+  _files.push_back((has_uri) ? (intern(*location->artifactLocation->uri)) : (NONE));
+  _lines.push_back((region != nullptr) ? (region->startLine.value_or(0)) : (0));
+  _columns.push_back((region != nullptr) ? (region->startColumn.value_or(0)) : (0));
+  _messages.push_back((result.message.text) ? (intern(*result.message.text)) : (NONE));
+  _fingerprints.push_back(parse_fingerprint(result));
+  _origins.push_back(_added++);
+}
+
+auto ResultTable::add(const Diagnostic& diagnostic) -> void
+{
+  const auto uri = (diagnostic.file.empty()) ? (std::string{}) : (sarif::to_uri(diagnostic.file));
+  add(ResultRow{
+    .rule        = diagnostic.category,
+    .level       = sarif::to_level(diagnostic.severity),
+    .file        = uri,
+    .line        = diagnostic.line,
+    .column      = diagnostic.column,
+    .message     = diagnostic.message,
+    .fingerprint = 0,
+  });
+}
+
+auto ResultTable::add(const ResultRow& row) -> void
+{
+  _rules.push_back(intern(row.rule));
+  _levels.push_back(row.level);
+  _files.push_back(intern(row.file));
+  _lines.push_back(row.line);
+  _columns.push_back(row.column);
+  _messages.push_back(intern(row.message));
+  _fingerprints.push_back(row.fingerprint);
+  _origins.push_back(_added++);
+}
+
+auto ResultTable::row(size_t row) const noexcept -> ResultRow
+{
+  return ResultRow{
+    .rule        = _strings[_rules[row]],
+    .level       = _levels[row],
+    .file        = _strings[_files[row]],
+    .line        = _lines[row],
+    .column      = _columns[row],
+    .message     = _strings[_messages[row]],
+    .fingerprint = _fingerprints[row],
+  };
+}
+
+auto ResultTable::to_result(size_t row) const -> sarif::Result
+{
+  return this->row(row).to_result();
+}
+
+auto ResultTable::to_results() const -> std::vector<sarif::Result>
+{
+  std::vector<sarif::Result> results;
+  results.reserve(size());
+  for (size_t row = 0; row < size(); ++row)
+  {
+    results.push_back(to_result(row));
+  }
+  return results;
+}
+
+auto ResultTable::select(std::vector<sarif::Result> results) const -> std::vector<sarif::Result>
+{
+  std::vector<sarif::Result> selected;
+  selected.reserve(size());
+  for (const auto origin : _origins)
+  {
+    selected.push_back(std::move(results[origin]));
+  }
+  return selected;
+}
+
+auto ResultTable::sort_by_location() -> void
+{
+  const auto rank   = string_ranks();
+  auto       ranked = [&](uint32_t id) { return (id != NONE) ? (rank[id]) : (NONE); };
+  auto       key    = [&](uint32_t row) {
+    return std::tuple{ ranked(_files[row]), _lines[row], _columns[row], ranked(_rules[row]) };
+  };
+  sort([&](uint32_t lhs, uint32_t rhs) { return key(lhs) < key(rhs); });
+}
+
+auto ResultTable::size() const noexcept -> size_t
+{
+  return _origins.size();
+}
+
+auto ResultTable::empty() const noexcept -> bool
+{
+  return _origins.empty();
+}
+
+auto ResultTable::rules() const noexcept -> std::span<const uint32_t>
+{
+  return _rules;
+}
+
+auto ResultTable::levels() const noexcept -> std::span<const sarif::Level>
+{
+  return _levels;
+}
+
+auto ResultTable::files() const noexcept -> std::span<const uint32_t>
+{
+  return _files;
+}
+
+auto ResultTable::lines() const noexcept -> std::span<const uint32_t>
+{
+  return _lines;
+}
+
+auto ResultTable::columns() const noexcept -> std::span<const uint32_t>
+{
+  return _columns;
+}
+
+auto ResultTable::messages() const noexcept -> std::span<const uint32_t>
+{
+  return _messages;
+}
+
+auto ResultTable::fingerprints() const noexcept -> std::span<const uint64_t>
+{
+  return _fingerprints;
+}
+
+auto ResultTable::origins() const noexcept -> std::span<const uint32_t>
+{
+  return _origins;
+}
+
+auto ResultTable::rule(size_t row) const noexcept -> std::string_view
+{
+  return _strings[_rules[row]];
+}
+
+auto ResultTable::file(size_t row) const noexcept -> std::string_view
+{
+  return _strings[_files[row]];
+}
+
+auto ResultTable::message(size_t row) const noexcept -> std::string_view
+{
+  return _strings[_messages[row]];
+}
+
+auto ResultTable::strings() const noexcept -> const StringPool&
+{
+  return _strings;
+}
+
+auto ResultTable::permute(std::span<const uint32_t> rows) -> void
+{
+  gather(_rules, rows);
+  gather(_levels, rows);
+  gather(_files, rows);
+  gather(_lines, rows);
+  gather(_columns, rows);
+  gather(_messages, rows);
+  gather(_fingerprints, rows);
+  gather(_origins, rows);
+}
+
+auto ResultTable::string_ranks() const -> std::vector<uint32_t>
+{
+  std::vector<uint32_t> ids(_strings.size());
+  std::iota(ids.begin(), ids.end(), 0U);
+  std::ranges::sort(ids, {}, [this](uint32_t id) { return _strings[id]; });
+
+  std::vector<uint32_t> rank(ids.size());
+  for (uint32_t pos = 0; pos < ids.size(); ++pos)
+  {
+    rank[ids[pos]] = pos;
+  }
+  return rank;
+}
+
+auto ResultTable::intern(std::string_view str) -> uint32_t
+{
+  return (str.empty()) ? (NONE) : (_strings.intern(str));
+}
+
+auto sort_by_location(std::vector<sarif::Result>& results) -> void
+{
+  auto table = ResultTable::from(results);
+  table.sort_by_location();
+  results = table.select(std::move(results));
+}
+
+}  // namespace sharif
@@ -0,0 +1,149 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/parse/sarif.hpp>
+#include <sharif/util/string_pool.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** The fields of one `ResultTable` row. Strings are borrowed from the table; an empty string
+ * stands for a field the result did not set.
+ */
+struct ResultRow {
+  std::string_view rule;
+  sarif::Level     level{ sarif::Level::warning };
+  std::string_view file;  ///< Artifact URI
+  uint32_t         line{ 0 };
+  uint32_t         column{ 0 };
+  std::string_view message;
+  uint64_t         fingerprint{ 0 };
+
+  auto to_result() const -> sarif::Result;
+  auto to_diagnostic() const -> Diagnostic;
+};
+
+/** Column-oriented view of the fields of `sarif::Result` that reports sort, filter and match on.
+ *
+ * Each row holds the rule id, level, file, line, column, message and `sharif/v1` fingerprint of
+ * one result, with strings interned into a shared `StringPool`. Filtering and sorting permute the
+ * contiguous columns instead of moving whole results; `select()` then applies the final row
+ * order to the results the table was built from.
+ */
+class ResultTable {
+public:
+  static constexpr uint32_t NONE = StringPool::NONE;
+
+  static auto from(const std::vector<sarif::Result>& results) -> ResultTable;
+
+  /** Appends a row; its origin is the number of rows added before it. */
+  auto add(const sarif::Result& result) -> void;
+  auto add(const Diagnostic& diagnostic) -> void;
+  auto add(const ResultRow& row) -> void;
+
+  auto row(size_t row) const noexcept -> ResultRow;
+
+  /** @returns a result holding the fields of `row`. */
+  auto to_result(size_t row) const -> sarif::Result;
+  auto to_results() const -> std::vector<sarif::Result>;
+
+  /** @returns the elements of `results` the rows were built from, in row order. */
+  auto select(std::vector<sarif::Result> results) const -> std::vector<sarif::Result>;
+
+  /** Keeps the rows for which `keep(row)` returns true.
+   * @returns the number of rows removed.
+   */
+  template <typename Pred>
+  auto filter(Pred&& keep) -> size_t
+  {
+    std::vector<uint32_t> rows;
+    rows.reserve(size());
+    for (uint32_t row = 0; row < size(); ++row)
+    {
+      if (keep(row))
+      {
+        rows.push_back(row);
+      }
+    }
+
+    const auto removed = size() - rows.size();
+    permute(rows);
+    return removed;
+  }
+
+  /** Stable sort of the rows with `less(row_a, row_b)`. */
+  template <typename Less>
+  auto sort(Less&& less) -> void
+  {
+    std::vector<uint32_t> rows(size());
+    std::iota(rows.begin(), rows.end(), 0U);
+    std::ranges::stable_sort(rows, std::forward<Less>(less));
+    permute(rows);
+  }
+
+  /** Sorts by file path, line, column and rule id. */
+  auto sort_by_location() -> void;
+
+  auto size() const noexcept -> size_t;
+  auto empty() const noexcept -> bool;
+
+  auto rules() const noexcept -> std::span<const uint32_t>;
+  auto levels() const noexcept -> std::span<const sarif::Level>;
+  auto files() const noexcept -> std::span<const uint32_t>;
+  auto lines() const noexcept -> std::span<const uint32_t>;
+  auto columns() const noexcept -> std::span<const uint32_t>;
+  auto messages() const noexcept -> std::span<const uint32_t>;
+  auto fingerprints() const noexcept -> std::span<const uint64_t>;
+  auto origins() const noexcept -> std::span<const uint32_t>;
+
+  auto rule(size_t row) const noexcept -> std::string_view;
+  auto file(size_t row) const noexcept -> std::string_view;
+  auto message(size_t row) const noexcept -> std::string_view;
+  auto strings() const noexcept -> const StringPool&;
+
+private:
+  /** Rearranges every column so row `i` becomes the old row `rows[i]`. */
+  auto permute(std::span<const uint32_t> rows) -> void;
+
+  /** @returns the position of each string id in lexicographic order. */
+  auto string_ranks() const -> std::vector<uint32_t>;
+
+  /** @returns the id of `str`, or `NONE` if it is empty. */
+  auto intern(std::string_view str) -> uint32_t;
+
+  StringPool                _strings;
+  std::vector<uint32_t>     _rules;
+  std::vector<sarif::Level> _levels;
+  std::vector<uint32_t>     _files;
+  std::vector<uint32_t>     _lines;
+  std::vector<uint32_t>     _columns;
+  std::vector<uint32_t>     _messages;
+  std::vector<uint64_t>     _fingerprints;
+  std::vector<uint32_t>     _origins;
+  uint32_t                  _added{ 0 };
+};
+
+/* Functions
+ ******************************************************************************/
+/** Orders `results` by file path, line, column and rule id. */
+auto sort_by_location(std::vector<sarif::Result>& results) -> void;
+
+}  // namespace sharif
@@ -0,0 +1,326 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/report/tables.hpp>
+#include <sharif/util/ranges.hpp>
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+auto RuleTable::add(sarif::ReportingDescriptor rule) -> int32_t
+{
+  const auto idx      = static_cast<int32_t>(_rules.size());
+  auto [it, inserted] = _index.try_emplace(rule.id, idx);
+  if (inserted)
+  {
+    _rules.push_back(std::move(rule));
+  }
+  return it->second;
+}
+
+auto RuleTable::add(std::string_view id) -> int32_t
+{
+  if (auto it = _index.find(id); it != _index.end())
+  {
+    return it->second;
+  }
+
+  sarif::ReportingDescriptor rule;
+  rule.id = id;
+  return add(std::move(rule));
+}
+
+auto RuleTable::find(std::string_view id) const -> int32_t
+{
+  auto it = _index.find(id);
+  return (it != _index.end()) ? (it->second) : (-1);
+}
+
+auto RuleTable::rules() const noexcept -> const std::vector<sarif::ReportingDescriptor>&
+{
+  return _rules;
+}
+
+auto RuleTable::take() noexcept -> std::vector<sarif::ReportingDescriptor>
+{
+  _index.clear();
+  return std::exchange(_rules, {});
+}
+
+auto RuleTable::size() const noexcept -> size_t
+{
+  return _rules.size();
+}
+
+auto ArtifactTable::add(sarif::Artifact artifact) -> int32_t
+{
+  const auto idx = static_cast<int32_t>(_artifacts.size());
+  if (artifact.location && artifact.location->uri)
+  {
+    auto [it, inserted] = _index.try_emplace(key(*artifact.location), idx);
+    if (!inserted)
+    {
+      return it->second;
+    }
+  }
+
+  if (artifact.location)
+  {
+    artifact.location->index = idx;
+  }
+  _artifacts.push_back(std::move(artifact));
+  return idx;
+}
+
+auto ArtifactTable::add(const sarif::ArtifactLocation& location) -> int32_t
+{
+  if (!location.uri)
+  {
+    return -1;
+  }
+  if (auto it = _index.find(key(location)); it != _index.end())
+  {
+    return it->second;
+  }
+
+  sarif::Artifact artifact;
+  artifact.location = sarif::ArtifactLocation{ .uri = location.uri, .uriBaseId = location.uriBaseId };
+  return add(std::move(artifact));
+}
+
+auto ArtifactTable::artifacts() const noexcept -> const std::vector<sarif::Artifact>&
+{
+  return _artifacts;
+}
+
+auto ArtifactTable::take() noexcept -> std::vector<sarif::Artifact>
+{
+  _index.clear();
+  return std::exchange(_artifacts, {});
+}
+
+auto ArtifactTable::size() const noexcept -> size_t
+{
+  return _artifacts.size();
+}
+
+auto ArtifactTable::key(const sarif::ArtifactLocation& location) -> std::string
+{
+  std::string id;
+  if (location.uriBaseId)
+  {
+    id  = *location.uriBaseId;
+    id += '\0';
+  }
+  id += location.uri.value_or(std::string{});
+  return id;
+}
+
+auto ExtensionTable::add(sarif::ToolComponent component) -> std::pair<int32_t, std::vector<int32_t>>
+{
+  auto idx = static_cast<int32_t>(_extensions.size());
+  if (!component.name.empty())
+  {
+    idx = _index.try_emplace(component.name, idx).first->second;
+  }
+
+  auto rules = std::exchange(component.rules, std::nullopt);
+  if (static_cast<size_t>(idx) == _extensions.size())
+  {
+    _extensions.push_back({ .component = std::move(component), .rules = {} });
+  }
+
+  std::vector<int32_t> map;
+  if (rules)
+  {
+    map.reserve(rules->size());
+    for (auto& rule : *rules)
+    {
+      map.push_back(_extensions[static_cast<size_t>(idx)].rules.add(std::move(rule)));
+    }
+  }
+  return { idx, std::move(map) };
+}
+
+auto ExtensionTable::find(std::string_view name) const -> int32_t
+{
+  auto it = _index.find(name);
+  return (it != _index.end()) ? (it->second) : (-1);
+}
+
+auto ExtensionTable::rules(int32_t idx) -> RuleTable&
+{
+  return _extensions[static_cast<size_t>(idx)].rules;
+}
+
+auto ExtensionTable::take() -> std::vector<sarif::ToolComponent>
+{
+  std::vector<sarif::ToolComponent> extensions;
+  extensions.reserve(_extensions.size());
+  for (auto& [component, rules] : _extensions)
+  {
+    if (rules.size() > 0)
+    {
+      component.rules = rules.take();
+    }
+    extensions.push_back(std::move(component));
+  }
+  _extensions.clear();
+  _index.clear();
+  return extensions;
+}
+
+auto ExtensionTable::size() const noexcept -> size_t
+{
+  return _extensions.size();
+}
+
+auto absorb_tables(sarif::Run& run, RunTables& tables) -> TableMap
+{
+  TableMap map;
+  if (run.tool.driver.rules)
+  {
+    map.rules.reserve(run.tool.driver.rules->size());
+    for (auto& rule : *run.tool.driver.rules)
+    {
+      map.rules.push_back(tables.rules.add(std::move(rule)));
+    }
+    run.tool.driver.rules = std::nullopt;
+  }
+
+  if (run.artifacts)
+  {
+    map.artifacts.reserve(run.artifacts->size());
+    for (auto& artifact : *run.artifacts)
+    {
+      map.artifacts.push_back(tables.artifacts.add(std::move(artifact)));
+    }
+    run.artifacts = std::nullopt;
+  }
+
+  if (run.tool.extensions)
+  {
+    for (auto& extension : *run.tool.extensions)
+    {
+      auto [idx, rules] = tables.extensions.add(std::move(extension));
+      map.extensions.push_back(idx);
+      map.extension_rules.push_back(std::move(rules));
+    }
+    run.tool.extensions = std::nullopt;
+  }
+  return map;
+}
+
+auto emplace_tables(sarif::Run& run, RunTables& tables) -> void
+{
+  if (tables.rules.size() > 0)
+  {
+    run.tool.driver.rules = tables.rules.take();
+  }
+  if (tables.extensions.size() > 0)
+  {
+    run.tool.extensions = tables.extensions.take();
+  }
+  if (tables.artifacts.size() > 0)
+  {
+    run.artifacts = tables.artifacts.take();
+    for (auto& artifact : *run.artifacts)
+    {
+      // Drop the schema's "unknown" defaults, written for every artifact otherwise
+      artifact.parentIndex = (artifact.parentIndex.value_or(-1) >= 0) ? (artifact.parentIndex) : (std::nullopt);
+      artifact.length      = (artifact.length.value_or(-1) >= 0) ? (artifact.length) : (std::nullopt);
+    }
+  }
+}
+
+auto reindex(sarif::Result& result, const TableMap& map, RunTables& tables) -> void
+{
+  // `ruleIndex` and `rule.index` point into the rules of `rule.toolComponent`, or of the driver
+  auto* component = (result.rule && result.rule->toolComponent) ? (&*result.rule->toolComponent) : (nullptr);
+  auto  local     = (component != nullptr) ? (component->index.value_or(-1)) : (-1);
+  if (component != nullptr && local < 0 && component->name)
+  {
+    const auto shared = tables.extensions.find(*component->name);
+    const auto it     = range::find(map.extensions, shared);
+    local             = (shared >= 0 && it != map.extensions.end()) ? (static_cast<int32_t>(it - map.extensions.begin())) : (-1);
+  }
+  const bool extension = local >= 0 && static_cast<size_t>(local) < map.extensions.size();
+  if (component != nullptr && extension)
+  {
+    component->index = map.extensions[static_cast<size_t>(local)];
+  }
+
+  const auto& rule_map = (extension) ? (map.extension_rules[static_cast<size_t>(local)]) : (map.rules);
+  auto&       rules    = (extension) ? (tables.extensions.rules(*component->index)) : (tables.rules);
+  const auto* id       = (result.ruleId) ? (&*result.ruleId) : ((result.rule && result.rule->id) ? (&*result.rule->id) : (nullptr));
+  const auto  remap    = [&](std::optional<int32_t>& index) {
+    const auto idx = index.value_or(-1);
+    if (idx >= 0 && static_cast<size_t>(idx) < rule_map.size())
+    {
+      index = rule_map[static_cast<size_t>(idx)];
+    }
+    else if (id != nullptr)
+    {
+      index = rules.add(*id);
+    }
+  };
+
+  remap(result.ruleIndex);
+  if (result.rule)
+  {
+    remap(result.rule->index);
+  }
+  const auto resolved = (result.ruleIndex.value_or(-1) >= 0) ? (*result.ruleIndex) : ((result.rule) ? (result.rule->index.value_or(-1)) : (-1));
+  if (!result.ruleId && resolved >= 0)
+  {
+    result.ruleId = rules.rules()[static_cast<size_t>(resolved)].id;
+  }
+
+  for_each_artifact_location(result, [&](sarif::ArtifactLocation& location) {
+    const auto idx = location.index.value_or(-1);
+    location.index = (idx >= 0 && static_cast<size_t>(idx) < map.artifacts.size()) ? (map.artifacts[static_cast<size_t>(idx)]) : (tables.artifacts.add(location));
+  });
+}
+
+auto strip_indexed_uris(sarif::Result& result) -> void
+{
+  for_each_artifact_location(result, [](sarif::ArtifactLocation& location) {
+    if (location.index.value_or(-1) >= 0)
+    {
+      location.uri       = std::nullopt;
+      location.uriBaseId = std::nullopt;
+    }
+  });
+}
+
+auto compact(sarif::Run& run) -> void
+{
+  RunTables  tables;
+  const auto map = absorb_tables(run, tables);
+  if (run.results)
+  {
+    for (auto& result : *run.results)
+    {
+      reindex(result, map, tables);
+      strip_indexed_uris(result);
+    }
+  }
+
+  emplace_tables(run, tables);
+}
+
+}  // namespace sharif
@@ -0,0 +1,246 @@
+/** @file
+ *
+ * Run-level tables that results reference by index instead of repeating their contents.
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/parse/sarif.hpp>
+#include <sharif/util/hash.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** `ToolComponent::rules` with each rule id stored once. */
+class RuleTable {
+public:
+  /** @returns the index of the rule with `rule.id`, adding `rule` if the id is new. */
+  auto add(sarif::ReportingDescriptor rule) -> int32_t;
+
+  /** @returns the index of the rule `id`, adding a descriptor with only the id if it is new. */
+  auto add(std::string_view id) -> int32_t;
+
+  /** @returns the index of the rule `id`, or -1. */
+  auto find(std::string_view id) const -> int32_t;
+
+  auto rules() const noexcept -> const std::vector<sarif::ReportingDescriptor>&;
+  auto take() noexcept -> std::vector<sarif::ReportingDescriptor>;
+  auto size() const noexcept -> size_t;
+
+private:
+  std::vector<sarif::ReportingDescriptor>                               _rules;
+  std::unordered_map<std::string, int32_t, StringHash, std::equal_to<>> _index;
+};
+
+/** `Run::artifacts` with each (uriBaseId, uri) stored once. */
+class ArtifactTable {
+public:
+  /** @returns the index of the artifact at `artifact.location`, adding `artifact` if it is new.
+   * Artifacts without a URI are always added.
+   */
+  auto add(sarif::Artifact artifact) -> int32_t;
+
+  /** @returns the index of the artifact at `location`, adding it if it is new, or -1 if
+   * `location` has no URI.
+   */
+  auto add(const sarif::ArtifactLocation& location) -> int32_t;
+
+  auto artifacts() const noexcept -> const std::vector<sarif::Artifact>&;
+  auto take() noexcept -> std::vector<sarif::Artifact>;
+  auto size() const noexcept -> size_t;
+
+private:
+  static auto key(const sarif::ArtifactLocation& location) -> std::string;
+
+  std::vector<sarif::Artifact>                                          _artifacts;
+  std::unordered_map<std::string, int32_t, StringHash, std::equal_to<>> _index;
+};
+
+/** `Tool::extensions` with each named extension stored once, its rules unified like `RuleTable`. */
+class ExtensionTable {
+public:
+  /** Adds the rules of `component` to the extension of the same name, adding it if it is new.
+   * Extensions without a name are always added.
+   *
+   * @returns the index of the extension, and the shared index of each rule it had.
+   */
+  auto add(sarif::ToolComponent component) -> std::pair<int32_t, std::vector<int32_t>>;
+
+  /** @returns the index of the extension `name`, or -1. */
+  auto find(std::string_view name) const -> int32_t;
+
+  /** @returns the rules of extension `idx`. */
+  auto rules(int32_t idx) -> RuleTable&;
+
+  auto take() -> std::vector<sarif::ToolComponent>;
+  auto size() const noexcept -> size_t;
+
+private:
+  struct Entry {
+    sarif::ToolComponent component;
+    RuleTable            rules;
+  };
+
+  std::vector<Entry>                                                    _extensions;
+  std::unordered_map<std::string, int32_t, StringHash, std::equal_to<>> _index;
+};
+
+/** The tables of one or more runs that share them. */
+struct RunTables {
+  RuleTable      rules;
+  ArtifactTable  artifacts;
+  ExtensionTable extensions;
+};
+
+/** Where the entries of a run's own tables ended up in shared tables. */
+struct TableMap {
+  std::vector<int32_t>              rules;
+  std::vector<int32_t>              artifacts;
+  std::vector<int32_t>              extensions;
+  std::vector<std::vector<int32_t>> extension_rules;  ///< Rules of each of the run's extensions
+};
+
+/* Functions
+ ******************************************************************************/
+/** Moves the rules, artifacts and tool extensions of `run` into shared tables.
+ *
+ * @returns the shared index of each rule, artifact and extension that `run` had.
+ */
+auto absorb_tables(sarif::Run& run, RunTables& tables) -> TableMap;
+
+/** Moves shared tables into `run` as its `ToolComponent::rules`, `Run::artifacts` and
+ * `Tool::extensions`; the inverse of `absorb_tables()`.
+ */
+auto emplace_tables(sarif::Run& run, RunTables& tables) -> void;
+
+/** Points the rule and artifact references of `result` into shared tables: `ruleIndex` and
+ * `rule`, into the driver's or an extension's rules, and every `ArtifactLocation.index` found by
+ * `for_each_artifact_location()`. Indices into the result's own run are translated through
+ * `map`; references without one are looked up by rule id or URI, adding entries as needed.
+ */
+auto reindex(sarif::Result& result, const TableMap& map, RunTables& tables) -> void;
+
+/** Drops `uri` and `uriBaseId` from artifact locations that reference `Run::artifacts` by index. */
+auto strip_indexed_uris(sarif::Result& result) -> void;
+
+/** Stores each rule and artifact of `run` once, in `ToolComponent::rules` and `Run::artifacts`,
+ * and makes results reference them by `ruleIndex` and `ArtifactLocation.index` instead of
+ * repeating their URIs.
+ */
+auto compact(sarif::Run& run) -> void;
+
+namespace detail {
+template <typename Fn>
+auto for_each_node_location(sarif::Node& node, Fn& fn) -> void
+{
+  if (node.location)
+  {
+    fn(*node.location);
+  }
+  if (node.children)
+  {
+    for (auto& child : *node.children)
+    {
+      for_each_node_location(child, fn);
+    }
+  }
+}
+}  // namespace detail
+
+/** Calls `fn(artifact_location)` for every artifact location of a result: its analysis target,
+ * locations and related locations, stacks, code flows, graph nodes, suppressions, attachments,
+ * fixes and conversion sources.
+ */
+template <typename Fn>
+auto for_each_artifact_location(sarif::Result& result, Fn&& fn) -> void
+{
+  auto each = [](auto& values, auto&& visit) {
+    if (values)
+    {
+      for (auto& value : *values)
+      {
+        visit(value);
+      }
+    }
+  };
+  auto physical = [&](sarif::PhysicalLocation& value) {
+    if (value.artifactLocation)
+    {
+      fn(*value.artifactLocation);
+    }
+  };
+  auto location = [&](sarif::Location& value) {
+    if (value.physicalLocation)
+    {
+      physical(*value.physicalLocation);
+    }
+  };
+  auto stack = [&](sarif::Stack& value) {
+    for (auto& frame : value.frames)
+    {
+      location(frame.location);
+    }
+  };
+
+  if (result.analysisTarget)
+  {
+    fn(*result.analysisTarget);
+  }
+  each(result.locations, location);
+  each(result.relatedLocations, location);
+  each(result.stacks, stack);
+  each(result.codeFlows, [&](sarif::CodeFlow& flow) {
+    for (auto& thread : flow.threadFlows)
+    {
+      for (auto& step : thread.locations)
+      {
+        if (step.location)
+        {
+          location(*step.location);
+        }
+        if (step.stack)
+        {
+          stack(*step.stack);
+        }
+      }
+    }
+  });
+  each(result.graphs, [&](sarif::Graph& graph) {
+    each(graph.nodes, [&](sarif::Node& node) { detail::for_each_node_location(node, location); });
+  });
+  each(result.suppressions, [&](sarif::Suppression& suppression) {
+    if (suppression.location)
+    {
+      location(*suppression.location);
+    }
+  });
+  each(result.attachments, [&](sarif::Attachment& attachment) { fn(attachment.artifactLocation); });
+  each(result.fixes, [&](sarif::Fix& fix) {
+    for (auto& change : fix.artifactChanges)
+    {
+      fn(change.artifactLocation);
+    }
+  });
+  if (result.provenance)
+  {
+    each(result.provenance->conversionSources, physical);
+  }
+}
+
+}  // namespace sharif
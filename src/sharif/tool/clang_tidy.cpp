@@ -0,0 +1,275 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <numeric>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/parse/diagnostic.hpp>
+#include <sharif/report/dedup.hpp>
+#include <sharif/tool/clang_tidy.hpp>
+#include <sharif/util/json.hpp>
+#include <sharif/util/log.hpp>
+#include <sharif/util/parallel.hpp>
+#include <sharif/util/pipeline.hpp>
+#include <sharif/util/proc.hpp>
+#include <sharif/util/ranges.hpp>
+#include <sharif/util/thread_pool.hpp>
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+namespace {
+/// Diagnostics of one translation unit, on their way to the de-duplicating stage.
+struct Parsed {
+  size_t                  idx;
+  std::vector<Diagnostic> diagnostics;
+};
+
+void feed_diagnostics(void* ptr, std::string_view chunk)
+{
+  auto* stream = static_cast<DiagnosticStream*>(ptr);
+  stream->feed(chunk);
+}
+
+auto load_history(const fs::path& file) -> ClangTidy::History
+{
+  ClangTidy::History history;
+  if (!file.empty() && fs::exists(file))
+  {
+    if (auto err = json::read_file_json(history, file.string(), std::string{}); err)
+    {
+      log::warn("Ignoring unreadable clang-tidy history '{}'", file.string());
+      history.clear();
+    }
+  }
+  return history;
+}
+
+/** @returns the invocation of clang-tidy over `commands`, with an error notification for each
+ * file it could not be started for.
+ */
+auto make_invocation(const std::vector<CompileCommand>& commands, const std::vector<uint8_t>& failed) -> sarif::Invocation
+{
+  sarif::Invocation invocation;
+  for (size_t idx = 0; idx < commands.size(); ++idx)
+  {
+    if (failed[idx] == 0)
+    {
+      continue;
+    }
+
+    auto& notification        = invocation.toolExecutionNotifications.emplace().emplace_back();
+    notification.level        = sarif::Level::error;
+    notification.message.text = "clang-tidy could not be started";
+
+    auto& location = notification.locations.emplace().emplace_back();
+    location.physicalLocation.emplace().artifactLocation = sarif::ArtifactLocation{ .uri = sarif::to_uri(commands[idx].file) };
+  }
+  invocation.executionSuccessful = !invocation.toolExecutionNotifications;
+  return invocation;
+}
+
+auto save_history(const fs::path& file, const ClangTidy::History& history) -> void
+{
+  if (file.empty())
+  {
+    return;
+  }
+
+  std::error_code err;
+  fs::create_directories(file.parent_path(), err);
+  if (json::write_file_json(history, file.string(), std::string{}))
+  {
+    log::warn("Failed to write clang-tidy history '{}'", file.string());
+  }
+}
+}  // namespace
+
+ClangTidy::ClangTidy()
+  : _jobs{ std::max(std::thread::hardware_concurrency(), 1U) }
+{
+}
+
+auto ClangTidy::with_build_dir(fs::path directory) -> ClangTidy&
+{
+  _build_dir = std::move(directory);
+  return *this;
+}
+
+auto ClangTidy::with_args(std::vector<std::string> arguments) -> ClangTidy&
+{
+  _args = std::move(arguments);
+  return *this;
+}
+
+auto ClangTidy::with_jobs(unsigned jobs) -> ClangTidy&
+{
+  _jobs = std::max(jobs, 1U);
+  return *this;
+}
+
+auto ClangTidy::with_history(fs::path file) -> ClangTidy&
+{
+  _history = std::move(file);
+  return *this;
+}
+
+auto ClangTidy::with_limits(Process::Limits limits) -> ClangTidy&
+{
+  _limits = limits;
+  return *this;
+}
+
+auto ClangTidy::run(const std::vector<CompileCommand>& commands) -> sarif::Run
+{
+  auto history = load_history(_history);
+
+  // Files without history are assumed to be as slow as the slowest known file, so new files
+  // start early instead of becoming the tail of the run.
+  uint32_t unknown = 0;
+  for (const auto ms : history | view::values)
+  {
+    unknown = std::max(unknown, ms);
+  }
+
+  auto estimate = [&](size_t idx) -> uint32_t {
+    auto it = history.find(commands[idx].file);
+    return (it != history.end()) ? (it->second) : (unknown);
+  };
+
+  std::vector<size_t> order(commands.size());
+  std::iota(order.begin(), order.end(), size_t{ 0 });
+  range::stable_sort(order, std::greater{}, estimate);
+
+  std::vector<uint32_t> elapsed(commands.size());
+  std::vector<uint8_t>  failed(commands.size());
+
+  // Header diagnostics are reported once per including translation unit. They are de-duplicated
+  // on a pool thread while other files are still being analyzed, in file order, so the results
+  // do not depend on which process finishes first. The stage's state outlives the pipeline.
+  Deduplicator unique;
+  size_t       next = 0;
+
+  std::vector<std::optional<std::vector<Diagnostic>>> pending(commands.size());
+
+  ThreadPool pool{ 1 };
+  Pipeline   pipeline{ pool };
+
+  auto& dedup = pipeline.sink<Parsed>([&](Parsed&& tu) {
+    pending[tu.idx] = std::move(tu.diagnostics);
+    for (; next < pending.size() && pending[next]; ++next)
+    {
+      unique.add_all(std::move(*pending[next]));
+      pending[next].reset();
+    }
+  });
+
+  const auto analyze = [&](size_t n) {
+    const auto  idx = order[n];
+    const auto& cmd = commands[idx];
+
+    std::vector<std::string> args;
+    args.reserve(_args.size() + 4);
+    if (!_build_dir.empty())
+    {
+      args.emplace_back("-p");
+      args.emplace_back(_build_dir.string());
+    }
+    args.emplace_back("--quiet");
+    args.append_range(_args);
+    args.push_back(cmd.file);
+
+    DiagnosticStream out;
+    DiagnosticStream err;
+    Process          tidy{ _exe, std::move(args) };
+    tidy.with_limits(_limits);
+    tidy.on_stdout(feed_diagnostics, &out);
+    tidy.on_stderr(feed_diagnostics, &err);
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto code  = tidy.run();
+    const auto stop  = std::chrono::steady_clock::now();
+    elapsed[idx]     = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(stop - start).count());
+
+    out.finish();
+    err.finish();
+    auto diagnostics = std::move(out.diagnostics());
+    diagnostics.append_range(err.diagnostics() | view::as_rvalue);
+    log::debug("clang-tidy {} exited {} with {} diagnostic(s), {}", cmd.file, code, diagnostics.size(), tidy.stats());
+    if (code < 0)
+    {
+      log::error("Failed to start '{}' for {}", _exe, cmd.file);
+      failed[idx] = 1;
+    }
+    else if (tidy.stats().timed_out || tidy.stats().signal != 0)
+    {
+      log::warn("clang-tidy {} did not finish: {}", cmd.file, tidy.stats());
+    }
+    dedup.push({ .idx = idx, .diagnostics = std::move(diagnostics) });
+  };
+
+  try
+  {
+    parallel_for(order.size(), _jobs, analyze);
+  }
+  catch (...)
+  {
+    // The analysis error is the one reported; the stage's own, if any, is dropped
+    dedup.close();
+    try
+    {
+      pipeline.wait();
+    }
+    catch (...)  // NOLINT(bugprone-empty-catch)
+    {
+    }
+    throw;
+  }
+  dedup.close();
+  pipeline.wait();
+
+  // Files clang-tidy never ran on keep the time of their last run
+  for (size_t i = 0; i < commands.size(); ++i)
+  {
+    if (failed[i] == 0)
+    {
+      history.insert_or_assign(commands[i].file, elapsed[i]);
+    }
+  }
+  save_history(_history, history);
+
+  sarif::Run run;
+  run.tool.driver.name = "clang-tidy";
+  run.invocations      = std::vector{ make_invocation(commands, failed) };
+  run.results          = unique.to_results();
+
+  return run;
+}
+
+auto ClangTidy::exe() const noexcept -> const std::string&
+{
+  return _exe;
+}
+
+auto ClangTidy::set_exe(std::string exe) noexcept -> bool
+{
+  _exe = std::move(exe);
+  return true;
+}
+
+}  // namespace sharif
@@ -0,0 +1,73 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdint>
+#include <flat_map>
+#include <string>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/parse/compile_command.hpp>
+#include <sharif/parse/sarif.hpp>
+#include <sharif/util/filesystem.hpp>
+#include <sharif/util/proc.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Runs clang-tidy over a compilation database, one process per translation unit.
+ *
+ * Up to `jobs` processes run at once. Translation units are started longest-first using the
+ * run times recorded in the history file by previous runs, so the slowest files do not end up
+ * starting last and stretching the wall time.
+ */
+class ClangTidy {
+public:
+  /// Milliseconds each file took to analyze, keyed by `CompileCommand::file`
+  using History = std::flat_map<std::string, uint32_t>;
+
+  ClangTidy();
+
+  /** Directory containing `compile_commands.json`, passed to clang-tidy as `-p`. */
+  auto with_build_dir(fs::path directory) -> ClangTidy&;
+
+  /** Extra arguments passed to every clang-tidy invocation before the file name. */
+  auto with_args(std::vector<std::string> arguments) -> ClangTidy&;
+
+  /** Maximum number of concurrent clang-tidy processes. */
+  auto with_jobs(unsigned jobs) -> ClangTidy&;
+
+  /** JSON file used to load and store per-file run times. Disabled if empty. */
+  auto with_history(fs::path file) -> ClangTidy&;
+
+  /** Timeout and resource caps for each clang-tidy process; files that hit them are reported. */
+  auto with_limits(Process::Limits limits) -> ClangTidy&;
+
+  /** Analyzes each command's file and merges all diagnostics into a single run. Files clang-tidy
+   * could not be started for are logged and reported as notifications of the run's invocation,
+   * which is then not successful.
+   */
+  auto run(const std::vector<CompileCommand>& commands) -> sarif::Run;
+
+  auto exe() const noexcept -> const std::string&;
+  auto set_exe(std::string exe) noexcept -> bool;
+
+private:
+  std::string              _exe{ "clang-tidy" };
+  fs::path                 _build_dir;
+  std::vector<std::string> _args;
+  fs::path                 _history;
+  Process::Limits          _limits;
+  unsigned                 _jobs{ 1 };
+};
+
+}  // namespace sharif
@@ -0,0 +1,232 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <charconv>
+#include <numeric>
+#include <optional>
+#include <queue>
+#include <random>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/tool/cppcheck.hpp>
+#include <sharif/util/fmt.hpp>
+#include <sharif/util/log.hpp>
+#include <sharif/util/parallel.hpp>
+#include <sharif/util/proc.hpp>
+#include <sharif/util/ranges.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+namespace {
+struct Shard {
+  std::vector<CompileCommand> commands;
+  uintmax_t                   bytes{ 0 };
+};
+
+/* Functions
+ ******************************************************************************/
+auto source_size(const CompileCommand& cmd) -> uintmax_t
+{
+  std::error_code err;
+  auto            path = fs::path{ cmd.file };
+  if (path.is_relative())
+  {
+    path = fs::path{ cmd.directory } / path;
+  }
+  const auto size = fs::file_size(path, err);
+  return (err) ? (0) : (size);
+}
+
+/** Greedily assigns the largest remaining file to the smallest shard, using the source file size
+ * as a stand-in for analysis time.
+ */
+auto make_shards(const std::vector<CompileCommand>& commands, size_t count) -> std::vector<Shard>
+{
+  count = std::clamp<size_t>((count == 0) ? (commands.size()) : (count), 1, std::max<size_t>(commands.size(), 1));
+
+  auto sizes = commands | view::transform(source_size) | range::to<std::vector>();
+
+  std::vector<size_t> order(commands.size());
+  std::iota(order.begin(), order.end(), size_t{ 0 });
+  range::stable_sort(order, std::greater{}, [&sizes](size_t idx) { return sizes[idx]; });
+
+  std::vector<Shard> shards(count);
+  using Load = std::pair<uintmax_t, size_t>;
+  std::priority_queue<Load, std::vector<Load>, std::greater<>> smallest;
+  for (size_t i = 0; i < count; ++i)
+  {
+    smallest.emplace(0, i);
+  }
+
+  for (const auto idx : order)
+  {
+    const auto shard = smallest.top().second;
+    smallest.pop();
+    shards[shard].commands.push_back(commands[idx]);
+    shards[shard].bytes += sizes[idx];
+    smallest.emplace(shards[shard].bytes, shard);
+  }
+
+  std::erase_if(shards, [](const Shard& shard) { return shard.commands.empty(); });
+  range::stable_sort(shards, std::greater{}, &Shard::bytes);
+  return shards;
+}
+
+/** @returns the exit code cppcheck uses for "found errors" if `args` set one with `--error-exitcode`. */
+auto error_exitcode(const std::vector<std::string>& args) -> std::optional<int32_t>
+{
+  constexpr std::string_view OPTION = "--error-exitcode=";
+  for (const auto& arg : args)
+  {
+    int32_t code = 0;
+    if (arg.starts_with(OPTION) && std::from_chars(arg.data() + OPTION.size(), arg.data() + arg.size(), code).ec == std::errc{})
+    {
+      return code;
+    }
+  }
+  return std::nullopt;
+}
+
+/** Creates a directory of its own under `parent` for one run, so concurrent runs never share shard files. */
+auto make_run_dir(const fs::path& parent) -> fs::path
+{
+  fs::create_directories(parent);
+  std::random_device random;
+  while (true)
+  {
+    auto dir = parent / fmt::format("run-{:08x}{:08x}", random(), random());
+    if (fs::create_directory(dir))
+    {
+      return dir;
+    }
+  }
+}
+
+/// Removes a run's directory, whichever way the run ends.
+struct RunDir {
+  fs::path path;
+
+  explicit RunDir(fs::path dir)
+    : path{ std::move(dir) }
+  {
+  }
+
+  RunDir(const RunDir&)                    = delete;
+  auto operator=(const RunDir&) -> RunDir& = delete;
+
+  ~RunDir()
+  {
+    std::error_code err;
+    fs::remove_all(path, err);
+  }
+};
+}  // namespace
+
+Cppcheck::Cppcheck()
+  : _work_dir{ fs::temp_directory_path() / "sharif-cppcheck" }
+  , _jobs{ std::max(std::thread::hardware_concurrency(), 1U) }
+{
+}
+
+auto Cppcheck::with_work_dir(fs::path directory) -> Cppcheck&
+{
+  _work_dir = std::move(directory);
+  return *this;
+}
+
+auto Cppcheck::with_args(std::vector<std::string> arguments) -> Cppcheck&
+{
+  _args = std::move(arguments);
+  return *this;
+}
+
+auto Cppcheck::with_jobs(unsigned jobs) -> Cppcheck&
+{
+  _jobs = std::max(jobs, 1U);
+  return *this;
+}
+
+auto Cppcheck::with_shards(size_t shards) -> Cppcheck&
+{
+  _shards = shards;
+  return *this;
+}
+
+auto Cppcheck::run(const std::vector<CompileCommand>& commands) -> cppcheck::Report
+{
+  if (commands.empty())
+  {
+    return cppcheck::Report{ .errors = {}, .version = 2 };
+  }
+
+  const RunDir run_dir{ make_run_dir(_work_dir) };
+  const auto   findings = error_exitcode(_args);
+  auto         shards   = make_shards(commands, _shards);
+  log::info("cppcheck: {} file(s) in {} shard(s) across {} job(s)", commands.size(), shards.size(), _jobs);
+
+  std::vector<cppcheck::Report> reports(shards.size());
+  parallel_for(shards.size(), _jobs, [&](size_t idx) {
+    const auto project = run_dir.path / fmt::format("shard-{}.json", idx);
+    const auto report  = run_dir.path / fmt::format("shard-{}.xml", idx);
+    CompileCommand::to_file(project.string(), shards[idx].commands);
+
+    // Only ever parse a report this run wrote
+    std::error_code err;
+    fs::remove(report, err);
+
+    std::vector<std::string> args{
+      fmt::format("--project={}", project.string()),
+      "--xml",
+      fmt::format("--output-file={}", report.string()),
+      "--quiet",
+    };
+    args.append_range(_args);
+
+    Process proc{ _exe, std::move(args) };
+    proc.on_stdout([](void*, std::string_view lines) { log::debug("cppcheck: {}", lines); });
+    proc.on_stderr([](void*, std::string_view lines) { log::warn("cppcheck: {}", lines); });
+    if (auto code = proc.run(); code != 0 && code != findings)
+    {
+      // A partial report would make its files look clean, so the shard is reported missing instead
+      log::error("cppcheck exited {} for shard {}; skipping its {} file(s)", code, idx, shards[idx].commands.size());
+      return;
+    }
+
+    if (auto parsed = cppcheck::Report::from(report); parsed)
+    {
+      reports[idx] = std::move(parsed).value();
+    }
+    else
+    {
+      log::error("Failed to read cppcheck report '{}': {}", report.string(), parsed.error().message());
+    }
+  });
+
+  return cppcheck::merge(std::move(reports));
+}
+
+auto Cppcheck::exe() const noexcept -> const std::string&
+{
+  return _exe;
+}
+
+auto Cppcheck::set_exe(std::string exe) noexcept -> bool
+{
+  _exe = std::move(exe);
+  return true;
+}
+
+}  // namespace sharif
@@ -0,0 +1,64 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/parse/compile_command.hpp>
+#include <sharif/parse/cppcheck.hpp>
+#include <sharif/util/filesystem.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Runs cppcheck over a compilation database split into shards.
+ *
+ * Each shard is written out as its own `compile_commands.json` subset and analyzed by a
+ * separate `cppcheck --project=<shard> --xml` process, up to `jobs` at a time. The per-shard
+ * XML reports are then merged into a single report. A shard whose cppcheck run fails is left out
+ * and logged as an error, rather than merged from a partial report.
+ */
+class Cppcheck {
+public:
+  Cppcheck();
+
+  /** Directory under which each run creates, and afterwards removes, a directory of its own for
+   * the per-shard compilation databases and XML reports.
+   */
+  auto with_work_dir(fs::path directory) -> Cppcheck&;
+
+  /** Extra arguments passed to every cppcheck invocation. */
+  auto with_args(std::vector<std::string> arguments) -> Cppcheck&;
+
+  /** Maximum number of concurrent cppcheck processes. */
+  auto with_jobs(unsigned jobs) -> Cppcheck&;
+
+  /** Number of shards to split the commands into; 0 runs one shard per translation unit. */
+  auto with_shards(size_t shards) -> Cppcheck&;
+
+  /** Analyzes the commands and returns the merged, de-duplicated report. */
+  auto run(const std::vector<CompileCommand>& commands) -> cppcheck::Report;
+
+  auto exe() const noexcept -> const std::string&;
+  auto set_exe(std::string exe) noexcept -> bool;
+
+private:
+  std::string              _exe{ "cppcheck" };
+  fs::path                 _work_dir;
+  std::vector<std::string> _args;
+  unsigned                 _jobs{ 1 };
+  size_t                   _shards{ 0 };
+};
+
+}  // namespace sharif
@@ -0,0 +1,195 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <optional>
+#include <utility>
+
+// 3rd
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/readable_pipe.hpp>
+#include <boost/asio/redirect_error.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <fmt/ranges.h>
+#include <boost/process/v2/process.hpp>
+#include <boost/process/v2/start_dir.hpp>
+#include <boost/process/v2/stdio.hpp>
+#include <boost/system/error_code.hpp>
+
+// local
+#include <sharif/util/async_proc.hpp>
+#include <sharif/util/executable.hpp>
+#include <sharif/util/line_buffer.hpp>
+#include <sharif/util/log.hpp>
+
+// namespace
+namespace sharif {
+namespace asio = boost::asio;
+namespace proc = boost::process::v2;
+namespace sys  = boost::system;
+
+/* Constants
+ ******************************************************************************/
+namespace {
+/// Smallest read handed to the stdout pipe.
+constexpr size_t MIN_READ = size_t{ 4 } * 1024;
+}  // namespace
+
+/* Types
+ ******************************************************************************/
+struct AsyncProcess::Impl {
+  explicit Impl(const executor_type& executor)
+    : strand{ asio::make_strand(executor) }
+    , out{ strand }
+    , err{ strand }
+    , err_closed{ strand, std::chrono::steady_clock::time_point::max() }
+  {
+  }
+
+  executor_type                strand;             // NOLINT(misc-non-private-member-variables-in-classes) runs `drain_errors()` and `wait_exit()`
+  asio::readable_pipe          out;                // NOLINT(misc-non-private-member-variables-in-classes)
+  asio::readable_pipe          err;                // NOLINT(misc-non-private-member-variables-in-classes)
+  asio::steady_timer           err_closed;         // NOLINT(misc-non-private-member-variables-in-classes) cancelled at stderr EOF
+  LineBuffer                   buffer;             // NOLINT(misc-non-private-member-variables-in-classes)
+  std::string                  errors;             // NOLINT(misc-non-private-member-variables-in-classes)
+  std::optional<proc::process> child;              // NOLINT(misc-non-private-member-variables-in-classes)
+  std::optional<int32_t>       code;               // NOLINT(misc-non-private-member-variables-in-classes)
+  bool                         out_eof{ false };   // NOLINT(misc-non-private-member-variables-in-classes)
+  bool                         err_eof{ false };   // NOLINT(misc-non-private-member-variables-in-classes)
+
+  /** Collects stderr until EOF; owns `self` so it can outlive the `AsyncProcess`. */
+  static auto drain_errors(std::shared_ptr<Impl> self) -> asio::awaitable<void>
+  {
+    std::array<char, MIN_READ> block{};
+    sys::error_code            err;
+    while (!err)
+    {
+      const auto count = co_await self->err.async_read_some(asio::buffer(block), asio::redirect_error(asio::use_awaitable, err));
+      self->errors.append(block.data(), count);
+    }
+    self->err_eof = true;
+    self->err_closed.cancel();
+  }
+
+  /** Waits for stderr to close, then for the child to exit. Runs on `strand`, so that stderr
+   * cannot close between the `err_eof` check and the wait that `err_closed` would cancel.
+   */
+  static auto wait_exit(std::shared_ptr<Impl> self) -> asio::awaitable<int32_t>
+  {
+    if (!self->err_eof)
+    {
+      sys::error_code ignored;
+      co_await self->err_closed.async_wait(asio::redirect_error(asio::use_awaitable, ignored));
+    }
+    co_return co_await self->child->async_wait(asio::use_awaitable);
+  }
+};
+
+/* Functions
+ ******************************************************************************/
+
+AsyncProcess::AsyncProcess(std::shared_ptr<Impl> self)
+  : _self{ std::move(self) }
+{
+}
+
+AsyncProcess::AsyncProcess(AsyncProcess&&) noexcept                    = default;
+auto AsyncProcess::operator=(AsyncProcess&&) noexcept -> AsyncProcess& = default;
+AsyncProcess::~AsyncProcess()                                          = default;
+
+auto AsyncProcess::start(executor_type executor, std::string_view executable, std::vector<std::string> arguments, std::string directory)
+  -> Result<AsyncProcess>
+{
+  const auto exe = find_executable(executable);
+  if (exe.empty())
+  {
+    log::error("'{}' not found", executable);
+    return Code::no_such_file_or_directory;
+  }
+  if (directory.empty())
+  {
+    directory = std::filesystem::current_path().string();
+  }
+
+  auto            self = std::make_shared<Impl>(executor);
+  sys::error_code err;
+  auto            child = proc::default_process_launcher()(
+    self->strand,
+    err,
+    exe,
+    arguments,
+    proc::process_stdio{ .in = {}, .out = self->out, .err = self->err },
+    proc::process_start_dir(directory)
+  );
+  if (err)
+  {
+    log::error("Failed to start '{}': {}", exe, err.message());
+    return Code::no_such_process;
+  }
+  log::debug("{} {}", exe, fmt::join(arguments, " "));
+
+  self->child.emplace(std::move(child));
+  asio::co_spawn(self->strand, Impl::drain_errors(self), asio::detached);
+  return AsyncProcess{ std::move(self) };
+}
+
+auto AsyncProcess::lines() -> asio::awaitable<std::optional<std::string_view>>
+{
+  auto& self = *_self;
+  while (!self.out_eof)
+  {
+    if (auto lines = self.buffer.lines(); lines)
+    {
+      co_return lines;
+    }
+
+    const auto      space = self.buffer.prepare(MIN_READ);
+    sys::error_code err;
+    const auto      count = co_await self.out.async_read_some(asio::buffer(space.data(), space.size()), asio::redirect_error(asio::use_awaitable, err));
+    self.buffer.commit(count);
+    self.out_eof = static_cast<bool>(err);
+  }
+
+  if (auto lines = self.buffer.lines(); lines)
+  {
+    co_return lines;
+  }
+  if (auto rest = self.buffer.rest(); !rest.empty())
+  {
+    co_return rest;
+  }
+  co_return std::nullopt;
+}
+
+auto AsyncProcess::exit() -> asio::awaitable<int32_t>
+{
+  auto self = _self;
+  if (self->code)
+  {
+    co_return *self->code;
+  }
+
+  while (co_await lines())
+  {
+  }
+  self->code = co_await asio::co_spawn(self->strand, Impl::wait_exit(self), asio::use_awaitable);
+  log::trace("exit: {}", *self->code);
+  co_return *self->code;
+}
+
+auto AsyncProcess::errors() const noexcept -> std::string_view
+{
+  return _self->errors;
+}
+
+}  // namespace sharif
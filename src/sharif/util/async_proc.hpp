@@ -0,0 +1,85 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 3rd
+#include <boost/asio/any_io_executor.hpp>
+#include <boost/asio/awaitable.hpp>
+
+// local
+#include <sharif/util/result.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** A child process driven by coroutines on a caller-provided executor.
+ *
+ * Where `Process::run()` blocks a thread per child and pushes output through callbacks, an
+ * `AsyncProcess` is pulled from straight-line code, and any number of them can be interleaved on
+ * one `io_context` thread:
+ *
+ * @code
+ * auto tidy = AsyncProcess::start(co_await asio::this_coro::executor, "clang-tidy", { file });
+ * while (auto lines = co_await tidy->lines())
+ * {
+ *   stream.feed(*lines);
+ * }
+ * const auto code = co_await tidy->exit();
+ * @endcode
+ *
+ * stderr is drained in the background into `errors()`, so a child cannot stall on a full pipe
+ * nobody is reading. The drain runs on a strand of the executor, so the executor may have several
+ * threads; a single `AsyncProcess` must still be awaited from one coroutine at a time.
+ */
+class AsyncProcess {
+public:
+  using executor_type = boost::asio::any_io_executor;
+
+  /** Starts `executable`, resolved through the executable cache, in `directory` (or the current
+   * one) with the parent's environment.
+   */
+  static auto start(executor_type executor, std::string_view executable, std::vector<std::string> arguments, std::string directory = {})
+    -> Result<AsyncProcess>;
+
+  AsyncProcess(AsyncProcess&&) noexcept;
+  auto operator=(AsyncProcess&&) noexcept -> AsyncProcess&;
+  ~AsyncProcess();
+
+  /** @returns the next complete lines of stdout without their final newline, then a last line
+   * without a newline if there is one, then `std::nullopt` at end of stream. The view is valid
+   * until the next call.
+   */
+  auto lines() -> boost::asio::awaitable<std::optional<std::string_view>>;
+
+  /** Discards any stdout not yet read, waits for stderr to close and for the child to exit.
+   * @returns its exit code.
+   */
+  auto exit() -> boost::asio::awaitable<int32_t>;
+
+  /** @returns everything the child wrote to stderr. Only call it once `exit()` returned: until
+   * then the drain may still be appending to it from another thread.
+   */
+  auto errors() const noexcept -> std::string_view;
+
+private:
+  struct Impl;
+
+  explicit AsyncProcess(std::shared_ptr<Impl> self);
+
+  std::shared_ptr<Impl> _self;  ///< Shared with the coroutine draining stderr
+};
+
+}  // namespace sharif
@@ -0,0 +1,62 @@
+/** @file
+ *
+ * libuv backend for `Process`; only included by the process implementation.
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <chrono>
+#include <cstdint>
+#include <flat_map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/util/detail/resumer.hpp>
+#include <sharif/util/proc.hpp>
+
+// namespace
+namespace sharif::detail {
+
+/* Types
+ ******************************************************************************/
+/// Where one of the child's streams goes: whole lines, or raw chunks that may pause reading.
+struct UvOutput {
+  Process::on_output lines;
+  Process::on_chunk  chunks;
+  void*              context;
+  Resumer*           resumer;
+};
+
+/// Everything the libuv backend needs to start a child and deliver its output.
+struct UvRequest {
+  std::string_view                               exe;
+  const std::vector<std::string>*                args;
+  const std::flat_map<std::string, std::string>* env;
+  std::string_view                               pwd;
+  UvOutput                                       std_out;
+  UvOutput                                       std_err;
+  std::chrono::milliseconds                      timeout;
+  std::chrono::milliseconds                      grace;
+};
+
+/* Functions
+ ******************************************************************************/
+/** Starts the child on the loop shared by all processes and blocks until it has exited and both
+ * of its pipes have closed.
+ *
+ * Output callbacks run on the loop's thread, one at a time across every child. A paused stream
+ * stays paused until its resumer is called, and the child cannot finish until it is. Only the
+ * signal and timeout of `stats` are filled in; libuv reaps the child itself.
+ *
+ * @returns the child's exit code, `128 + signal` if it was killed, or -1 if it failed to start.
+ */
+auto uv_run(const UvRequest& request, Process::Stats& stats) -> int32_t;
+
+}  // namespace sharif::detail
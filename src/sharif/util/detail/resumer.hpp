@@ -0,0 +1,71 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <functional>
+#include <mutex>
+#include <utility>
+
+// 3rd
+
+// local
+
+// namespace
+namespace sharif::detail {
+
+/* Types
+ ******************************************************************************/
+/** Hands the job of restarting a paused reader from the thread that paused it to whichever
+ * thread decides to resume it. A `resume()` that arrives before `pause()` is remembered, so a
+ * consumer may resume as soon as it has returned `Flow::PAUSE`.
+ */
+class Resumer {
+public:
+  /** Stores how to restart reading, or restarts at once if `resume()` already came in. */
+  auto pause(std::move_only_function<void()> restart) -> void
+  {
+    std::unique_lock lock{ _mutex };
+    if (_early)
+    {
+      _early = false;
+      lock.unlock();
+      restart();
+      return;
+    }
+    _restart = std::move(restart);
+  }
+
+  /** Forgets a pending restart and any early `resume()`, ready for the next run. */
+  auto reset() -> void
+  {
+    std::lock_guard lock{ _mutex };
+    _restart = nullptr;
+    _early   = false;
+  }
+
+  /** Restarts a paused reader; safe to call from any thread. */
+  auto resume() -> void
+  {
+    std::unique_lock lock{ _mutex };
+    if (!_restart)
+    {
+      _early = true;
+      return;
+    }
+
+    auto restart = std::exchange(_restart, nullptr);
+    lock.unlock();
+    restart();
+  }
+
+private:
+  std::mutex                      _mutex;
+  std::move_only_function<void()> _restart;
+  bool                            _early{ false };
+};
+
+}  // namespace sharif::detail
@@ -0,0 +1,88 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdlib>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// 3rd
+#include <boost/process/v2/environment.hpp>
+
+// local
+#include <sharif/util/executable.hpp>
+#include <sharif/util/hash.hpp>
+
+// namespace
+namespace sharif {
+namespace proc = boost::process::v2;
+
+/* Types
+ ******************************************************************************/
+namespace {
+/// Resolved executables for one value of `PATH`.
+struct ExecutableCache {
+  std::shared_mutex                                                          mutex;
+  std::string                                                                path;
+  std::unordered_map<std::string, std::string, StringHash, std::equal_to<>> found;
+};
+
+auto cache() -> ExecutableCache&
+{
+  static ExecutableCache instance;
+  return instance;
+}
+
+auto current_path() -> std::string_view
+{
+  const char* path = std::getenv("PATH");  // NOLINT(concurrency-mt-unsafe) nothing here writes the environment
+  return (path != nullptr) ? (std::string_view{ path }) : (std::string_view{});
+}
+}  // namespace
+
+/* Functions
+ ******************************************************************************/
+auto find_executable(std::string_view name) -> std::string
+{
+  auto&      self = cache();
+  const auto path = current_path();
+  {
+    std::shared_lock lock{ self.mutex };
+    if (self.path == path)
+    {
+      if (auto it = self.found.find(name); it != self.found.end())
+      {
+        return it->second;
+      }
+    }
+  }
+
+  // Resolve without the lock; a racing thread resolving the same name gets the same answer
+  auto exe = proc::environment::find_executable(name).string();
+
+  std::unique_lock lock{ self.mutex };
+  if (self.path != path)
+  {
+    self.found.clear();
+    self.path = path;
+  }
+  self.found.try_emplace(std::string{ name }, exe);
+  return exe;
+}
+
+auto clear_executable_cache() -> void
+{
+  auto&            self = cache();
+  std::unique_lock lock{ self.mutex };
+  self.found.clear();
+  self.path.clear();
+}
+
+}  // namespace sharif
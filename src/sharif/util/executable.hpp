@@ -0,0 +1,34 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <string>
+#include <string_view>
+
+// 3rd
+
+// local
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+/** Resolves `name` against `PATH` as `boost::process::v2::environment::find_executable` does.
+ *
+ * Lookups are cached for the whole process, keyed by name and the value of `PATH`, so spawning
+ * the same tool thousands of times walks `PATH` once. The cache starts over whenever `PATH`
+ * changes. Safe to call from any thread.
+ *
+ * @returns the full path of the executable, or an empty string if none was found.
+ */
+auto find_executable(std::string_view name) -> std::string;
+
+/** Forgets every cached lookup, e.g. after a tool was installed into a directory on `PATH`. */
+auto clear_executable_cache() -> void;
+
+}  // namespace sharif
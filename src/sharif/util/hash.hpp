@@ -0,0 +1,130 @@
+/** @file
+ *
+ * Fast, non-cryptographic 64-bit hashing.
+ *
+ * Hashes are stable across runs, processes and platforms (input is read as little-endian),
+ * so they may be persisted, e.g. as SARIF fingerprints. Do not use them where an attacker can
+ * choose the input to force collisions.
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+// 3rd
+
+// local
+
+// namespace
+namespace sharif {
+
+/* Constants
+ ******************************************************************************/
+inline constexpr uint64_t HASH_SEED = 0x9E3779B97F4A7C15ULL;
+
+/* Functions
+ ******************************************************************************/
+/** Finalizer from MurmurHash3; every input bit affects every output bit. */
+constexpr auto hash_mix(uint64_t value) noexcept -> uint64_t
+{
+  value ^= value >> 33U;
+  value *= 0xFF51AFD7ED558CCDULL;
+  value ^= value >> 33U;
+  value *= 0xC4CEB9FE1A85EC53ULL;
+  value ^= value >> 33U;
+  return value;
+}
+
+/** Combines `value` into `seed`. Order matters: `combine(combine(s, a), b) != combine(combine(s, b), a)`. */
+constexpr auto hash_combine(uint64_t seed, uint64_t value) noexcept -> uint64_t
+{
+  return hash_mix(std::rotl(seed, 23) ^ (value + HASH_SEED));
+}
+
+/** Hashes `bytes` 8 at a time. */
+inline auto hash_bytes(std::string_view bytes, uint64_t seed = HASH_SEED) noexcept -> uint64_t
+{
+  constexpr uint64_t multiplier = 0x87C37B91114253D5ULL;
+
+  auto load = [](const char* ptr, size_t len) noexcept -> uint64_t {
+    uint64_t word = 0;
+    std::memcpy(&word, ptr, len);
+    if constexpr (std::endian::native == std::endian::big)
+    {
+      word = std::byteswap(word);
+    }
+    return word;
+  };
+
+  uint64_t    state = seed ^ (bytes.size() * multiplier);
+  const char* ptr   = bytes.data();
+  size_t      len   = bytes.size();
+  for (; len >= sizeof(uint64_t); ptr += sizeof(uint64_t), len -= sizeof(uint64_t))
+  {
+    state ^= hash_mix(load(ptr, sizeof(uint64_t)));
+    state  = std::rotl(state, 27) * multiplier + HASH_SEED;
+  }
+  if (len > 0)
+  {
+    state ^= hash_mix(load(ptr, len) ^ (static_cast<uint64_t>(len) << 56U));
+  }
+  return hash_mix(state);
+}
+
+/* Types
+ ******************************************************************************/
+/** Incrementally hashes a sequence of fields, e.g. the members of a key struct.
+ * Field boundaries are significant: `{"ab", "c"}` and `{"a", "bc"}` hash differently.
+ */
+class Hasher {
+public:
+  constexpr explicit Hasher(uint64_t seed = HASH_SEED) noexcept
+    : _state{ seed }
+  {
+  }
+
+  auto add(std::string_view bytes) noexcept -> Hasher&
+  {
+    _state = hash_combine(_state, hash_bytes(bytes));
+    return *this;
+  }
+
+  constexpr auto add(uint64_t value) noexcept -> Hasher&
+  {
+    _state = hash_combine(_state, hash_mix(value));
+    return *this;
+  }
+
+  constexpr auto value() const noexcept -> uint64_t
+  {
+    return _state;
+  }
+
+private:
+  uint64_t _state;
+};
+
+/** For hash containers whose keys are already well-distributed 64-bit hashes. */
+struct IdentityHash {
+  constexpr auto operator()(uint64_t key) const noexcept -> size_t
+  {
+    return static_cast<size_t>(key);
+  }
+};
+
+/** Transparent string hash, so `std::string` keyed containers can be searched with a `std::string_view`. */
+struct StringHash {
+  using is_transparent = void;
+
+  auto operator()(std::string_view key) const noexcept -> size_t
+  {
+    return static_cast<size_t>(hash_bytes(key));
+  }
+};
+
+}  // namespace sharif
@@ -11,6 +11,7 @@
 // 3rd
 
 // local
+#include <sharif/util/slab_pool.hpp>
 
 // namespace
 namespace sharif {
@@ -22,8 +23,11 @@ namespace sharif {
  ******************************************************************************/
 /** Heap-allocated optional.
  * Use this type instead of `std::optional` when `T` is very large and often not active.
+ *
+ * @tparam Pool Provides storage for the value through static `allocate()`/`deallocate(ptr)`,
+ * e.g. `HeapPool<T>` or `SlabPool<T>`.
  */
-template <typename T>
+template <typename T, typename Pool = HeapPool<T>>
 class heap_optional {
 public:
   constexpr heap_optional() noexcept
@@ -37,17 +41,17 @@ public:
   }
 
   explicit(false) heap_optional(const T& value)
-    : _ptr{ new T(value) }
+    : _ptr{ create(value) }
   {
   }
 
   explicit(false) heap_optional(T&& value)
-    : _ptr{ new T(std::move(value)) }
+    : _ptr{ create(std::move(value)) }
   {
   }
 
   heap_optional(const heap_optional& other)
-    : _ptr{ (other._ptr) ? (new T(*other._ptr)) : (nullptr) }
+    : _ptr{ (other._ptr) ? (create(*other._ptr)) : (nullptr) }
   {
   }
 
@@ -58,7 +62,7 @@ public:
 
   ~heap_optional()
   {
-    delete _ptr;
+    destroy(_ptr);
   }
 
   auto operator=(const heap_optional& other) -> heap_optional&
@@ -66,7 +70,7 @@ public:
     if (this != &other)
     {
       heap_optional tmp{other};
-      std::swap(*this, tmp);
+      swap(tmp);
     }
     return *this;
   }
@@ -76,7 +80,7 @@ public:
     if (this != &other)
     {
       heap_optional tmp{std::move(other)};
-      std::swap(*this, tmp);
+      swap(tmp);
     }
     return *this;
   }
@@ -85,7 +89,7 @@ public:
   {
     if (_ptr == nullptr)
     {
-      _ptr = new T(value);
+      _ptr = create(value);
     }
     else
     {
@@ -98,7 +102,7 @@ public:
   {
     if (_ptr == nullptr)
     {
-      _ptr = new T(std::move(value));
+      _ptr = create(std::move(value));
     }
     else
     {
@@ -116,14 +120,15 @@ public:
   template <typename... Args>
   auto emplace(Args&&... args) -> T&
   {
-    heap_optional tmp{std::forward<Args>(args)...};
-    std::swap(*this, tmp);
+    T* ptr = create(std::forward<Args>(args)...);
+    destroy(_ptr);
+    _ptr = ptr;
     return *_ptr;
   }
 
   void reset() noexcept
   {
-    delete _ptr;
+    destroy(_ptr);
     _ptr = nullptr;
   }
 
@@ -173,27 +178,55 @@ public:
   }
 
 private:
+  template <typename... Args>
+  static auto create(Args&&... args) -> T*
+  {
+    void* storage = Pool::allocate();
+    try
+    {
+      return ::new (storage) T(std::forward<Args>(args)...);
+    }
+    catch (...)
+    {
+      Pool::deallocate(storage);
+      throw;
+    }
+  }
+
+  static auto destroy(T* ptr) noexcept -> void
+  {
+    if (ptr != nullptr)
+    {
+      ptr->~T();
+      Pool::deallocate(ptr);
+    }
+  }
+
   T* _ptr;
 };
 
+/// `heap_optional` whose values come from a per-thread slab instead of individual allocations.
+template <typename T>
+using pooled_optional = heap_optional<T, SlabPool<T>>;
+
 /* Functions
  ******************************************************************************/
-template <typename T>
-void swap(heap_optional<T>& lhs, heap_optional<T>& rhs) noexcept
+template <typename T, typename Pool>
+void swap(heap_optional<T, Pool>& lhs, heap_optional<T, Pool>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
 
-template <typename T, typename... Args>
-auto make_heap_optional(Args&&... args) -> heap_optional<T>
+template <typename T, typename Pool = HeapPool<T>, typename... Args>
+auto make_heap_optional(Args&&... args) -> heap_optional<T, Pool>
 {
-  heap_optional<T> ptr;
+  heap_optional<T, Pool> ptr;
   ptr.emplace(std::forward<Args>(args)...);
   return ptr;
 }
 
-template <typename T, typename U>
-auto operator==(const heap_optional<T>& lhs, const heap_optional<U>& rhs) -> bool
+template <typename T, typename P, typename U, typename Q>
+auto operator==(const heap_optional<T, P>& lhs, const heap_optional<U, Q>& rhs) -> bool
 {
   if (lhs.has_value() != rhs.has_value())
   {
@@ -206,56 +239,56 @@ auto operator==(const heap_optional<T>& lhs, const heap_optional<U>& rhs) -> boo
   return *lhs == *rhs;
 }
 
-template <typename T, typename U>
-auto operator!=(const heap_optional<T>& lhs, const heap_optional<U>& rhs) -> bool
+template <typename T, typename P, typename U, typename Q>
+auto operator!=(const heap_optional<T, P>& lhs, const heap_optional<U, Q>& rhs) -> bool
 {
   return !(lhs == rhs);
 }
 
-template <typename T>
-auto operator==(const heap_optional<T>& ptr, std::nullopt_t /* none */) noexcept -> bool
+template <typename T, typename P>
+auto operator==(const heap_optional<T, P>& ptr, std::nullopt_t /* none */) noexcept -> bool
 {
   return !ptr.has_value();
 }
 
-template <typename T>
-auto operator==(std::nullopt_t /* none */, const heap_optional<T>& ptr) noexcept -> bool
+template <typename T, typename P>
+auto operator==(std::nullopt_t /* none */, const heap_optional<T, P>& ptr) noexcept -> bool
 {
   return !ptr.has_value();
 }
 
-template <typename T>
-auto operator!=(const heap_optional<T>& ptr, std::nullopt_t /* none */) noexcept -> bool
+template <typename T, typename P>
+auto operator!=(const heap_optional<T, P>& ptr, std::nullopt_t /* none */) noexcept -> bool
 {
   return ptr.has_value();
 }
 
-template <typename T>
-auto operator!=(std::nullopt_t /* none */, const heap_optional<T>& ptr) noexcept -> bool
+template <typename T, typename P>
+auto operator!=(std::nullopt_t /* none */, const heap_optional<T, P>& ptr) noexcept -> bool
 {
   return ptr.has_value();
 }
 
-template <typename T, typename U>
-auto operator==(const heap_optional<T>& opt, const U& value) -> bool
+template <typename T, typename P, typename U>
+auto operator==(const heap_optional<T, P>& opt, const U& value) -> bool
 {
   return (opt.has_value()) && (*opt == value);
 }
 
-template <typename T, typename U>
-auto operator==(const T& value, const heap_optional<U>& opt) -> bool
+template <typename T, typename U, typename P>
+auto operator==(const T& value, const heap_optional<U, P>& opt) -> bool
 {
   return (opt.has_value()) && (value == *opt);
 }
 
-template <typename T, typename U>
-auto operator!=(const heap_optional<T>& opt, const U& value) -> bool
+template <typename T, typename P, typename U>
+auto operator!=(const heap_optional<T, P>& opt, const U& value) -> bool
 {
   return (!opt.has_value()) || (*opt != value);
 }
 
-template <typename T, typename U>
-auto operator!=(const T& value, const heap_optional<U>& opt) -> bool
+template <typename T, typename U, typename P>
+auto operator!=(const T& value, const heap_optional<U, P>& opt) -> bool
 {
   return (!opt.has_value()) || (value != *opt);
 }
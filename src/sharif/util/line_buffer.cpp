@@ -0,0 +1,108 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+// 3rd
+
+// local
+#include <sharif/util/line_buffer.hpp>
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+LineBuffer::LineBuffer(size_t capacity)
+  : _data{ std::make_unique_for_overwrite<char[]>(std::max<size_t>(capacity, 1)) }  // NOLINT(*-avoid-c-arrays)
+  , _capacity{ std::max<size_t>(capacity, 1) }
+{
+}
+
+auto LineBuffer::prepare(size_t min) -> std::span<char>
+{
+  if (_begin == _end)
+  {
+    _begin   = 0;
+    _scanned = 0;
+    _end     = 0;
+  }
+  if (_capacity - _end >= min)
+  {
+    return { _data.get() + _end, _capacity - _end };
+  }
+
+  // Move the partial line to the front, growing only if it leaves too little room
+  const auto unread   = _end - _begin;
+  const auto scanned  = _scanned - _begin;
+  const auto required = unread + min;
+  if (required > _capacity)
+  {
+    auto capacity = _capacity;
+    while (capacity < required)
+    {
+      capacity *= 2;
+    }
+    auto data = std::make_unique_for_overwrite<char[]>(capacity);  // NOLINT(*-avoid-c-arrays)
+    std::memcpy(data.get(), _data.get() + _begin, unread);
+    _data     = std::move(data);
+    _capacity = capacity;
+  }
+  else if (unread > 0)
+  {
+    std::memmove(_data.get(), _data.get() + _begin, unread);
+  }
+
+  _begin   = 0;
+  _scanned = scanned;
+  _end     = unread;
+  return { _data.get() + _end, _capacity - _end };
+}
+
+auto LineBuffer::commit(size_t count) noexcept -> void
+{
+  _end = std::min(_end + count, _capacity);
+}
+
+auto LineBuffer::lines() noexcept -> std::optional<std::string_view>
+{
+  // Bytes before `_scanned` were searched by an earlier call, so a long line is only scanned once
+  const auto from = _scanned;
+  const auto last = std::string_view{ _data.get() + from, _end - from }.rfind('\n');
+  _scanned        = _end;
+  if (last == std::string_view::npos)
+  {
+    return std::nullopt;
+  }
+
+  const auto begin = _begin;
+  const auto end   = from + last;
+  _begin           = end + 1;
+  return std::string_view{ _data.get() + begin, end - begin };
+}
+
+auto LineBuffer::rest() noexcept -> std::string_view
+{
+  const auto view = unread();
+  _begin          = _end;
+  _scanned        = _end;
+  return view;
+}
+
+auto LineBuffer::unread() const noexcept -> std::string_view
+{
+  return { _data.get() + _begin, _end - _begin };
+}
+
+auto LineBuffer::capacity() const noexcept -> size_t
+{
+  return _capacity;
+}
+
+}  // namespace sharif
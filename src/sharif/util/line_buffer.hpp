@@ -0,0 +1,64 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
+
+// 3rd
+
+// local
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Read buffer for line-oriented streams such as a child's stdout.
+ *
+ * Blocks are read straight into the buffer with `prepare()`/`commit()`, and `lines()` hands out
+ * every complete line in place. Only the trailing partial line stays behind; it is moved to the
+ * front once the free space runs low, and the buffer only grows for a line longer than itself.
+ */
+class LineBuffer {
+public:
+  static constexpr size_t DEFAULT_CAPACITY = size_t{ 64 } * 1024;
+
+  explicit LineBuffer(size_t capacity = DEFAULT_CAPACITY);
+
+  /** @returns free space after the unread bytes, of at least `min` bytes. */
+  auto prepare(size_t min = 1) -> std::span<char>;
+
+  /** Makes `count` bytes written to the space from `prepare()` readable. */
+  auto commit(size_t count) noexcept -> void;
+
+  /** Consumes every complete line.
+   * @returns the lines without their final newline, or `std::nullopt` if no line is complete.
+   * The view is valid until the next `prepare()`.
+   */
+  auto lines() noexcept -> std::optional<std::string_view>;
+
+  /** Consumes and returns whatever is left, such as a last line without a newline. */
+  auto rest() noexcept -> std::string_view;
+
+  /** @returns the unread bytes. */
+  auto unread() const noexcept -> std::string_view;
+
+  auto capacity() const noexcept -> size_t;
+
+private:
+  std::unique_ptr<char[]> _data;  // NOLINT(*-avoid-c-arrays) uninitialized storage
+  size_t                  _capacity;
+  size_t                  _begin{ 0 };    ///< First unread byte
+  size_t                  _scanned{ 0 };  ///< Bytes before this hold no newline after `_begin`
+  size_t                  _end{ 0 };      ///< One past the last readable byte
+};
+
+}  // namespace sharif
@@ -0,0 +1,175 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <utility>
+
+// 3rd
+#if defined(_WIN32) && !defined(__CYGWIN__)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+// local
+#include <sharif/util/log.hpp>
+#include <sharif/util/mapped_file.hpp>
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+MappedFile::MappedFile(MappedFile&& other) noexcept
+  : _data{ std::exchange(other._data, nullptr) }
+  , _size{ std::exchange(other._size, 0) }
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  , _mapping{ std::exchange(other._mapping, nullptr) }
+#endif
+{
+}
+
+auto MappedFile::operator=(MappedFile&& other) noexcept -> MappedFile&
+{
+  if (this != &other)
+  {
+    close();
+    _data = std::exchange(other._data, nullptr);
+    _size = std::exchange(other._size, 0);
+#if defined(_WIN32) && !defined(__CYGWIN__)
+    _mapping = std::exchange(other._mapping, nullptr);
+#endif
+  }
+  return *this;
+}
+
+MappedFile::~MappedFile()
+{
+  close();
+}
+
+#if defined(_WIN32) && !defined(__CYGWIN__)
+auto MappedFile::open(const fs::path& file) -> Result<MappedFile>
+{
+  HANDLE handle = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if (handle == INVALID_HANDLE_VALUE)
+  {
+    log::debug("Unable to open '{}'", file.string());
+    return Code::no_such_file_or_directory;
+  }
+
+  LARGE_INTEGER size{};
+  MappedFile    self;
+  if (GetFileSizeEx(handle, &size) == 0)
+  {
+    CloseHandle(handle);
+    return Code::io_error;
+  }
+  if (size.QuadPart == 0)
+  {
+    CloseHandle(handle);
+    return self;
+  }
+
+  self._mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  CloseHandle(handle);
+  if (self._mapping == nullptr)
+  {
+    return Code::io_error;
+  }
+
+  self._data = static_cast<const char*>(MapViewOfFile(self._mapping, FILE_MAP_READ, 0, 0, 0));
+  if (self._data == nullptr)
+  {
+    return Code::io_error;
+  }
+  self._size = static_cast<size_t>(size.QuadPart);
+  return self;
+}
+
+auto MappedFile::close() noexcept -> void
+{
+  if (_data != nullptr)
+  {
+    UnmapViewOfFile(_data);
+  }
+  if (_mapping != nullptr)
+  {
+    CloseHandle(_mapping);
+  }
+  _data    = nullptr;
+  _size    = 0;
+  _mapping = nullptr;
+}
+#else
+auto MappedFile::open(const fs::path& file) -> Result<MappedFile>
+{
+  const int fd = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);  // NOLINT(cppcoreguidelines-pro-type-vararg)
+  if (fd < 0)
+  {
+    log::debug("Unable to open '{}'", file.string());
+    return Code::no_such_file_or_directory;
+  }
+
+  struct stat info{};
+  MappedFile  self;
+  if (::fstat(fd, &info) != 0)
+  {
+    ::close(fd);
+    return Code::io_error;
+  }
+  if (info.st_size == 0)
+  {
+    ::close(fd);
+    return self;
+  }
+
+  void* data = ::mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED)  // NOLINT(cppcoreguidelines-pro-type-cstyle-cast)
+  {
+    return Code::io_error;
+  }
+  ::madvise(data, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+  self._data = static_cast<const char*>(data);
+  self._size = static_cast<size_t>(info.st_size);
+  return self;
+}
+
+auto MappedFile::close() noexcept -> void
+{
+  if (_data != nullptr)
+  {
+    ::munmap(const_cast<char*>(_data), _size);  // NOLINT(cppcoreguidelines-pro-type-const-cast)
+  }
+  _data = nullptr;
+  _size = 0;
+}
+#endif
+
+auto MappedFile::view() const noexcept -> std::string_view
+{
+  return { _data, _size };
+}
+
+auto MappedFile::data() const noexcept -> const char*
+{
+  return _data;
+}
+
+auto MappedFile::size() const noexcept -> size_t
+{
+  return _size;
+}
+
+}  // namespace sharif
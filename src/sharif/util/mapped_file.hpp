@@ -0,0 +1,51 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstddef>
+#include <string_view>
+
+// 3rd
+
+// local
+#include <sharif/util/filesystem.hpp>
+#include <sharif/util/result.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Read-only memory mapping of a whole file. Pages are loaded by the OS on access, so files
+ * larger than memory can be scanned without being read into a buffer first.
+ */
+class MappedFile {
+public:
+  MappedFile() noexcept = default;
+  MappedFile(MappedFile&& other) noexcept;
+  auto operator=(MappedFile&& other) noexcept -> MappedFile&;
+  MappedFile(const MappedFile&)                    = delete;
+  auto operator=(const MappedFile&) -> MappedFile& = delete;
+  ~MappedFile();
+
+  static auto open(const fs::path& file) -> Result<MappedFile>;
+
+  auto view() const noexcept -> std::string_view;
+  auto data() const noexcept -> const char*;
+  auto size() const noexcept -> size_t;
+
+private:
+  auto close() noexcept -> void;
+
+  const char* _data{ nullptr };
+  size_t      _size{ 0 };
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  void* _mapping{ nullptr };
+#endif
+};
+
+}  // namespace sharif
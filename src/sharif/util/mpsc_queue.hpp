@@ -0,0 +1,139 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+// 3rd
+
+// local
+#include <sharif/util/thread_pool.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Bounded, lock-free queue for many producers and a single consumer.
+ *
+ * Each slot carries a sequence number that says whose turn it is (Vyukov's bounded queue):
+ * producers claim a slot with one CAS on the tail and publish it with a release store, and the
+ * consumer reads the head without any read-modify-write at all. A full queue fails `try_push()`
+ * rather than blocking, so callers decide how to apply backpressure.
+ */
+template <typename T>
+class MpscQueue {
+public:
+  /** Holds at least `capacity` elements, rounded up to a power of two. */
+  explicit MpscQueue(size_t capacity)
+    : _mask{ std::bit_ceil(std::max<size_t>(capacity, 2)) - 1 }
+    , _slots{ std::make_unique<Slot[]>(_mask + 1) }  // NOLINT(*-avoid-c-arrays)
+  {
+    for (size_t i = 0; i <= _mask; ++i)
+    {
+      _slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  MpscQueue(const MpscQueue&)                    = delete;
+  MpscQueue(MpscQueue&&)                         = delete;
+  auto operator=(const MpscQueue&) -> MpscQueue& = delete;
+  auto operator=(MpscQueue&&) -> MpscQueue&      = delete;
+
+  ~MpscQueue()
+  {
+    while (try_pop())
+    {
+    }
+  }
+
+  /** Moves `value` into the queue; any thread. @returns false, leaving `value` alone, if full. */
+  auto try_push(T& value) -> bool
+  {
+    auto pos = _tail.load(std::memory_order_relaxed);
+    while (true)
+    {
+      auto&      slot = _slots[pos & _mask];
+      const auto seq  = slot.sequence.load(std::memory_order_acquire);
+      const auto diff = static_cast<std::ptrdiff_t>(seq - pos);
+      if (diff == 0)
+      {
+        if (_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+        {
+          std::construct_at(slot.get(), std::move(value));
+          slot.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      }
+      else if (diff < 0)
+      {
+        return false;
+      }
+      else
+      {
+        pos = _tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  auto try_push(T&& value) -> bool
+  {
+    return try_push(value);
+  }
+
+  /** Takes the oldest element; consumer thread only. */
+  auto try_pop() -> std::optional<T>
+  {
+    auto& slot = _slots[_head & _mask];
+    if (slot.sequence.load(std::memory_order_acquire) != _head + 1)
+    {
+      return std::nullopt;
+    }
+
+    std::optional<T> value{ std::move(*slot.get()) };
+    std::destroy_at(slot.get());
+    slot.sequence.store(_head + _mask + 1, std::memory_order_release);
+    ++_head;
+    return value;
+  }
+
+  /** @returns whether `try_pop()` would fail; consumer thread only. */
+  auto empty() const noexcept -> bool
+  {
+    return _slots[_head & _mask].sequence.load(std::memory_order_acquire) != _head + 1;
+  }
+
+  auto capacity() const noexcept -> size_t
+  {
+    return _mask + 1;
+  }
+
+private:
+  struct Slot {
+    auto get() noexcept -> T*
+    {
+      return std::launder(reinterpret_cast<T*>(storage));  // NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+    }
+
+    std::atomic<size_t> sequence;
+    alignas(T) std::byte storage[sizeof(T)];  // NOLINT(*-avoid-c-arrays)
+  };
+
+  size_t                                  _mask;
+  std::unique_ptr<Slot[]>                 _slots;  // NOLINT(*-avoid-c-arrays)
+  alignas(CACHE_LINE) std::atomic<size_t> _tail{ 0 };
+  alignas(CACHE_LINE) size_t              _head{ 0 };
+};
+
+}  // namespace sharif
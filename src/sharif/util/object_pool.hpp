@@ -0,0 +1,158 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// 3rd
+
+// local
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Recycles objects such as `std::string` or `Diagnostic` so their buffers are reused instead of
+ * reallocated, e.g. by a parser handing records to a writer that gives them back.
+ *
+ * Each thread keeps its own cache, so `take()` and `give()` take no lock. Objects often flow one
+ * way, taken on producer threads and given back on a consumer, so a cache that grows past two
+ * batches moves one batch to a shared depot, and an empty cache refills a batch from it. A
+ * thread's cache moves to the depot when the thread exits.
+ *
+ * Given objects are reset with `clear()` if `T` has one, keeping their capacity, and otherwise
+ * replaced with `T{}`.
+ */
+template <typename T>
+class ObjectPool {
+public:
+  /// Objects moved between a thread's cache and the depot at once.
+  static constexpr size_t BATCH = 32;
+
+  /// Batches the depot holds at most; objects given beyond that are freed.
+  static constexpr size_t DEPOT_BATCHES = 64;
+
+  /** @returns a recycled object, or `T{}` if there is none. */
+  static auto take() -> T
+  {
+    auto& local = cache();
+    if (local.objects.empty() && !refill(local))
+    {
+      return T{};
+    }
+    T object = std::move(local.objects.back());
+    local.objects.pop_back();
+    return object;
+  }
+
+  /** Resets `object` and keeps it for a later `take()`. */
+  static auto give(T&& object) -> void
+  {
+    if constexpr (requires { object.clear(); })
+    {
+      object.clear();
+    }
+    else
+    {
+      object = T{};
+    }
+
+    auto& local = cache();
+    if (local.objects.size() >= 2 * BATCH)
+    {
+      spill(local);
+    }
+    local.objects.push_back(std::move(object));
+  }
+
+  /** Frees the objects cached by the calling thread and the depot. */
+  static auto trim() -> void
+  {
+    cache().objects = {};
+    auto&           state = depot();
+    std::lock_guard lock{ state.mutex };
+    state.batches = {};
+  }
+
+private:
+  struct Cache {
+    std::vector<T> objects;
+
+    Cache() = default;
+    Cache(const Cache&)                    = delete;
+    auto operator=(const Cache&) -> Cache& = delete;
+
+    ~Cache()
+    {
+      while (!objects.empty())
+      {
+        spill(*this);
+      }
+    }
+  };
+
+  struct Depot {
+    std::mutex                  mutex;
+    std::vector<std::vector<T>> batches;
+  };
+
+  static auto cache() noexcept -> Cache&
+  {
+    thread_local Cache local;
+    return local;
+  }
+
+  static auto depot() noexcept -> Depot&
+  {
+    // Never destroyed: thread caches may still spill into it during shutdown
+    static auto* state = new Depot{};
+    return *state;
+  }
+
+  /** Moves up to one batch from the back of `local` to the depot. */
+  static auto spill(Cache& local) -> void
+  {
+    const auto     count = std::min(BATCH, local.objects.size());
+    std::vector<T> batch;
+    batch.reserve(BATCH);
+    std::move(local.objects.end() - static_cast<ptrdiff_t>(count), local.objects.end(), std::back_inserter(batch));
+    local.objects.resize(local.objects.size() - count);
+
+    // A full depot drops the batch, after the lock is released
+    auto&           state = depot();
+    std::lock_guard lock{ state.mutex };
+    if (state.batches.size() < DEPOT_BATCHES)
+    {
+      state.batches.push_back(std::move(batch));
+    }
+  }
+
+  static auto refill(Cache& local) -> bool
+  {
+    std::vector<T> batch;
+    {
+      auto&           state = depot();
+      std::lock_guard lock{ state.mutex };
+      if (state.batches.empty())
+      {
+        return false;
+      }
+      batch = std::move(state.batches.back());
+      state.batches.pop_back();
+    }
+    local.objects = std::move(batch);
+    return true;
+  }
+};
+
+}  // namespace sharif
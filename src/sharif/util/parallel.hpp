@@ -0,0 +1,78 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 3rd
+
+// local
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+/** Calls `fn(i)` for every `i` in `[0, count)` using up to `jobs` threads (including the caller).
+ *
+ * Indices are handed out in ascending order as threads become free, so sorting the work
+ * longest-first beforehand yields longest-processing-time-first scheduling.
+ * The first exception thrown by `fn` stops further indices from being handed out and is
+ * rethrown once all threads have finished.
+ */
+template <typename Fn>
+auto parallel_for(size_t count, unsigned jobs, Fn&& fn) -> void
+{
+  if (count == 0)
+  {
+    return;
+  }
+
+  const auto threads = std::clamp<size_t>(jobs, 1, count);
+
+  std::atomic<size_t> next{ 0 };
+  std::exception_ptr  error;
+  std::once_flag      failed;
+
+  auto worker = [&]() -> void {
+    for (auto i = next.fetch_add(1, std::memory_order_relaxed); i < count; i = next.fetch_add(1, std::memory_order_relaxed))
+    {
+      try
+      {
+        fn(i);
+      }
+      catch (...)
+      {
+        std::call_once(failed, [&error]() { error = std::current_exception(); });
+        next.store(count, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  {
+    std::vector<std::jthread> pool;
+    pool.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i)
+    {
+      pool.emplace_back(worker);
+    }
+    worker();
+  }
+
+  if (error)
+  {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace sharif
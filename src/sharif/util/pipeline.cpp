@@ -0,0 +1,96 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// 3rd
+
+// local
+#include <sharif/util/pipeline.hpp>
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+Pipeline::Pipeline(ThreadPool& pool, size_t capacity)
+  : _pool{ &pool }
+  , _capacity{ capacity }
+{
+}
+
+Pipeline::~Pipeline()
+{
+  try
+  {
+    wait();
+  }
+  catch (...)  // NOLINT(bugprone-empty-catch)
+  {
+  }
+}
+
+auto Pipeline::wait() -> void
+{
+  if (_pool->is_worker())
+  {
+    // Blocking a worker could leave no thread to run the stages
+    while (true)
+    {
+      {
+        std::lock_guard lock{ _mutex };
+        if (_running == 0)
+        {
+          break;
+        }
+      }
+      if (!_pool->run_one())
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  std::unique_lock lock{ _mutex };
+  _done.wait(lock, [this] { return _running == 0; });
+  if (_error)
+  {
+    std::rethrow_exception(std::exchange(_error, nullptr));
+  }
+}
+
+auto Pipeline::fail(std::exception_ptr error) -> void
+{
+  std::lock_guard lock{ _mutex };
+  if (!_failed.exchange(true, std::memory_order_release))
+  {
+    _error = std::move(error);
+  }
+}
+
+auto Pipeline::failed() const noexcept -> bool
+{
+  return _failed.load(std::memory_order_acquire);
+}
+
+auto Pipeline::pool() const noexcept -> ThreadPool&
+{
+  return *_pool;
+}
+
+auto Pipeline::finished() -> void
+{
+  // Notified under the lock: once `_running` hits zero `wait()` may return and destroy us
+  std::lock_guard lock{ _mutex };
+  --_running;
+  _done.notify_all();
+}
+
+}  // namespace sharif
@@ -0,0 +1,267 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/util/mpsc_queue.hpp>
+#include <sharif/util/thread_pool.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+class Pipeline;
+
+namespace detail {
+/// What `Pipeline` needs to own a node without knowing its element type.
+class PipelineNode {
+public:
+  PipelineNode()                                       = default;
+  PipelineNode(const PipelineNode&)                    = delete;
+  PipelineNode(PipelineNode&&)                         = delete;
+  auto operator=(const PipelineNode&) -> PipelineNode& = delete;
+  auto operator=(PipelineNode&&) -> PipelineNode&      = delete;
+  virtual ~PipelineNode()                              = default;
+};
+}  // namespace detail
+
+/** The input of one pipeline stage: a bounded queue and the function that consumes it.
+ *
+ * Any number of producers may push, from pool threads or from outside, e.g. from a `Process`
+ * output callback. The stage runs on the pool only while it has input, one item at a time, so a
+ * stage function never runs concurrently with itself. Each producer `close()`s its side when
+ * done; once all have and the queue is drained, the stage finishes and closes its own output.
+ */
+template <typename T>
+class Node final : public detail::PipelineNode {
+public:
+  using Consume = std::move_only_function<void(T&&)>;
+  using Finish  = std::move_only_function<void()>;
+
+  Node(Pipeline& pipeline, size_t capacity, Consume consume, Finish finish);
+
+  /** Queues `value`, waiting while the queue is full. A waiting pool thread runs other jobs,
+   * normally this stage's, so the pool cannot fill up with blocked producers.
+   * @returns false if the pipeline failed and `value` was dropped.
+   */
+  auto push(T value) -> bool;
+
+  /** Registers another producer; each producer must call `close()` once. A node starts with one. */
+  auto open() -> void
+  {
+    _state.fetch_add(PRODUCER, std::memory_order_relaxed);
+  }
+
+  /** Ends one producer's input. The node may be gone by the time this returns. */
+  auto close() -> void;
+
+private:
+  /// `_state` counts producers in the high half and signals not yet seen by `drain()` in the low.
+  static constexpr uint64_t SIGNAL   = 1;
+  static constexpr uint64_t PRODUCER = uint64_t{ 1 } << 32U;
+
+  static constexpr auto pending(uint64_t state) noexcept -> uint64_t
+  {
+    return state & (PRODUCER - 1);
+  }
+
+  auto drain() -> void;
+
+  Pipeline*             _pipeline;
+  MpscQueue<T>          _queue;
+  Consume               _consume;
+  Finish                _finish;
+  std::atomic<uint64_t> _state{ PRODUCER };
+};
+
+/** A graph of stages connected by bounded queues and run on a `ThreadPool`.
+ *
+ * Stages are built back to front, each given the node it feeds:
+ *
+ * @code
+ * Pipeline pipeline{ pool };
+ * auto& write = pipeline.sink<Diagnostic>([&](Diagnostic&& diagnostic) { ... });
+ * auto& parse = pipeline.stage<std::string>(write, [](std::string&& lines, Node<Diagnostic>& out) { ... });
+ * parse.push(...);
+ * parse.close();
+ * pipeline.wait();
+ * @endcode
+ *
+ * Every stage works concurrently with the others, and a full queue slows its producers down
+ * rather than growing. The first exception thrown by a stage fails the pipeline: later input is
+ * dropped, the end of stream still flows through every stage, and `wait()` rethrows it.
+ */
+class Pipeline {
+public:
+  /** Stages are run on `pool`, each queue holding about `capacity` items. */
+  explicit Pipeline(ThreadPool& pool, size_t capacity = 1024);
+  Pipeline(const Pipeline&)                    = delete;
+  Pipeline(Pipeline&&)                         = delete;
+  auto operator=(const Pipeline&) -> Pipeline& = delete;
+  auto operator=(Pipeline&&) -> Pipeline&      = delete;
+
+  /** Waits for every stage to finish, discarding any error. */
+  ~Pipeline();
+
+  /** Adds a terminal stage calling `fn(T&&)` for each item. */
+  template <typename T, typename Fn>
+  auto sink(Fn&& fn) -> Node<T>&
+  {
+    return add<T>(std::forward<Fn>(fn), [] {});
+  }
+
+  /** Adds a stage calling `fn(T&&, next)` for each item; it may push any number of items to
+   * `next`, and closes it when the stage's own input ends.
+   */
+  template <typename T, typename U, typename Fn>
+  auto stage(Node<U>& next, Fn&& fn) -> Node<T>&
+  {
+    return add<T>([fn = std::forward<Fn>(fn), &next](T&& value) mutable { fn(std::move(value), next); }, [&next] { next.close(); });
+  }
+
+  /** Blocks until every stage has finished. @throws the first exception a stage threw. */
+  auto wait() -> void;
+
+  /** Fails the pipeline with `error` unless it already failed. */
+  auto fail(std::exception_ptr error) -> void;
+
+  auto failed() const noexcept -> bool;
+  auto pool() const noexcept -> ThreadPool&;
+
+private:
+  template <typename>
+  friend class Node;
+
+  template <typename T, typename Consume>
+  auto add(Consume&& consume, typename Node<T>::Finish finish) -> Node<T>&
+  {
+    std::lock_guard lock{ _mutex };
+    auto            node = std::make_unique<Node<T>>(*this, _capacity, std::forward<Consume>(consume), std::move(finish));
+    auto&           ref  = *node;
+    _nodes.push_back(std::move(node));
+    ++_running;
+    return ref;
+  }
+
+  /** Called by each node once its input has ended and it has closed its output. */
+  auto finished() -> void;
+
+  ThreadPool*                                        _pool;
+  size_t                                             _capacity;
+  std::vector<std::unique_ptr<detail::PipelineNode>> _nodes;
+  std::mutex                                         _mutex;
+  std::condition_variable                            _done;
+  size_t                                             _running{ 0 };
+  std::exception_ptr                                 _error;
+  std::atomic<bool>                                  _failed{ false };
+};
+
+/* Functions
+ ******************************************************************************/
+template <typename T>
+Node<T>::Node(Pipeline& pipeline, size_t capacity, Consume consume, Finish finish)
+  : _pipeline{ &pipeline }
+  , _queue{ capacity }
+  , _consume{ std::move(consume) }
+  , _finish{ std::move(finish) }
+{
+}
+
+template <typename T>
+auto Node<T>::push(T value) -> bool
+{
+  auto& pool = _pipeline->pool();
+  while (!_queue.try_push(value))
+  {
+    // A full queue already has a `drain()` queued or running; help it along
+    if (_pipeline->failed())
+    {
+      return false;
+    }
+    if (!pool.is_worker() || !pool.run_one())
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  // Whoever takes the signal count from zero starts the only `drain()`, so the queue keeps a
+  // single consumer
+  if (pending(_state.fetch_add(SIGNAL, std::memory_order_acq_rel)) == 0)
+  {
+    pool.post([this] { drain(); });
+  }
+  return true;
+}
+
+template <typename T>
+auto Node<T>::close() -> void
+{
+  // Dropping the producer and signalling is one step: once it lands the stage may finish and
+  // the pipeline be destroyed, so nothing of this node may be touched afterwards
+  auto& pool = _pipeline->pool();
+  if (pending(_state.fetch_sub(PRODUCER - SIGNAL, std::memory_order_acq_rel)) == 0)
+  {
+    pool.post([this] { drain(); });
+  }
+}
+
+template <typename T>
+auto Node<T>::drain() -> void
+{
+  auto state = _state.load(std::memory_order_acquire);
+  while (true)
+  {
+    while (auto value = _queue.try_pop())
+    {
+      if (_pipeline->failed())
+      {
+        continue;
+      }
+      try
+      {
+        _consume(std::move(*value));
+      }
+      catch (...)
+      {
+        _pipeline->fail(std::current_exception());
+      }
+    }
+
+    // Every producer pushes before it closes, so with none left no more input can arrive
+    if (state < PRODUCER && _queue.empty())
+    {
+      _finish();
+      _pipeline->finished();
+      return;
+    }
+
+    // Signals that arrived while draining keep this job going; otherwise the next push starts anew
+    const auto seen = pending(state);
+    state           = _state.fetch_sub(seen, std::memory_order_acq_rel) - seen;
+    if (pending(state) == 0)
+    {
+      return;
+    }
+  }
+}
+
+}  // namespace sharif
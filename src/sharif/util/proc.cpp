@@ -1,12 +1,17 @@
 /** @file
  *
  ******************************************************************************/
-// TODO: Use uvw instead?
 
 /* Includes
  ******************************************************************************/
 // std
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
 #include <memory>
+#include <optional>
 #include <ranges>
 #include <string_view>
 #include <vector>
@@ -15,18 +20,34 @@
 #include <au/au.hh>
 #include <au/quantity.hh>
 #include <au/units/bytes.hh>
-#include <boost/asio/error.hpp>
+#include <boost/asio/buffer.hpp>
+#include <boost/asio/executor_work_guard.hpp>
 #include <boost/asio/io_context.hpp>
-#include <boost/asio/read_until.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/readable_pipe.hpp>
-#include <boost/process/v2/environment.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/process/v2/default_launcher.hpp>
 #include <boost/process/v2/process.hpp>
 #include <boost/process/v2/start_dir.hpp>
 #include <boost/process/v2/stdio.hpp>
 #include <boost/system/detail/error_code.hpp>
 #include <spdlog/spdlog.h>
+#if !defined(_WIN32) || defined(__CYGWIN__)
+#  include <boost/asio/posix/stream_descriptor.hpp>
+#  include <csignal>
+#  include <fcntl.h>
+#  include <spawn.h>
+#  include <sys/resource.h>
+#  include <sys/syscall.h>
+#  include <sys/wait.h>
+#  include <unistd.h>
+#endif
 
 // local
+#include <sharif/util/detail/proc_uv.hpp>
+#include <sharif/util/detail/resumer.hpp>
+#include <sharif/util/executable.hpp>
+#include <sharif/util/line_buffer.hpp>
 #include <sharif/util/proc.hpp>
 
 // namespace
@@ -61,62 +82,270 @@ void collect_text(void* ptr, std::string_view chunk)
  ******************************************************************************/
 using KiB = unit::Kibi<unit::Bytes>;
 
+/// Smallest read handed to the pipe; less free space than this compacts the buffer first.
+constexpr auto MIN_READ = unit::make_quantity<KiB, uint32_t>(4);
+
+namespace {
+std::atomic<Process::Backend> default_process_backend{
+#ifdef SHARIF_PROCESS_UVW
+  Process::Backend::UVW
+#else
+  Process::Backend::ASIO
+#endif
+};
+}  // namespace
+
 /* Types
  ******************************************************************************/
+#if !defined(_WIN32) || defined(__CYGWIN__)
+/// Applies the `RLIMIT_*` parts of `Process::Limits` in the child, between fork and exec.
+struct ResourceLimits {
+  template <typename Launcher, typename... Args>
+  auto on_exec_setup(Launcher& /*launcher*/, Args&&... /*args*/) const -> sys::error_code
+  {
+    auto set = [](int resource, rlim_t soft, rlim_t hard) {
+      const rlimit limit{ .rlim_cur = soft, .rlim_max = hard };
+      return ::setrlimit(resource, &limit) == 0;
+    };
+
+    // The soft CPU limit raises SIGXCPU; the hard one a second later kills a child that ignores it
+    const bool ok = ((limits->address_space == 0) || set(RLIMIT_AS, limits->address_space, limits->address_space))
+                 && ((limits->cpu_time == 0) || set(RLIMIT_CPU, limits->cpu_time, limits->cpu_time + 1));
+    return (ok) ? (sys::error_code{}) : (sys::error_code{ errno, sys::system_category() });
+  }
+
+  const Process::Limits* limits;  // NOLINT(misc-non-private-member-variables-in-classes)
+};
+#endif
+
 struct OutPipe {
   explicit OutPipe(asio::io_context& ctx)
     : pipe{ ctx }
+    , buffer{ unit::make_quantity<KiB, uint32_t>(64).in(unit::bytes) }
+  {
+  }
+
+  auto deliver(std::string_view lines) const -> void
+  {
+    log::trace("{}", lines);
+    if (callback != nullptr)
+    {
+      callback(context, lines);
+    }
+  }
+
+  auto set(Process::on_output lines, Process::on_chunk raw, void* ctx) -> void
   {
-    auto cap = unit::make_quantity<KiB, uint32_t>(4);
-    buffer.reserve(cap.in(unit::bytes));
+    callback = lines;
+    chunks   = raw;
+    context  = ctx;
+  }
+
+  auto to_uv() -> detail::UvOutput
+  {
+    return { .lines = callback, .chunks = chunks, .context = context, .resumer = &resumer };
   }
 
   asio::readable_pipe pipe;                 // NOLINT(misc-non-private-member-variables-in-classes)
   Process::on_output  callback{ nullptr };  // NOLINT(misc-non-private-member-variables-in-classes)
-  std::string         buffer;               // NOLINT(misc-non-private-member-variables-in-classes)
+  Process::on_chunk   chunks{ nullptr };    // NOLINT(misc-non-private-member-variables-in-classes)
+  LineBuffer          buffer;               // NOLINT(misc-non-private-member-variables-in-classes)
   void*               context{ nullptr };   // NOLINT(misc-non-private-member-variables-in-classes)
+  detail::Resumer     resumer;              // NOLINT(misc-non-private-member-variables-in-classes)
 };
 
 struct Process::Impl {
-  asio::io_context                        ctx;             // NOLINT(misc-non-private-member-variables-in-classes)
-  OutPipe                                 std_out{ ctx };  // NOLINT(misc-non-private-member-variables-in-classes)
-  OutPipe                                 std_err{ ctx };  // NOLINT(misc-non-private-member-variables-in-classes)
-  std::string                             exe;             // NOLINT(misc-non-private-member-variables-in-classes)
-  std::vector<std::string>                args;            // NOLINT(misc-non-private-member-variables-in-classes)
-  std::flat_map<std::string, std::string> env{};           // NOLINT(misc-non-private-member-variables-in-classes)
-  std::string                             pwd;             // NOLINT(misc-non-private-member-variables-in-classes)
+  asio::io_context                        ctx;                           // NOLINT(misc-non-private-member-variables-in-classes)
+  OutPipe                                 std_out{ ctx };                // NOLINT(misc-non-private-member-variables-in-classes)
+  OutPipe                                 std_err{ ctx };                // NOLINT(misc-non-private-member-variables-in-classes)
+  std::string                             exe;                           // NOLINT(misc-non-private-member-variables-in-classes)
+  std::vector<std::string>                args;                          // NOLINT(misc-non-private-member-variables-in-classes)
+  std::flat_map<std::string, std::string> env{};                         // NOLINT(misc-non-private-member-variables-in-classes)
+  std::string                             pwd;                           // NOLINT(misc-non-private-member-variables-in-classes)
+  Backend                                 backend{ default_backend() };  // NOLINT(misc-non-private-member-variables-in-classes)
+  Limits                                  limits;                        // NOLINT(misc-non-private-member-variables-in-classes)
+  Stats                                   stats;                         // NOLINT(misc-non-private-member-variables-in-classes)
+  asio::steady_timer                      deadline{ ctx };               // NOLINT(misc-non-private-member-variables-in-classes)
+  uint32_t                                open_pipes{ 0 };               // NOLINT(misc-non-private-member-variables-in-classes)
+  bool                                    watching{ false };             // NOLINT(misc-non-private-member-variables-in-classes)
+  std::vector<char*>                      spawn_argv;                    // NOLINT(misc-non-private-member-variables-in-classes)
+  std::vector<std::string>                spawn_env;                     // NOLINT(misc-non-private-member-variables-in-classes)
+  std::vector<char*>                      spawn_envp;                    // NOLINT(misc-non-private-member-variables-in-classes)
+
+  auto run_asio() -> int32_t;
+  auto run_spawn() -> int32_t;
+  auto run_uv() -> int32_t;
 
+  /** Reads blocks into the pipe's buffer and delivers the complete lines of each in place. */
   auto async_read(OutPipe& out) -> void
   {
-    asio::async_read_until(
-      out.pipe,
-      asio::dynamic_buffer(out.buffer),
-      '\n',
-      [this, &out](const sys::error_code& err, std::size_t) {
-        if (err || err == asio::error::eof || err == asio::error::broken_pipe)
+    const auto space = out.buffer.prepare(MIN_READ.in(unit::bytes));
+    out.pipe.async_read_some(asio::buffer(space.data(), space.size()), [this, &out](const sys::error_code& err, std::size_t count) {
+      out.buffer.commit(count);
+      if (out.chunks != nullptr)
+      {
+        if (count != 0 && out.chunks(out.context, out.buffer.rest()) == Flow::PAUSE && !err)
         {
-          log::trace("EOF");
+          pause(out);
           return;
         }
+      }
+      else if (auto lines = out.buffer.lines(); lines)
+      {
+        out.deliver(*lines);
+      }
+
+      if (err)
+      {
+        // EOF or a broken pipe; a last line without a newline is still output
+        if (auto rest = out.buffer.rest(); !rest.empty())
+        {
+          out.deliver(rest);
+        }
+        log::trace("EOF");
+        if (--open_pipes == 0 && !watching)
+        {
+          // Nothing tells us when the child exits, so the deadline only covers its output
+          deadline.cancel();
+        }
+        return;
+      }
+      this->async_read(out);
+    });
+  }
+
+  /** Stops reading `out` until its consumer resumes it; the chunk it holds is left untouched. */
+  auto pause(OutPipe& out) -> void
+  {
+    // Without outstanding reads `ctx.run()` would return, so hold it open while paused
+    out.resumer.pause([this, &out, guard = asio::make_work_guard(ctx)]() mutable {
+      asio::post(ctx, [this, &out, guard = std::move(guard)]() mutable {
+        guard.reset();
+        async_read(out);
+      });
+    });
+  }
 
-        auto end  = out.buffer.rfind('\n');
-        auto view = std::string_view{ out.buffer.c_str(), end };
-        log::trace("{}", view);
-        out.callback(out.context, view);
+  /** Sends `stop` SIGTERM once the timeout passes and SIGKILL after the grace period. */
+  template <typename Stop>
+  auto start_deadline(Stop stop) -> void
+  {
+    if (limits.timeout.count() == 0)
+    {
+      return;
+    }
 
-        out.buffer = out.buffer.substr(end + sizeof('\n'));
-        this->async_read(out);
+    deadline.expires_after(limits.timeout);
+    deadline.async_wait([this, stop](const sys::error_code& err) {
+      if (err)
+      {
+        return;
       }
-    );
+      log::warn("'{}' timed out after {}ms", exe, limits.timeout.count());
+      stats.timed_out = true;
+      stop(false);
+
+      deadline.expires_after(limits.grace);
+      deadline.async_wait([stop](const sys::error_code& err) {
+        if (!err)
+        {
+          stop(true);
+        }
+      });
+    });
   }
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+  /** Reaps `pid` with `wait4`, recording its resource usage. @returns its exit code, or `128 + signal`. */
+  auto reap(pid_t pid) -> int32_t
+  {
+    int    status = 0;
+    rusage usage{};
+    while (::wait4(pid, &status, 0, &usage) < 0)
+    {
+      if (errno != EINTR)
+      {
+        log::error("wait4 failed for '{}': {}", exe, std::strerror(errno));
+        return -1;
+      }
+    }
+
+    using std::chrono::microseconds;
+    using std::chrono::seconds;
+    stats.user_time            = seconds{ usage.ru_utime.tv_sec } + microseconds{ usage.ru_utime.tv_usec };
+    stats.system_time          = seconds{ usage.ru_stime.tv_sec } + microseconds{ usage.ru_stime.tv_usec };
+    stats.voluntary_switches   = static_cast<uint64_t>(usage.ru_nvcsw);
+    stats.involuntary_switches = static_cast<uint64_t>(usage.ru_nivcsw);
+#  if defined(__APPLE__)
+    stats.max_rss = static_cast<uint64_t>(usage.ru_maxrss);
+#  else
+    stats.max_rss = unit::make_quantity<KiB>(static_cast<uint64_t>(usage.ru_maxrss)).in(unit::bytes);
+#  endif
+
+    if (WIFSIGNALED(status))
+    {
+      stats.signal = WTERMSIG(status);
+      return 128 + stats.signal;
+    }
+    return WEXITSTATUS(status);
+  }
+
+  /** Reaps `pid` as soon as it exits, ending the deadline with it, if the kernel offers a pidfd.
+   * Otherwise the caller reaps it after the pipes close.
+   */
+  auto watch_exit(pid_t pid, std::optional<int32_t>& code) -> void
+  {
+#  if defined(__linux__) && defined(SYS_pidfd_open)
+    const auto fd = static_cast<int>(::syscall(SYS_pidfd_open, pid, 0));
+    if (fd < 0)
+    {
+      return;
+    }
+
+    auto pidfd = std::make_shared<asio::posix::stream_descriptor>(ctx, fd);
+    watching   = true;
+    pidfd->async_wait(asio::posix::stream_descriptor::wait_read, [this, pid, pidfd, &code](const sys::error_code&) {
+      code = reap(pid);
+      deadline.cancel();
+      pidfd->close();
+    });
+#  else
+    (void)pid;
+    (void)code;
+#  endif
+  }
+
+  /** Reads the child's output until it exits or the deadline ends it. @returns its exit code. */
+  auto supervise(pid_t pid) -> int32_t
+  {
+    start_deadline([pid](bool kill) { ::kill(pid, (kill) ? (SIGKILL) : (SIGTERM)); });
+
+    std::optional<int32_t> code;
+    watch_exit(pid, code);
+    async_read(std_out);
+    async_read(std_err);
+    ctx.run();
+    return (code) ? (*code) : (reap(pid));
+  }
+#endif
 };
 
 /* Functions
  ******************************************************************************/
+auto Process::default_backend() noexcept -> Backend
+{
+  return default_process_backend.load(std::memory_order_relaxed);
+}
+
+auto Process::set_default_backend(Backend backend) noexcept -> void
+{
+  default_process_backend.store(backend, std::memory_order_relaxed);
+}
+
 Process::Process(std::string_view executable)
   : _self{ std::make_unique<Process::Impl>() }
 {
-  _self->exe = proc::environment::find_executable(executable).string();
+  _self->exe = find_executable(executable);
   _self->pwd = std::filesystem::current_path().string();
 }
 
@@ -141,12 +370,15 @@ auto Process::args() const noexcept -> const std::vector<std::string>&
 auto Process::with_args(std::vector<std::string> arguments) -> Process&
 {
   _self->args = std::move(arguments);
+  _self->spawn_argv.clear();
   return *this;
 }
 
 auto Process::with_env(std::flat_map<std::string, std::string> environment) -> Process&
 {
   _self->env = std::move(environment);
+  _self->spawn_env.clear();
+  _self->spawn_envp.clear();
   return *this;
 }
 
@@ -156,41 +388,242 @@ auto Process::with_pwd(std::string directory) -> Process&
   return *this;
 }
 
+auto Process::with_backend(Backend backend) -> Process&
+{
+  _self->backend = backend;
+  return *this;
+}
+
+auto Process::with_limits(Limits limits) -> Process&
+{
+  _self->limits = limits;
+  return *this;
+}
+
+auto Process::stats() const noexcept -> const Stats&
+{
+  return _self->stats;
+}
+
 auto Process::on_stdout(on_output callback, void* context) -> void
 {
-  _self->std_out.callback = callback;
-  _self->std_out.context  = context;
+  _self->std_out.set(callback, nullptr, context);
 }
 
 auto Process::on_stderr(on_output callback, void* context) -> void
 {
-  _self->std_err.callback = callback;
-  _self->std_err.context  = context;
+  _self->std_err.set(callback, nullptr, context);
+}
+
+auto Process::on_stdout_chunks(on_chunk callback, void* context) -> void
+{
+  _self->std_out.set(nullptr, callback, context);
+}
+
+auto Process::on_stderr_chunks(on_chunk callback, void* context) -> void
+{
+  _self->std_err.set(nullptr, callback, context);
+}
+
+auto Process::resume_stdout() -> void
+{
+  _self->std_out.resumer.resume();
+}
+
+auto Process::resume_stderr() -> void
+{
+  _self->std_err.resumer.resume();
 }
 
 auto Process::run() -> int32_t
 {
   log::debug("{} {}", _self->exe, _self->args | std::views::join_with(' ') | std::ranges::to<std::string>());
-  proc::process child(
-    _self->ctx,
-    _self->exe,
-    _self->args,
-    proc::process_stdio{
-      .in  = {},
-      .out = _self->std_out.pipe,
-      .err = _self->std_err.pipe,
+  _self->std_out.resumer.reset();
+  _self->std_err.resumer.reset();
+  _self->stats = {};
+
+  const auto start = std::chrono::steady_clock::now();
+  const auto code  = [&] {
+    switch (_self->backend)
+    {
+      case Backend::UVW:
+        return _self->run_uv();
+      case Backend::SPAWN:
+        return _self->run_spawn();
+      case Backend::ASIO:
+        break;
+    }
+    return _self->run_asio();
+  }();
+  _self->stats.wall_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+
+  log::trace("exit: {} {}", code, _self->stats);
+  return code;
+}
+
+auto Process::Impl::run_uv() -> int32_t
+{
+  // libuv cannot set resource limits in the child either, so leave those to Boost.Process
+  if (limits.address_space != 0 || limits.cpu_time != 0)
+  {
+    return run_asio();
+  }
+
+  return detail::uv_run(
+    {
+      .exe     = exe,
+      .args    = &args,
+      .env     = &env,
+      .pwd     = pwd,
+      .std_out = std_out.to_uv(),
+      .std_err = std_err.to_uv(),
+      .timeout = limits.timeout,
+      .grace   = limits.grace,
     },
-    proc::process_start_dir(_self->pwd),
-    proc::process_environment(_self->env)
+    stats
   );
+}
 
-  _self->async_read(_self->std_out);
-  _self->async_read(_self->std_err);
-  _self->ctx.run();
-  child.wait();
+auto Process::Impl::run_asio() -> int32_t
+{
+  ctx.restart();
+  open_pipes = 2;
+  watching   = false;
 
-  log::trace("exit: {}", child.exit_code());
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  sys::error_code error;
+  auto            child = proc::default_process_launcher()(
+    ctx,
+    error,
+    exe,
+    args,
+    proc::process_stdio{ .in = {}, .out = std_out.pipe, .err = std_err.pipe },
+    proc::process_start_dir(pwd),
+    proc::process_environment(env)
+  );
+  if (error)
+  {
+    log::error("Failed to start '{}': {}", exe, error.message());
+    return -1;
+  }
+  start_deadline([&child](bool /*kill*/) { child.terminate(); });
+
+  async_read(std_out);
+  async_read(std_err);
+  ctx.run();
+  child.wait();
   return child.exit_code();
+#else
+  sys::error_code error;
+  auto            child = proc::default_process_launcher()(
+    ctx,
+    error,
+    exe,
+    args,
+    proc::process_stdio{ .in = {}, .out = std_out.pipe, .err = std_err.pipe },
+    proc::process_start_dir(pwd),
+    proc::process_environment(env),
+    ResourceLimits{ .limits = &limits }
+  );
+  if (error)
+  {
+    log::error("Failed to start '{}': {}", exe, error.message());
+    return -1;
+  }
+
+  // Reaped with wait4 rather than by Boost.Process, which would discard its resource usage
+  const auto pid = static_cast<pid_t>(child.id());
+  child.detach();
+  return supervise(pid);
+#endif
+}
+
+auto Process::Impl::run_spawn() -> int32_t
+{
+#if defined(__linux__)
+  // posix_spawn cannot set resource limits in the child, so leave those to Boost.Process
+  if (limits.address_space != 0 || limits.cpu_time != 0)
+  {
+    return run_asio();
+  }
+
+  ctx.restart();
+  open_pipes = 2;
+  watching   = false;
+
+  if (spawn_argv.empty())
+  {
+    spawn_argv.reserve(args.size() + 2);
+    spawn_argv.push_back(exe.data());
+    for (auto& arg : args)
+    {
+      spawn_argv.push_back(arg.data());
+    }
+    spawn_argv.push_back(nullptr);
+  }
+  if (spawn_envp.empty() && !env.empty())
+  {
+    spawn_env.reserve(env.size());
+    for (const auto& [key, value] : env)
+    {
+      spawn_env.push_back(key + '=' + value);
+    }
+    for (auto& entry : spawn_env)
+    {
+      spawn_envp.push_back(entry.data());
+    }
+    spawn_envp.push_back(nullptr);
+  }
+
+  // Both ends close on exec; dup2 onto stdout and stderr clears the flag for the child's copies
+  std::array<int, 2> out{ -1, -1 };
+  std::array<int, 2> err{ -1, -1 };
+  if (::pipe2(out.data(), O_CLOEXEC) != 0 || ::pipe2(err.data(), O_CLOEXEC) != 0)
+  {
+    log::error("Failed to create pipes for '{}': {}", exe, std::strerror(errno));
+    for (const auto fd : { out[0], out[1], err[0], err[1] })
+    {
+      if (fd >= 0)
+      {
+        ::close(fd);
+      }
+    }
+    return -1;
+  }
+
+  posix_spawn_file_actions_t actions;
+  ::posix_spawn_file_actions_init(&actions);
+  ::posix_spawn_file_actions_adddup2(&actions, out[1], STDOUT_FILENO);
+  ::posix_spawn_file_actions_adddup2(&actions, err[1], STDERR_FILENO);
+  ::posix_spawn_file_actions_addchdir_np(&actions, pwd.c_str());
+
+  pid_t      pid   = 0;
+  char**     envp  = (spawn_envp.empty()) ? (environ) : (spawn_envp.data());
+  const auto error = ::posix_spawn(&pid, exe.c_str(), &actions, nullptr, spawn_argv.data(), envp);
+  ::posix_spawn_file_actions_destroy(&actions);
+  ::close(out[1]);
+  ::close(err[1]);
+  if (error != 0)
+  {
+    log::error("Failed to start '{}': {}", exe, std::strerror(error));
+    ::close(out[0]);
+    ::close(err[0]);
+    return -1;
+  }
+
+  for (auto* pipe : { &std_out.pipe, &std_err.pipe })
+  {
+    if (pipe->is_open())
+    {
+      pipe->close();
+    }
+  }
+  std_out.pipe.assign(out[0]);
+  std_err.pipe.assign(err[0]);
+  return supervise(pid);
+#else
+  return run_asio();
+#endif
 }
 
 auto Process::run_lines() -> Lines
@@ -222,3 +655,27 @@ auto fmt::formatter<sharif::Process>::format(const sharif::Process& self, format
   }
   return out;
 }
+
+auto fmt::formatter<sharif::Process::Stats>::format(const sharif::Process::Stats& self, format_context& ctx) const -> format_context::iterator
+{
+  using seconds = std::chrono::duration<double>;
+  auto out      = fmt::format_to(
+    ctx.out(),
+    "wall: {:.3f}s user: {:.3f}s sys: {:.3f}s rss: {} MiB switches: {}/{}",
+    seconds{ self.wall_time }.count(),
+    seconds{ self.user_time }.count(),
+    seconds{ self.system_time }.count(),
+    self.max_rss >> 20U,
+    self.voluntary_switches,
+    self.involuntary_switches
+  );
+  if (self.signal != 0)
+  {
+    out = fmt::format_to(out, " signal: {}", self.signal);
+  }
+  if (self.timed_out)
+  {
+    out = fmt::format_to(out, " (timed out)");
+  }
+  return out;
+}
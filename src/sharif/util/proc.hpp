@@ -6,6 +6,8 @@
 /* Includes
  ******************************************************************************/
 // std
+#include <chrono>
+#include <cstdint>
 #include <flat_map>
 #include <memory>
 #include <string>
@@ -26,6 +28,46 @@ class Process {
 public:
   using on_output = void (*)(void* context, std::string_view chunk);
 
+  /// Returned by chunk consumers to keep reading or to pause until they catch up.
+  enum class Flow : uint8_t {
+    CONTINUE,
+    PAUSE,
+  };
+  using on_chunk = Flow (*)(void* context, std::string_view chunk);
+
+  /// How children are started and their output read.
+  enum class Backend : uint8_t {
+    ASIO,   ///< Boost.Process with an `io_context` per child, run on the calling thread
+    UVW,    ///< libuv loop shared by every child, run on a thread of its own
+    SPAWN,  ///< `posix_spawn` with argv and envp built once per `Process`, read like `ASIO`; Linux only
+  };
+
+  /// Caps on a child; a zero leaves that limit unset.
+  struct Limits {
+    std::chrono::milliseconds timeout{};                           ///< wall time before the child is sent SIGTERM
+    std::chrono::milliseconds grace{ std::chrono::seconds{ 5 } };  ///< time from SIGTERM to SIGKILL
+    uint64_t                  address_space{};                     ///< `RLIMIT_AS` in bytes; forces the asio backend
+    uint64_t                  cpu_time{};                          ///< `RLIMIT_CPU` in seconds; forces the asio backend
+  };
+
+  /** What the last `run()` cost. Resource usage comes from `wait4`, so only the wall time,
+   * signal and timeout are known on the libuv backend and on Windows.
+   */
+  struct Stats {
+    std::chrono::microseconds wall_time{};
+    std::chrono::microseconds user_time{};
+    std::chrono::microseconds system_time{};
+    uint64_t                  max_rss{};  ///< bytes
+    uint64_t                  voluntary_switches{};
+    uint64_t                  involuntary_switches{};
+    int32_t                   signal{};  ///< signal that ended the child, or zero
+    bool                      timed_out{ false };
+  };
+
+  /** @returns the backend new processes use; `UVW` if built with `SHARIF_PROCESS_UVW`. */
+  static auto default_backend() noexcept -> Backend;
+  static auto set_default_backend(Backend backend) noexcept -> void;
+
   explicit Process(std::string_view executable);
   Process(std::string_view executable, std::vector<std::string> arguments);
   ~Process();
@@ -34,9 +76,25 @@ public:
   auto with_args(std::vector<std::string> arguments) -> Process&;
   auto with_env(std::flat_map<std::string, std::string> environment) -> Process&;
   auto with_pwd(std::string directory) -> Process&;
+  auto with_backend(Backend backend) -> Process&;
+  auto with_limits(Limits limits) -> Process&;
+  auto stats() const noexcept -> const Stats&;
   auto on_stdout(on_output callback, void* context = nullptr) -> void;
   auto on_stderr(on_output callback, void* context = nullptr) -> void;
 
+  /** Delivers stdout in raw chunks as they are read rather than in whole lines.
+   *
+   * A consumer that returns `Flow::PAUSE` stops further reads until `resume_stdout()`; the
+   * chunk stays valid until then. Once the pipe fills the child blocks, so a slow consumer
+   * throttles the child instead of output piling up in memory.
+   */
+  auto on_stdout_chunks(on_chunk callback, void* context = nullptr) -> void;
+  auto on_stderr_chunks(on_chunk callback, void* context = nullptr) -> void;
+
+  /** Restarts reading a stream whose consumer paused; may be called from any thread. */
+  auto resume_stdout() -> void;
+  auto resume_stderr() -> void;
+
   struct ExitCode {
     int32_t exit_code;
   };
@@ -71,3 +129,8 @@ struct sharif::fmt::formatter<sharif::Process> : formatter<std::string_view> {
   auto format(const sharif::Process& self, format_context& ctx) const -> format_context::iterator;
 };
 
+template <>
+struct sharif::fmt::formatter<sharif::Process::Stats> : formatter<std::string_view> {
+  auto format(const sharif::Process::Stats& self, format_context& ctx) const -> format_context::iterator;
+};
+
@@ -0,0 +1,365 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <csignal>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// 3rd
+#include <uvw/async.h>
+#include <uvw/loop.h>
+#include <uvw/pipe.h>
+#include <uvw/process.h>
+#include <uvw/stream.h>
+#include <uvw/timer.h>
+#include <uvw/util.h>
+
+// local
+#include <sharif/util/detail/proc_uv.hpp>
+#include <sharif/util/log.hpp>
+
+// namespace
+namespace sharif::detail {
+
+/* Types
+ ******************************************************************************/
+namespace {
+/** Hands a callback runs of complete lines, without their final newline, as chunks arrive.
+ *
+ * Chunks that end on a line boundary are passed straight through; only a trailing partial line
+ * is copied until the rest of it arrives.
+ */
+class LineSplitter {
+public:
+  LineSplitter(Process::on_output callback, void* context)
+    : _callback{ callback }
+    , _context{ context }
+  {
+  }
+
+  auto feed(std::string_view chunk) -> void
+  {
+    const auto end = chunk.rfind('\n');
+    if (end == std::string_view::npos)
+    {
+      _partial.append(chunk);
+      return;
+    }
+
+    if (_partial.empty())
+    {
+      emit(chunk.substr(0, end));
+    }
+    else
+    {
+      _partial.append(chunk.substr(0, end));
+      emit(_partial);
+      _partial.clear();
+    }
+    _partial.append(chunk.substr(end + 1));
+  }
+
+  /** Delivers a last line that was not terminated by a newline. */
+  auto finish() -> void
+  {
+    if (!_partial.empty())
+    {
+      emit(_partial);
+      _partial.clear();
+    }
+  }
+
+private:
+  auto emit(std::string_view lines) const -> void
+  {
+    if (_callback != nullptr)
+    {
+      _callback(_context, lines);
+    }
+  }
+
+  Process::on_output _callback;
+  void*              _context;
+  std::string        _partial;
+};
+
+/// One of a child's output pipes and where its data goes.
+struct Stream {
+  explicit Stream(const UvOutput& out)
+    : output{ &out }
+    , lines{ out.lines, out.context }
+  {
+  }
+
+  const UvOutput*         output;  // NOLINT(misc-non-private-member-variables-in-classes)
+  LineSplitter            lines;   // NOLINT(misc-non-private-member-variables-in-classes)
+  std::unique_ptr<char[]> held;    // NOLINT(misc-non-private-member-variables-in-classes) chunk a paused consumer still sees
+};
+
+/// A child in flight; lives on the stack of the thread waiting for it.
+struct Job {
+  Job(const UvRequest& req, Process::Stats& result)
+    : request{ &req }
+    , stats{ &result }
+    , out{ req.std_out }
+    , err{ req.std_err }
+  {
+  }
+
+  const UvRequest*      request;          // NOLINT(misc-non-private-member-variables-in-classes)
+  Process::Stats*       stats;            // NOLINT(misc-non-private-member-variables-in-classes)
+  Stream                out;              // NOLINT(misc-non-private-member-variables-in-classes)
+  Stream                err;              // NOLINT(misc-non-private-member-variables-in-classes)
+  std::promise<int32_t> done;             // NOLINT(misc-non-private-member-variables-in-classes)
+  int32_t               exit_code{ -1 };  // NOLINT(misc-non-private-member-variables-in-classes)
+  uint32_t              open{ 0 };        // NOLINT(misc-non-private-member-variables-in-classes)
+  bool                  failed{ false };  // NOLINT(misc-non-private-member-variables-in-classes)
+};
+
+/** A libuv loop running on its own thread that every child is spawned on. Other threads submit
+ * jobs, or resume paused pipes, through an async handle.
+ */
+class UvLoop {
+public:
+  static auto instance() -> UvLoop&
+  {
+    static UvLoop loop;
+    return loop;
+  }
+
+  UvLoop(const UvLoop&)                    = delete;
+  UvLoop(UvLoop&&)                         = delete;
+  auto operator=(const UvLoop&) -> UvLoop& = delete;
+  auto operator=(UvLoop&&) -> UvLoop&      = delete;
+
+  ~UvLoop()
+  {
+    {
+      std::lock_guard lock{ _mutex };
+      _stopping = true;
+    }
+    _wake->send();
+    _thread.join();
+  }
+
+  auto submit(Job& job) -> void
+  {
+    post([this, &job] { spawn(job); });
+  }
+
+  /** Runs `task` on the loop's thread. */
+  auto post(std::move_only_function<void()> task) -> void
+  {
+    {
+      std::lock_guard lock{ _mutex };
+      _queue.push_back(std::move(task));
+    }
+    _wake->send();
+  }
+
+private:
+  UvLoop()
+    : _loop{ uvw::loop::create() }
+  {
+    uvw::process_handle::disable_stdio_inheritance();
+    _wake = _loop->resource<uvw::async_handle>();
+    _wake->on<uvw::async_event>([this](const uvw::async_event&, uvw::async_handle&) { drain(); });
+    _thread = std::thread{ [this] { _loop->run(); } };
+  }
+
+  /** Runs on the loop thread: runs queued tasks, or closes every handle when stopping. */
+  auto drain() -> void
+  {
+    std::vector<std::move_only_function<void()>> tasks;
+    bool                                         stopping = false;
+    {
+      std::lock_guard lock{ _mutex };
+      tasks.swap(_queue);
+      stopping = _stopping;
+    }
+
+    for (auto& task : tasks)
+    {
+      task();
+    }
+    if (stopping)
+    {
+      _loop->walk([](auto&& handle) { handle.close(); });
+    }
+  }
+
+  auto spawn(Job& job) -> void
+  {
+    const auto& request = *job.request;
+    auto        process = _loop->resource<uvw::process_handle>();
+    auto        out     = _loop->resource<uvw::pipe_handle>();
+    auto        err     = _loop->resource<uvw::pipe_handle>();
+
+    // The job is complete once the exit status is known and both pipes are drained
+    job.open    = 3;
+    auto closed = [&job](const uvw::close_event&, const auto&) {
+      if (--job.open == 0)
+      {
+        job.done.set_value(job.exit_code);
+      }
+    };
+    process->on<uvw::close_event>(closed);
+    out->on<uvw::close_event>(closed);
+    err->on<uvw::close_event>(closed);
+
+    auto read = [this](Stream& stream, std::weak_ptr<uvw::pipe_handle> handle) {
+      return [this, &stream, handle = std::move(handle)](uvw::data_event& event, uvw::pipe_handle& pipe) {
+        const std::string_view chunk{ event.data.get(), event.length };
+        const auto&            output = *stream.output;
+        if (output.chunks == nullptr)
+        {
+          stream.lines.feed(chunk);
+          return;
+        }
+        if (output.chunks(output.context, chunk) == Process::Flow::CONTINUE)
+        {
+          return;
+        }
+
+        // Keep the chunk alive for the consumer and stop reading until it resumes us
+        pipe.stop();
+        stream.held = std::move(event.data);
+        output.resumer->pause([this, &stream, handle] {
+          post([&stream, handle] {
+            stream.held.reset();
+            if (auto pipe = handle.lock(); pipe && !pipe->closing())
+            {
+              pipe->read();
+            }
+          });
+        });
+      };
+    };
+    auto ended = [](Stream& stream) {
+      return [&stream](const uvw::end_event&, uvw::pipe_handle& pipe) {
+        stream.lines.finish();
+        pipe.close();
+      };
+    };
+    auto broken = [](const uvw::error_event& event, uvw::pipe_handle& pipe) {
+      log::debug("Pipe error: {}", event.what());
+      pipe.close();
+    };
+    out->on<uvw::data_event>(read(job.out, out));
+    err->on<uvw::data_event>(read(job.err, err));
+    out->on<uvw::end_event>(ended(job.out));
+    err->on<uvw::end_event>(ended(job.err));
+    out->on<uvw::error_event>(broken);
+    err->on<uvw::error_event>(broken);
+
+    // SIGTERM once the timeout passes, then SIGKILL after the grace period
+    std::shared_ptr<uvw::timer_handle> timer;
+    if (request.timeout.count() != 0)
+    {
+      timer = _loop->resource<uvw::timer_handle>();
+      timer->on<uvw::timer_event>([&job, child = std::weak_ptr{ process }](const uvw::timer_event&, uvw::timer_handle& handle) {
+        auto proc = child.lock();
+        if (!proc || proc->closing())
+        {
+          return;
+        }
+        if (!job.stats->timed_out)
+        {
+          log::warn("'{}' timed out after {}ms", job.request->exe, job.request->timeout.count());
+          job.stats->timed_out = true;
+          proc->kill(SIGTERM);
+          handle.start(uvw::timer_handle::time{ job.request->grace.count() }, uvw::timer_handle::time{ 0 });
+          return;
+        }
+        proc->kill(SIGKILL);
+      });
+      timer->start(uvw::timer_handle::time{ request.timeout.count() }, uvw::timer_handle::time{ 0 });
+    }
+
+    process->on<uvw::exit_event>([&job, timer](const uvw::exit_event& event, uvw::process_handle& handle) {
+      job.stats->signal = event.signal;
+      job.exit_code     = (event.signal != 0) ? (128 + event.signal) : (static_cast<int32_t>(event.status));
+      if (timer)
+      {
+        timer->close();
+      }
+      handle.close();
+    });
+    process->on<uvw::error_event>([&job, out, err, timer](const uvw::error_event& event, uvw::process_handle& handle) {
+      log::error("Failed to start '{}': {}", job.request->exe, event.what());
+      job.failed = true;
+      if (timer)
+      {
+        timer->close();
+      }
+      handle.close();
+      out->close();
+      err->close();
+    });
+
+    std::vector<char*> argv;
+    argv.reserve(request.args->size() + 2);
+    std::string exe{ request.exe };
+    argv.push_back(exe.data());
+    for (const auto& arg : *request.args)
+    {
+      argv.push_back(const_cast<char*>(arg.c_str()));  // NOLINT(cppcoreguidelines-pro-type-const-cast) libuv copies them
+    }
+    argv.push_back(nullptr);
+
+    std::vector<std::string> env;
+    std::vector<char*>       envp;
+    if (!request.env->empty())
+    {
+      env.reserve(request.env->size());
+      for (const auto& [key, value] : *request.env)
+      {
+        env.push_back(key + '=' + value);
+      }
+      for (auto& entry : env)
+      {
+        envp.push_back(entry.data());
+      }
+      envp.push_back(nullptr);
+    }
+
+    process->stdio(uvw::std_in, uvw::process_handle::stdio_flags::IGNORE_STREAM);
+    process->stdio(*out, uvw::process_handle::stdio_flags::CREATE_PIPE | uvw::process_handle::stdio_flags::WRITABLE_PIPE);
+    process->stdio(*err, uvw::process_handle::stdio_flags::CREATE_PIPE | uvw::process_handle::stdio_flags::WRITABLE_PIPE);
+    process->cwd(std::string{ request.pwd });
+    process->spawn(exe.c_str(), argv.data(), envp.empty() ? nullptr : envp.data());
+    if (!job.failed)
+    {
+      out->read();
+      err->read();
+    }
+  }
+
+  std::shared_ptr<uvw::loop>                   _loop;
+  std::shared_ptr<uvw::async_handle>           _wake;
+  std::thread                                  _thread;
+  std::mutex                                   _mutex;
+  std::vector<std::move_only_function<void()>> _queue;
+  bool                                         _stopping{ false };
+};
+}  // namespace
+
+/* Functions
+ ******************************************************************************/
+auto uv_run(const UvRequest& request, Process::Stats& stats) -> int32_t
+{
+  Job  job{ request, stats };
+  auto done = job.done.get_future();
+  UvLoop::instance().submit(job);
+  return done.get();
+}
+
+}  // namespace sharif::detail
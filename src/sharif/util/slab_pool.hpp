@@ -0,0 +1,242 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+// 3rd
+
+// local
+
+/* Macros
+ ******************************************************************************/
+#if defined(__SANITIZE_ADDRESS__)
+#define SHARIF_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define SHARIF_ASAN 1
+#endif
+#endif
+#ifndef SHARIF_ASAN
+#define SHARIF_ASAN 0
+#endif
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Allocates storage for a single `T` with `operator new`. */
+template <typename T>
+struct HeapPool {
+  static auto allocate() -> void*
+  {
+    return ::operator new(sizeof(T), std::align_val_t{ alignof(T) });
+  }
+
+  static auto deallocate(void* ptr) noexcept -> void
+  {
+    ::operator delete(ptr, std::align_val_t{ alignof(T) });
+  }
+};
+
+/** Fixed-size allocator handing out storage for a single `T` from large slabs.
+ *
+ * Each thread keeps its own free list, so allocating and freeing take no lock. A thread keeps at
+ * most two batches of free nodes: beyond that, freed storage goes to a shared depot in batches,
+ * where other threads pick it up when theirs runs out. This matters when one thread frees what
+ * others allocated, and a thread's free list is handed to the depot when it exits. Slabs are
+ * kept for the lifetime of the process, so memory stays at its peak use.
+ *
+ * With AddressSanitizer, storage comes from `HeapPool` instead so use-after-free is caught.
+ */
+template <typename T>
+class SlabPool {
+public:
+  /// Bytes requested from the system at a time.
+  static constexpr size_t SLAB_BYTES = 64 * 1024;
+
+  /// Whether storage comes from slabs, rather than from `HeapPool` under AddressSanitizer.
+  static constexpr bool POOLED = !SHARIF_ASAN;
+
+  static auto allocate() -> void*
+  {
+    if constexpr (!POOLED)
+    {
+      return HeapPool<T>::allocate();
+    }
+
+    auto& local = free_list();
+    if (local.head == nullptr)
+    {
+      refill(local);
+    }
+    Node* node = local.head;
+    local.head = node->link.next;
+    --local.size;
+    return node;
+  }
+
+  static auto deallocate(void* ptr) noexcept -> void
+  {
+    if constexpr (!POOLED)
+    {
+      return HeapPool<T>::deallocate(ptr);
+    }
+
+    auto& local     = free_list();
+    auto* node      = static_cast<Node*>(ptr);
+    node->link.next = local.head;
+    local.head      = node;
+    if (++local.size > 2 * BATCH)
+    {
+      release(local);
+    }
+  }
+
+  /** Free nodes moved between a thread and the depot at a time. */
+  static constexpr auto batch_size() noexcept -> size_t
+  {
+    return BATCH;
+  }
+
+  /** Free nodes held by the calling thread. */
+  static auto cached() noexcept -> size_t
+  {
+    return free_list().size;
+  }
+
+  /** Free nodes in the shared depot. */
+  static auto spare() -> size_t
+  {
+    auto&           state = shared();
+    std::lock_guard lock{ state.mutex };
+    size_t          count = 0;
+    for (const Node* batch = state.depot; batch != nullptr; batch = batch->link.batch)
+    {
+      count += batch->link.size;
+    }
+    return count;
+  }
+
+  /** Slabs requested from the system so far. */
+  static auto slabs() -> size_t
+  {
+    auto&           state = shared();
+    std::lock_guard lock{ state.mutex };
+    return state.slabs.size();
+  }
+
+private:
+  union Node;
+
+  /// A free node; the first node of a batch in the depot also links the next batch.
+  struct Link {
+    Node*  next;
+    Node*  batch;
+    size_t size;
+  };
+
+  union Node {
+    Link link;
+    alignas(T) std::byte storage[sizeof(T)];  // NOLINT(*-avoid-c-arrays)
+  };
+
+  static constexpr size_t NODES_PER_SLAB = std::max<size_t>(SLAB_BYTES / sizeof(Node), 16);
+  static constexpr size_t BATCH          = NODES_PER_SLAB;
+
+  struct FreeList {
+    Node*  head{ nullptr };
+    size_t size{ 0 };
+
+    FreeList() = default;
+    FreeList(const FreeList&)                    = delete;
+    auto operator=(const FreeList&) -> FreeList& = delete;
+
+    ~FreeList()
+    {
+      if (head == nullptr)
+      {
+        return;
+      }
+
+      deposit(head, size);
+    }
+  };
+
+  struct Shared {
+    std::mutex         mutex;
+    Node*              depot{ nullptr };  ///< Batches of free nodes given up by threads
+    std::vector<Node*> slabs;
+  };
+
+  static auto free_list() noexcept -> FreeList&
+  {
+    thread_local FreeList list;
+    return list;
+  }
+
+  static auto shared() noexcept -> Shared&
+  {
+    // Never destroyed: storage may still be in use by other static objects during shutdown
+    static auto* state = new Shared{};
+    return *state;
+  }
+
+  static auto refill(FreeList& local) -> void
+  {
+    auto&           state = shared();
+    std::lock_guard lock{ state.mutex };
+    if (state.depot != nullptr)
+    {
+      local.head  = state.depot;
+      local.size  = state.depot->link.size;
+      state.depot = state.depot->link.batch;
+      return;
+    }
+
+    auto* slab = static_cast<Node*>(::operator new(NODES_PER_SLAB * sizeof(Node), std::align_val_t{ alignof(Node) }));
+    state.slabs.push_back(slab);
+    for (size_t i = 0; i + 1 < NODES_PER_SLAB; ++i)
+    {
+      slab[i].link.next = &slab[i + 1];
+    }
+    slab[NODES_PER_SLAB - 1].link.next = nullptr;
+    local.head                         = slab;
+    local.size                         = NODES_PER_SLAB;
+  }
+
+  /** Moves one batch of the calling thread's free nodes to the depot. */
+  static auto release(FreeList& local) noexcept -> void
+  {
+    Node* head = local.head;
+    Node* last = head;
+    for (size_t i = 1; i < BATCH; ++i)
+    {
+      last = last->link.next;
+    }
+    local.head = std::exchange(last->link.next, nullptr);
+    local.size = local.size - BATCH;
+    deposit(head, BATCH);
+  }
+
+  /** Adds the `size` free nodes listed from `head` to the depot as one batch. */
+  static auto deposit(Node* head, size_t size) noexcept -> void
+  {
+    auto&           state = shared();
+    std::lock_guard lock{ state.mutex };
+    head->link.batch = std::exchange(state.depot, head);
+    head->link.size  = size;
+  }
+};
+
+}  // namespace sharif
@@ -0,0 +1,133 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <bit>
+#include <cstring>
+
+// 3rd
+
+// local
+#include <sharif/util/log.hpp>
+#include <sharif/util/source_cache.hpp>
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+auto SourceCache::line(const fs::path& file, uint32_t line) -> std::optional<std::string_view>
+{
+  return line_of(load(file), line);
+}
+
+auto SourceCache::line_count(const fs::path& file) -> size_t
+{
+  return load(file).starts.size();
+}
+
+auto SourceCache::offset(const fs::path& file, uint32_t line, uint32_t column) -> std::optional<size_t>
+{
+  const auto& source = load(file);
+  const auto  text   = line_of(source, line);
+  const auto  skip   = (column > 0) ? (column - 1) : (0);
+  if (!text || skip > text->size())
+  {
+    return std::nullopt;
+  }
+  return source.starts[line - 1] + skip;
+}
+
+auto SourceCache::text(const fs::path& file) -> std::string_view
+{
+  return load(file).mapping.view();
+}
+
+auto SourceCache::line_of(const File& source, uint32_t line) noexcept -> std::optional<std::string_view>
+{
+  if (line == 0 || line > source.starts.size())
+  {
+    return std::nullopt;
+  }
+
+  const auto all   = source.mapping.view();
+  const auto begin = source.starts[line - 1];
+  const auto end   = (line < source.starts.size()) ? (source.starts[line]) : (all.size());
+  auto       text  = all.substr(begin, end - begin);
+  if (text.ends_with('\n'))
+  {
+    text.remove_suffix(1);
+  }
+  if (text.ends_with('\r'))
+  {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+auto SourceCache::load(const fs::path& file) -> const File&
+{
+  File* source = nullptr;
+  {
+    std::lock_guard lock{ _mutex };
+    auto& slot = _files[file.string()];
+    if (!slot)
+    {
+      slot = std::make_unique<File>();
+    }
+    source = slot.get();
+  }
+
+  // Index outside the lock so threads asking for other files are not held up
+  std::call_once(source->loaded, [&] {
+    auto mapping = MappedFile::open(file);
+    if (!mapping)
+    {
+      log::debug("Unable to read source file '{}'", file.string());
+      return;
+    }
+    source->mapping = std::move(mapping).value();
+
+    const auto text = source->mapping.view();
+    if (text.empty())
+    {
+      return;
+    }
+    source->starts.reserve(count_newlines(text) + 1);
+    source->starts.push_back(0);
+    for (auto pos = text.find('\n'); pos != std::string_view::npos && pos + 1 < text.size(); pos = text.find('\n', pos + 1))
+    {
+      source->starts.push_back(pos + 1);
+    }
+  });
+  return *source;
+}
+
+auto count_newlines(std::string_view text) noexcept -> size_t
+{
+  constexpr uint64_t ONES     = 0x0101'0101'0101'0101;
+  constexpr uint64_t LOW      = 0x7F7F'7F7F'7F7F'7F7F;
+  constexpr uint64_t NEWLINES = ONES * '\n';
+
+  size_t count = 0;
+  size_t pos   = 0;
+  for (; pos + sizeof(uint64_t) <= text.size(); pos += sizeof(uint64_t))
+  {
+    uint64_t word = 0;
+    std::memcpy(&word, text.data() + pos, sizeof(word));
+
+    // Newline bytes become zero; set the high bit of exactly those bytes and count them
+    const uint64_t diff = word ^ NEWLINES;
+    count += static_cast<size_t>(std::popcount(~(((diff & LOW) + LOW) | diff | LOW)));
+  }
+  for (; pos < text.size(); ++pos)
+  {
+    count += static_cast<size_t>(text[pos] == '\n');
+  }
+  return count;
+}
+
+}  // namespace sharif
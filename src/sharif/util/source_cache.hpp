@@ -0,0 +1,75 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/util/filesystem.hpp>
+#include <sharif/util/mapped_file.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Maps each source file once and indexes its line starts, so arbitrary lines can be looked
+ * up without re-reading the file.
+ *
+ * The cache may be shared across threads. A file is mapped and indexed by the first thread to
+ * ask for it while other files load concurrently; views it returns stay valid for the lifetime of
+ * the cache.
+ */
+class SourceCache {
+public:
+  /** @returns the text of 1-based `line` in `file` without its line ending, or `std::nullopt`
+   * if the file cannot be read or has fewer lines.
+   */
+  auto line(const fs::path& file, uint32_t line) -> std::optional<std::string_view>;
+
+  /** @returns the number of lines in `file`, or 0 if it cannot be read. */
+  auto line_count(const fs::path& file) -> size_t;
+
+  /** @returns the byte offset of 1-based `line` and byte `column` within `file`, or `std::nullopt`
+   * if the position is past the end of the line. Column 0 is treated as the start of the line.
+   */
+  auto offset(const fs::path& file, uint32_t line, uint32_t column) -> std::optional<size_t>;
+
+  /** @returns the whole contents of `file`, or an empty view if it cannot be read. */
+  auto text(const fs::path& file) -> std::string_view;
+
+private:
+  struct File {
+    std::once_flag      loaded;
+    MappedFile          mapping;
+    std::vector<size_t> starts;  ///< Byte offset of the start of each line
+  };
+
+  /** @returns the bounds of 1-based `line` without its line ending. */
+  static auto line_of(const File& source, uint32_t line) noexcept -> std::optional<std::string_view>;
+
+  auto load(const fs::path& file) -> const File&;
+
+  std::mutex                                             _mutex;
+  std::unordered_map<std::string, std::unique_ptr<File>> _files;  ///< Nodes never move once loaded
+};
+
+/* Functions
+ ******************************************************************************/
+/** @returns the number of `'\n'` bytes in `text`, counting eight bytes at a time. */
+auto count_newlines(std::string_view text) noexcept -> size_t;
+
+}  // namespace sharif
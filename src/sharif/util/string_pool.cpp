@@ -0,0 +1,69 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <utility>
+
+// 3rd
+
+// local
+#include <sharif/util/string_pool.hpp>
+
+// namespace
+namespace sharif {
+
+/* Functions
+ ******************************************************************************/
+StringPool::StringPool(const StringPool& other)
+{
+  _ids.reserve(other._strings.size());
+  _strings.reserve(other._strings.size());
+  for (const auto* str : other._strings)
+  {
+    intern(*str);
+  }
+}
+
+auto StringPool::operator=(const StringPool& other) -> StringPool&
+{
+  if (this != &other)
+  {
+    StringPool copy{ other };
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+auto StringPool::intern(std::string_view str) -> uint32_t
+{
+  if (auto it = _ids.find(str); it != _ids.end())
+  {
+    return it->second;
+  }
+
+  const auto id = static_cast<uint32_t>(_strings.size());
+  auto it       = _ids.emplace(std::string{ str }, id).first;
+  _strings.push_back(&it->first);
+  return id;
+}
+
+auto StringPool::find(std::string_view str) const -> uint32_t
+{
+  auto it = _ids.find(str);
+  return (it != _ids.end()) ? (it->second) : (NONE);
+}
+
+auto StringPool::operator[](uint32_t id) const noexcept -> std::string_view
+{
+  return (id < _strings.size()) ? (std::string_view{ *_strings[id] }) : (std::string_view{});
+}
+
+auto StringPool::size() const noexcept -> size_t
+{
+  return _strings.size();
+}
+
+}  // namespace sharif
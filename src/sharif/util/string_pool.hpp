@@ -0,0 +1,52 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// 3rd
+
+// local
+#include <sharif/util/hash.hpp>
+
+// namespace
+namespace sharif {
+
+/* Types
+ ******************************************************************************/
+/** Stores each distinct string once and refers to it by a dense 32-bit id, in insertion order. */
+class StringPool {
+public:
+  StringPool() = default;
+  StringPool(const StringPool& other);
+  auto operator=(const StringPool& other) -> StringPool&;
+  StringPool(StringPool&&) noexcept                    = default;
+  auto operator=(StringPool&&) noexcept -> StringPool& = default;
+  ~StringPool()                                        = default;
+
+  /** @returns the id of `str`, adding it if it is new. */
+  auto intern(std::string_view str) -> uint32_t;
+
+  /** @returns the id of `str`, or `NONE`. */
+  auto find(std::string_view str) const -> uint32_t;
+
+  auto operator[](uint32_t id) const noexcept -> std::string_view;
+  auto size() const noexcept -> size_t;
+
+  static constexpr uint32_t NONE = UINT32_MAX;
+
+private:
+  std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> _ids;
+  std::vector<const std::string*>                                         _strings;  ///< Keys of `_ids`, whose nodes never move
+};
+
+}  // namespace sharif
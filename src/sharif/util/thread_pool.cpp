@@ -0,0 +1,172 @@
+/** @file
+ *
+ ******************************************************************************/
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+// 3rd
+
+// local
+#include <sharif/util/thread_pool.hpp>
+
+// namespace
+namespace sharif {
+
+/* Constants
+ ******************************************************************************/
+namespace {
+/// Index of the calling thread's queue in the pool it works for.
+thread_local const ThreadPool* current_pool  = nullptr;
+thread_local size_t            current_index = 0;
+}  // namespace
+
+/* Functions
+ ******************************************************************************/
+ThreadPool::ThreadPool(unsigned threads)
+  : _queues{ std::make_unique<Queue[]>(std::max(threads, 1U)) }  // NOLINT(*-avoid-c-arrays)
+{
+  _threads.reserve(std::max(threads, 1U));
+  for (size_t i = 0; i < std::max(threads, 1U); ++i)
+  {
+    _threads.emplace_back([this, i] { worker(i); });
+  }
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard lock{ _sleep };
+    _stopping = true;
+  }
+  _wake.notify_all();
+  _threads.clear();
+}
+
+auto ThreadPool::size() const noexcept -> unsigned
+{
+  return static_cast<unsigned>(_threads.size());
+}
+
+auto ThreadPool::executor() noexcept -> Executor
+{
+  return Executor{ *this };
+}
+
+auto ThreadPool::is_worker() const noexcept -> bool
+{
+  return current_pool == this;
+}
+
+auto ThreadPool::post(std::move_only_function<void()> job) -> void
+{
+  auto& queue = (is_worker()) ? (_queues[current_index]) : (_shared);
+  {
+    std::lock_guard lock{ queue.mutex };
+    queue.jobs.push_back(std::move(job));
+  }
+  _queued.fetch_add(1, std::memory_order_release);
+
+  // Taking the lock orders this with a worker checking `_queued` before it sleeps
+  {
+    std::lock_guard lock{ _sleep };
+  }
+  _wake.notify_one();
+}
+
+auto ThreadPool::run_one() -> bool
+{
+  auto job = take((is_worker()) ? (current_index) : (0));
+  if (!job)
+  {
+    return false;
+  }
+  job();
+  return true;
+}
+
+auto ThreadPool::worker(size_t index) -> void
+{
+  current_pool  = this;
+  current_index = index;
+  while (true)
+  {
+    if (auto job = take(index); job)
+    {
+      job();
+      continue;
+    }
+
+    std::unique_lock lock{ _sleep };
+    _wake.wait(lock, [this] { return _stopping || _queued.load(std::memory_order_acquire) != 0; });
+    if (_stopping && _queued.load(std::memory_order_acquire) == 0)
+    {
+      return;
+    }
+  }
+}
+
+auto ThreadPool::take(size_t index) -> std::move_only_function<void()>
+{
+  if (_queued.load(std::memory_order_acquire) == 0)
+  {
+    return nullptr;
+  }
+
+  auto pop = [this](Queue& queue, bool newest) -> std::move_only_function<void()> {
+    std::lock_guard lock{ queue.mutex };
+    if (queue.jobs.empty())
+    {
+      return nullptr;
+    }
+
+    std::move_only_function<void()> job;
+    if (newest)
+    {
+      job = std::move(queue.jobs.back());
+      queue.jobs.pop_back();
+    }
+    else
+    {
+      job = std::move(queue.jobs.front());
+      queue.jobs.pop_front();
+    }
+    _queued.fetch_sub(1, std::memory_order_relaxed);
+    return job;
+  };
+
+  // Own work newest-first, then work from outside the pool, then the oldest job of a neighbour
+  const bool worker = is_worker();
+  if (worker)
+  {
+    if (auto job = pop(_queues[index], true); job)
+    {
+      return job;
+    }
+  }
+  if (auto job = pop(_shared, false); job)
+  {
+    return job;
+  }
+
+  const auto count = _threads.size();
+  for (size_t i = 1; i <= count; ++i)
+  {
+    const auto victim = (index + i) % count;
+    if (worker && victim == index)
+    {
+      continue;
+    }
+    if (auto job = pop(_queues[victim], false); job)
+    {
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+}  // namespace sharif
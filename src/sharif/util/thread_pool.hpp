@@ -0,0 +1,414 @@
+/** @file
+ *
+ ******************************************************************************/
+#pragma once
+
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// 3rd
+#include <boost/asio/execution/blocking.hpp>
+
+// local
+
+// namespace
+namespace sharif {
+
+/* Constants
+ ******************************************************************************/
+/// Assumed cache line size; `std::hardware_destructive_interference_size` is not ABI-stable.
+inline constexpr size_t CACHE_LINE = 64;
+
+/* Types
+ ******************************************************************************/
+class ThreadPool;
+
+namespace detail {
+/// Shared between a `Task` and the job computing it.
+template <typename T>
+struct TaskState {
+  using Value = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+  /** Stores the outcome and hands it to the continuations, which run on the pool. */
+  template <typename Outcome>
+  auto complete(Outcome&& outcome) -> void
+  {
+    std::vector<std::move_only_function<void()>> next;
+    {
+      std::lock_guard lock{ mutex };
+      if constexpr (std::is_same_v<std::remove_cvref_t<Outcome>, std::exception_ptr>)
+      {
+        error = std::forward<Outcome>(outcome);
+      }
+      else
+      {
+        value.emplace(std::forward<Outcome>(outcome));
+      }
+      done = true;
+      next.swap(continuations);
+    }
+    finished.notify_all();
+    for (auto& continuation : next)
+    {
+      continuation();
+    }
+  }
+
+  /** Runs `continuation` once the task completes, or now if it already has. */
+  auto on_done(std::move_only_function<void()> continuation) -> void
+  {
+    {
+      std::lock_guard lock{ mutex };
+      if (!done)
+      {
+        continuations.push_back(std::move(continuation));
+        return;
+      }
+    }
+    continuation();
+  }
+
+  /** Hands the value to a consumer: moved out if `self` is the last owner of the state, copied
+   * otherwise, as other tasks and continuations may still read it. Values that cannot be copied
+   * are always moved.
+   */
+  static auto take(const std::shared_ptr<TaskState>& self) -> Value
+  {
+    if constexpr (std::is_copy_constructible_v<Value>)
+    {
+      if (self.use_count() > 1)
+      {
+        return *self->value;
+      }
+      // Pairs with the release by every former owner, so that their reads of the value are done
+      std::atomic_thread_fence(std::memory_order_acquire);
+    }
+    return std::move(*self->value);
+  }
+
+  std::mutex                                   mutex;
+  std::condition_variable                      finished;
+  std::optional<Value>                         value;
+  std::exception_ptr                           error;
+  std::vector<std::move_only_function<void()>> continuations;
+  std::stop_source                             stop;
+  bool                                         done{ false };
+};
+
+/** @returns the exception a task completes with when it was cancelled before it ran. */
+inline auto cancelled_error() -> std::exception_ptr
+{
+  return std::make_exception_ptr(std::system_error{ std::make_error_code(std::errc::operation_canceled) });
+}
+}  // namespace detail
+
+/** The eventual result of a job submitted to a `ThreadPool`.
+ *
+ * A task can be waited for, chained with `then()`, or cancelled. Cancelling a task that has not
+ * started yet skips it, and the task completes with `std::errc::operation_canceled`. A running
+ * job only sees the request through the `std::stop_token` it may take as its last argument, and
+ * the task completes with whatever the job returns or throws.
+ *
+ * The value may be read by several consumers: `get()` and each `then()` continuation receive a
+ * copy, except the last owner of the task, which takes the value. A value that cannot be copied
+ * has a single consumer.
+ */
+template <typename T>
+class Task {
+public:
+  Task() = default;
+
+  auto valid() const noexcept -> bool
+  {
+    return _state != nullptr;
+  }
+
+  auto ready() const -> bool
+  {
+    std::lock_guard lock{ _state->mutex };
+    return _state->done;
+  }
+
+  /** Waits for the result, rethrowing the job's exception. Waiting on a pool thread runs other
+   * jobs in the meantime, so jobs may wait on the tasks they spawn.
+   */
+  auto get() & -> T;
+
+  /** Same as `get() &`, moving the value out if no other task or continuation can read it. */
+  auto get() && -> T;
+
+  /** Runs `fn` with the result on the pool once this task completes. An exception or a
+   * cancellation skips `fn` and is passed on to the returned task.
+   */
+  template <typename Fn>
+  auto then(Fn&& fn) -> auto;
+
+  /** Asks the task to stop; a no-op once it has completed. */
+  auto cancel() -> void
+  {
+    _state->stop.request_stop();
+  }
+
+  auto stop_token() const noexcept -> std::stop_token
+  {
+    return _state->stop.get_token();
+  }
+
+private:
+  friend class ThreadPool;
+  template <typename>
+  friend class Task;
+
+  Task(ThreadPool& pool, std::shared_ptr<detail::TaskState<T>> state)
+    : _pool{ &pool }
+    , _state{ std::move(state) }
+  {
+  }
+
+  /** Waits for the task to complete, rethrowing the job's exception. */
+  auto wait_done() -> void;
+
+  ThreadPool*                           _pool{ nullptr };
+  std::shared_ptr<detail::TaskState<T>> _state;
+};
+
+/** Fixed set of threads that run jobs from per-thread deques, stealing from each other when idle.
+ *
+ * Jobs posted from a pool thread go to the back of that thread's deque and are taken back
+ * newest-first, which keeps recursive work hot in cache; idle threads steal the oldest job from
+ * another deque. Jobs posted from other threads go through a shared queue.
+ *
+ * `executor()` lets asio completion handlers run on the pool, e.g. with `asio::bind_executor`.
+ * `Process` does not use it: it reads a child's output on its own event loop and calls back from
+ * there.
+ */
+class ThreadPool {
+public:
+  /// An asio executor that posts to the pool.
+  class Executor {
+  public:
+    explicit Executor(ThreadPool& pool) noexcept
+      : _pool{ &pool }
+    {
+    }
+
+    template <typename Fn>
+    auto execute(Fn&& fn) const -> void
+    {
+      _pool->post(std::forward<Fn>(fn));
+    }
+
+    auto pool() const noexcept -> ThreadPool&
+    {
+      return *_pool;
+    }
+
+    /// Jobs are always queued, never run inline, which is what `asio::post` asks for.
+    auto require(boost::asio::execution::blocking_t::never_t /*never*/) const noexcept -> Executor
+    {
+      return *this;
+    }
+
+    static constexpr auto query(boost::asio::execution::blocking_t /*blocking*/) noexcept
+    {
+      return boost::asio::execution::blocking.never;
+    }
+
+    auto operator==(const Executor& other) const noexcept -> bool = default;
+
+  private:
+    ThreadPool* _pool;
+  };
+
+  /** Starts `threads` workers, at least one. */
+  explicit ThreadPool(unsigned threads = std::max(std::thread::hardware_concurrency(), 1U));
+  ThreadPool(const ThreadPool&)                    = delete;
+  ThreadPool(ThreadPool&&)                         = delete;
+  auto operator=(const ThreadPool&) -> ThreadPool& = delete;
+  auto operator=(ThreadPool&&) -> ThreadPool&      = delete;
+
+  /** Runs the jobs still queued, then joins the workers. */
+  ~ThreadPool();
+
+  auto size() const noexcept -> unsigned;
+  auto executor() noexcept -> Executor;
+
+  /** @returns whether the calling thread is one of this pool's workers. */
+  auto is_worker() const noexcept -> bool;
+
+  /** Queues `job` without a task to track it. */
+  auto post(std::move_only_function<void()> job) -> void;
+
+  /** Queues `fn()`, or `fn(token)` if it takes a `std::stop_token`, and returns its task. */
+  template <typename Fn>
+  auto submit(Fn&& fn) -> auto
+  {
+    using R   = decltype(invoke(fn, std::stop_token{}));
+    auto task = Task<R>{ *this, std::make_shared<detail::TaskState<R>>() };
+    post([state = task._state, fn = std::forward<Fn>(fn)]() mutable { run(*state, fn); });
+    return task;
+  }
+
+  /** Runs one queued job on the calling thread. @returns false if there was none. */
+  auto run_one() -> bool;
+
+private:
+  template <typename>
+  friend class Task;
+
+  /// A deque on a cache line of its own, so neighbouring workers do not contend.
+  struct alignas(CACHE_LINE) Queue {
+    std::mutex                                  mutex;
+    std::deque<std::move_only_function<void()>> jobs;
+  };
+
+  template <typename Fn>
+  static auto invoke(Fn& fn, std::stop_token token) -> decltype(auto)
+  {
+    if constexpr (std::is_invocable_v<Fn&, std::stop_token>)
+    {
+      return fn(std::move(token));
+    }
+    else
+    {
+      return fn();
+    }
+  }
+
+  template <typename T, typename Fn>
+  static auto run(detail::TaskState<T>& state, Fn& fn) -> void
+  {
+    if (state.stop.stop_requested())
+    {
+      state.complete(detail::cancelled_error());
+      return;
+    }
+
+    try
+    {
+      if constexpr (std::is_void_v<T>)
+      {
+        invoke(fn, state.stop.get_token());
+        state.complete(std::monostate{});
+      }
+      else
+      {
+        state.complete(invoke(fn, state.stop.get_token()));
+      }
+    }
+    catch (...)
+    {
+      state.complete(std::current_exception());
+    }
+  }
+
+  auto worker(size_t index) -> void;
+  auto take(size_t index) -> std::move_only_function<void()>;
+
+  std::unique_ptr<Queue[]>  _queues;  // NOLINT(*-avoid-c-arrays) one per worker
+  Queue                     _shared;
+  std::vector<std::jthread> _threads;
+  std::atomic<size_t>       _queued{ 0 };
+  std::mutex                _sleep;
+  std::condition_variable   _wake;
+  bool                      _stopping{ false };
+};
+
+/* Functions
+ ******************************************************************************/
+template <typename T>
+auto Task<T>::wait_done() -> void
+{
+  if (_pool->is_worker())
+  {
+    while (!ready())
+    {
+      if (!_pool->run_one())
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  std::unique_lock lock{ _state->mutex };
+  _state->finished.wait(lock, [this] { return _state->done; });
+  if (_state->error)
+  {
+    std::rethrow_exception(_state->error);
+  }
+}
+
+template <typename T>
+auto Task<T>::get() & -> T
+{
+  wait_done();
+  if constexpr (std::is_copy_constructible_v<T>)
+  {
+    return *_state->value;
+  }
+  else if constexpr (!std::is_void_v<T>)
+  {
+    return std::move(*_state->value);
+  }
+}
+
+template <typename T>
+auto Task<T>::get() && -> T
+{
+  wait_done();
+  if constexpr (!std::is_void_v<T>)
+  {
+    return detail::TaskState<T>::take(_state);
+  }
+}
+
+template <typename T>
+template <typename Fn>
+auto Task<T>::then(Fn&& fn) -> auto
+{
+  auto invoke_next = [](Fn& next, const std::shared_ptr<detail::TaskState<T>>& prev) -> decltype(auto) {
+    if constexpr (std::is_void_v<T>)
+    {
+      return next();
+    }
+    else
+    {
+      return next(detail::TaskState<T>::take(prev));
+    }
+  };
+  using R = decltype(invoke_next(fn, _state));
+
+  auto next = Task<R>{ *_pool, std::make_shared<detail::TaskState<R>>() };
+  _state->on_done([pool = _pool, prev = _state, state = next._state, fn = std::forward<Fn>(fn), invoke_next]() mutable {
+    pool->post([prev = std::move(prev), state = std::move(state), fn = std::move(fn), invoke_next]() mutable {
+      if (prev->error)
+      {
+        state->complete(prev->error);
+        return;
+      }
+      auto job = [&] { return invoke_next(fn, prev); };
+      ThreadPool::run(*state, job);
+    });
+  });
+  return next;
+}
+
+}  // namespace sharif
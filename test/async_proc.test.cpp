@@ -0,0 +1,121 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 3rd
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/detached.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/this_coro.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/util/async_proc.hpp>
+
+// namespace
+namespace asio = boost::asio;
+
+/* Functions
+ ******************************************************************************/
+namespace {
+struct Outcome {
+  std::vector<std::string>              lines;
+  std::string                           errors;
+  int32_t                               code{ -1 };
+  std::thread::id                       thread;
+  std::chrono::steady_clock::time_point finished;
+};
+
+auto run_shell(std::string script, Outcome& outcome) -> asio::awaitable<void>
+{
+  auto proc = sharif::AsyncProcess::start(co_await asio::this_coro::executor, "sh", { "-c", std::move(script) });
+  if (!proc)
+  {
+    co_return;
+  }
+
+  while (auto lines = co_await proc.value().lines())
+  {
+    outcome.lines.emplace_back(*lines);
+  }
+  outcome.code     = co_await proc.value().exit();
+  outcome.errors   = proc.value().errors();
+  outcome.thread   = std::this_thread::get_id();
+  outcome.finished = std::chrono::steady_clock::now();
+}
+}  // namespace
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Processes are driven by coroutines on one thread", "[async_proc]")  // NOLINT
+{
+  asio::io_context ctx;
+  Outcome          slow;
+  Outcome          fast;
+
+  asio::co_spawn(ctx, run_shell("echo one; sleep 0.2; echo two; printf tail; echo oops >&2; exit 3", slow), asio::detached);
+  asio::co_spawn(ctx, run_shell("seq 3", fast), asio::detached);
+  ctx.run();
+
+  THEN("each child's output arrives in order, with a last line lacking a newline")
+  {
+    REQUIRE(slow.lines == std::vector<std::string>{ "one", "two", "tail" });
+    REQUIRE(slow.errors == "oops\n");
+    REQUIRE(slow.code == 3);
+  }
+
+  THEN("a fast child is not held up by a slow one")
+  {
+    REQUIRE(fast.lines == std::vector<std::string>{ "1\n2\n3" });
+    REQUIRE(fast.code == 0);
+    REQUIRE(fast.finished < slow.finished);
+  }
+
+  THEN("both ran on the thread running the io_context")
+  {
+    REQUIRE(slow.thread == std::this_thread::get_id());
+    REQUIRE(fast.thread == std::this_thread::get_id());
+  }
+}
+
+SCENARIO("Processes are driven by coroutines on several threads", "[async_proc]")  // NOLINT
+{
+  constexpr size_t     CHILDREN = 32;
+  asio::io_context     ctx;
+  std::vector<Outcome> outcomes(CHILDREN);
+  for (size_t i = 0; i < CHILDREN; ++i)
+  {
+    const auto n = std::to_string(i);
+    asio::co_spawn(ctx, run_shell("echo " + n + "; echo " + n + " >&2; exit " + std::to_string(i % 4), outcomes[i]), asio::detached);
+  }
+
+  std::vector<std::jthread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&ctx] { ctx.run(); });
+  }
+  threads.clear();
+
+  THEN("every child's output, errors and exit code are complete once exit() returns")
+  {
+    for (size_t i = 0; i < CHILDREN; ++i)
+    {
+      REQUIRE(outcomes[i].lines == std::vector<std::string>{ std::to_string(i) });
+      REQUIRE(outcomes[i].errors == std::to_string(i) + '\n');
+      REQUIRE(outcomes[i].code == static_cast<int32_t>(i % 4));
+    }
+  }
+}
+
+SCENARIO("Unknown executables fail to start", "[async_proc]")  // NOLINT
+{
+  asio::io_context ctx;
+  REQUIRE_FALSE(sharif::AsyncProcess::start(ctx.get_executor(), "sharif-no-such-tool", {}));
+}
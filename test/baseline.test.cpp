@@ -0,0 +1,362 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/parse/diagnostic.hpp>
+#include <sharif/parse/sarif.hpp>
+#include <sharif/parse/sarif_reader.hpp>
+#include <sharif/report/baseline.hpp>
+#include <sharif/util/filesystem.hpp>
+
+/* Functions
+ ******************************************************************************/
+namespace {
+const auto ROOT = sharif::fs::temp_directory_path() / "sharif_baseline";
+
+auto write_log(std::string_view name, std::string_view text) -> sharif::fs::path
+{
+  sharif::fs::create_directories(ROOT);
+  const auto    path = ROOT / name;
+  std::ofstream stream{ path, std::ios::binary };
+  stream << text;
+  return path;
+}
+
+auto make_result(std::string_view file, uint32_t line, std::string message, std::string rule = "misc-unused") -> sharif::sarif::Result
+{
+  return sharif::sarif::to_result(sharif::Diagnostic{
+    .file     = std::string{ file },
+    .line     = line,
+    .column   = 1,
+    .severity = "warning",
+    .message  = std::move(message),
+    .category = std::move(rule),
+    .source   = {},
+  });
+}
+
+struct Output {
+  std::string                        driver;
+  std::string                        baseline_guid;
+  std::vector<sharif::sarif::Result> results;
+};
+
+/** Reads back what `write_diff()` wrote, one entry per run. */
+auto read_output(std::string_view document) -> std::vector<Output>
+{
+  auto                  reader = sharif::SarifReader{ document };
+  std::vector<Output>   runs;
+  sharif::sarif::Result result;
+  while (reader.next_run().value())
+  {
+    runs.push_back({ .driver = reader.run().tool.driver.name, .baseline_guid = reader.run().baselineGuid.value_or(""), .results = {} });
+    while (reader.next_result(result).value())
+    {
+      runs.back().results.push_back(std::move(result));
+    }
+  }
+  return runs;
+}
+
+auto state(const sharif::sarif::Result& result) -> std::string
+{
+  return result.baselineState.value_or("");
+}
+}  // namespace
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Results are classified against a baseline", "[baseline]")  // NOLINT
+{
+  GIVEN("a baseline with results in two files")
+  {
+    sharif::Baseline baseline;
+    baseline.add(make_result("a.cpp", 3, "unused variable 'x'"));
+    baseline.add(make_result("a.cpp", 9, "unused variable 'y'"));
+    baseline.add(make_result("b.cpp", 5, "unused variable 'z'"));
+    REQUIRE(baseline.size() == 3);
+
+    WHEN("the current run reports an identical, a moved and a new result")
+    {
+      auto same  = make_result("a.cpp", 3, "unused variable 'x'");
+      auto moved = make_result("a.cpp", 12, "unused variable 'y'");
+      auto added = make_result("c.cpp", 1, "unused variable 'w'");
+
+      CHECK(baseline.classify(same) == sharif::sarif::BaselineState::unchanged);
+      CHECK(baseline.classify(moved) == sharif::sarif::BaselineState::updated);
+      CHECK(baseline.classify(added) == sharif::sarif::BaselineState::new_);
+
+      THEN("each carries its state and the unmatched baseline result is absent")
+      {
+        CHECK(state(same) == "unchanged");
+        CHECK(state(moved) == "updated");
+        CHECK(state(added) == "new");
+
+        const auto absent = baseline.absent().value();
+        REQUIRE(absent.size() == 1);
+        CHECK(absent[0].message.text == "unused variable 'z'");
+        CHECK(state(absent[0]) == "absent");
+      }
+    }
+
+    WHEN("the same result is reported twice")
+    {
+      auto first  = make_result("a.cpp", 3, "unused variable 'x'");
+      auto second = make_result("a.cpp", 3, "unused variable 'x'");
+
+      THEN("only one of them matches the baseline")
+      {
+        CHECK(baseline.classify(first) == sharif::sarif::BaselineState::unchanged);
+        CHECK(baseline.classify(second) == sharif::sarif::BaselineState::new_);
+      }
+    }
+  }
+
+  GIVEN("a baseline with many results sharing an identity")
+  {
+    constexpr uint32_t COUNT = 1000;
+    sharif::Baseline   baseline;
+    for (uint32_t line = 1; line <= COUNT; ++line)
+    {
+      baseline.add(make_result("a.cpp", line, "unused variable 'x'"));
+    }
+
+    THEN("results reported again in another order are each matched once")
+    {
+      size_t unchanged = 0;
+      for (uint32_t line = COUNT; line > 0; --line)
+      {
+        auto result = make_result("a.cpp", line, "unused variable 'x'");
+        unchanged += (baseline.classify(result) == sharif::sarif::BaselineState::unchanged) ? (1U) : (0U);
+      }
+      CHECK(unchanged == COUNT);
+
+      auto extra = make_result("a.cpp", 1, "unused variable 'x'");
+      CHECK(baseline.classify(extra) == sharif::sarif::BaselineState::new_);
+      CHECK(baseline.absent()->empty());
+    }
+
+    THEN("results that all moved are each matched once as updated")
+    {
+      size_t updated = 0;
+      for (uint32_t line = 1; line <= COUNT; ++line)
+      {
+        auto result = make_result("a.cpp", line + COUNT, "unused variable 'x'");
+        updated += (baseline.classify(result) == sharif::sarif::BaselineState::updated) ? (1U) : (0U);
+      }
+      CHECK(updated == COUNT);
+      CHECK(baseline.absent()->empty());
+    }
+  }
+
+  GIVEN("a baseline with results of two tools")
+  {
+    sharif::Baseline baseline;
+    baseline.add(make_result("a.cpp", 3, "unused variable 'x'"), "clang-tidy");
+    baseline.add(make_result("a.cpp", 3, "unused variable 'x'"), "cppcheck");
+
+    THEN("a result only matches its own tool's results when a driver is given")
+    {
+      auto result = make_result("a.cpp", 3, "unused variable 'x'");
+      CHECK(baseline.classify(result, "cppcheck") == sharif::sarif::BaselineState::unchanged);
+
+      auto other = make_result("a.cpp", 3, "unused variable 'x'");
+      CHECK(baseline.classify(other, "gcc") == sharif::sarif::BaselineState::new_);
+
+      REQUIRE(baseline.absent("cppcheck")->empty());
+      REQUIRE(baseline.absent("clang-tidy")->size() == 1);
+      REQUIRE(baseline.absent()->size() == 1);
+    }
+  }
+}
+
+SCENARIO("A log is diffed against a baseline log", "[baseline]")  // NOLINT
+{
+  GIVEN("a compact baseline log whose results reference their files by index")
+  {
+    const auto old_log = write_log("old_compact.sarif", R"({ "version": "2.1.0", "runs": [
+      { "tool": { "driver": { "name": "gcc", "rules": [ { "id": "-Wunused" } ] } },
+        "artifacts": [ { "location": { "uri": "a.cpp" } }, { "location": { "uri": "b.cpp", "uriBaseId": "SRCROOT" } } ],
+        "results": [
+          { "ruleIndex": 0, "message": { "text": "unused 'x'" },
+            "locations": [ { "physicalLocation": { "artifactLocation": { "index": 0 }, "region": { "startLine": 3 } } } ] },
+          { "ruleIndex": 0, "message": { "text": "unused 'x'" },
+            "locations": [ { "physicalLocation": { "artifactLocation": { "index": 1 }, "region": { "startLine": 3 } } } ],
+            "relatedLocations": [ { "physicalLocation": { "artifactLocation": { "index": 0 } } } ] }
+        ] }
+    ] })");
+
+    auto baseline = sharif::Baseline::from_file(old_log);
+    REQUIRE(baseline);
+
+    WHEN("the current log reports the result in the first file only")
+    {
+      const auto new_log = write_log("new_compact.sarif", R"({ "version": "2.1.0", "runs": [
+        { "tool": { "driver": { "name": "gcc" } },
+          "results": [
+            { "ruleId": "-Wunused", "message": { "text": "unused 'x'" },
+              "locations": [ { "physicalLocation": { "artifactLocation": { "uri": "a.cpp" }, "region": { "startLine": 3 } } } ] }
+          ] }
+      ] })");
+
+      std::ostringstream out;
+      auto               added = sharif::write_diff(new_log, *baseline, out);
+      REQUIRE(added);
+      CHECK(*added == 0);
+
+      THEN("the results in different files keep their identities, and the absent one is read back whole")
+      {
+        const auto runs = read_output(out.str());
+        REQUIRE(runs.size() == 1);
+        REQUIRE(runs[0].results.size() == 2);
+        CHECK(state(runs[0].results[0]) == "unchanged");
+
+        const auto& absent   = runs[0].results[1];
+        const auto& location = *sharif::sarif::primary_location(absent)->artifactLocation;
+        CHECK(state(absent) == "absent");
+        CHECK(absent.ruleId == "-Wunused");
+        CHECK(location.uri == "b.cpp");
+        CHECK(location.uriBaseId == "SRCROOT");
+        CHECK(location.index.value_or(-1) == -1);
+        REQUIRE(absent.relatedLocations);
+        CHECK(absent.relatedLocations->front().physicalLocation->artifactLocation->uri == "a.cpp");
+      }
+    }
+  }
+
+  GIVEN("a baseline log of two tools with an automation guid")
+  {
+    const auto old_log = write_log("old.sarif", R"({ "version": "2.1.0", "runs": [
+      { "tool": { "driver": { "name": "clang-tidy" } },
+        "automationDetails": { "guid": "00000000-0000-0000-0000-000000000001" },
+        "results": [
+          { "ruleId": "misc-unused", "message": { "text": "unused 'x'" },
+            "locations": [ { "physicalLocation": { "artifactLocation": { "uri": "a.cpp" }, "region": { "startLine": 3 } } } ] },
+          { "ruleId": "misc-unused", "message": { "text": "unused 'y'" },
+            "locations": [ { "physicalLocation": { "artifactLocation": { "uri": "a.cpp" }, "region": { "startLine": 9 } } } ] }
+        ] },
+      { "tool": { "driver": { "name": "cppcheck" } },
+        "results": [
+          { "ruleId": "nullPointer", "ruleIndex": 0, "message": { "text": "null" },
+            "locations": [ { "physicalLocation": { "artifactLocation": { "uri": "b.cpp", "index": 0 }, "region": { "startLine": 5 } } } ] }
+        ] }
+    ] })");
+
+    auto baseline = sharif::Baseline::from_file(old_log);
+    REQUIRE(baseline);
+    REQUIRE(baseline->size() == 3);
+    REQUIRE(baseline->guid() == "00000000-0000-0000-0000-000000000001");
+
+    WHEN("the current log has the tools in other runs, one of them twice and one without results")
+    {
+      const auto new_log = write_log("new.sarif", R"({ "version": "2.1.0", "runs": [
+        { "tool": { "driver": { "name": "cppcheck" } }, "results": [] },
+        { "tool": { "driver": { "name": "clang-tidy" } },
+          "results": [
+            { "ruleId": "misc-unused", "message": { "text": "unused 'x'" },
+              "locations": [ { "physicalLocation": { "artifactLocation": { "uri": "a.cpp" }, "region": { "startLine": 3 } } } ] }
+          ] },
+        { "tool": { "driver": { "name": "clang-tidy" } },
+          "results": [
+            { "ruleId": "misc-unused", "message": { "text": "unused 'w'" },
+              "locations": [ { "physicalLocation": { "artifactLocation": { "uri": "c.cpp" }, "region": { "startLine": 1 } } } ] }
+          ] }
+      ] })");
+
+      std::ostringstream out;
+      auto               added = sharif::write_diff(new_log, *baseline, out);
+      REQUIRE(added);
+      CHECK(*added == 1);
+
+      THEN("every run is kept and absent results go to the last run of their tool")
+      {
+        const auto runs = read_output(out.str());
+        REQUIRE(runs.size() == 3);
+        for (const auto& run : runs)
+        {
+          CHECK(run.baseline_guid == "00000000-0000-0000-0000-000000000001");
+        }
+
+        REQUIRE(runs[0].driver == "cppcheck");
+        REQUIRE(runs[0].results.size() == 1);
+        CHECK(state(runs[0].results[0]) == "absent");
+        CHECK(runs[0].results[0].ruleIndex.value_or(-1) == -1);
+        CHECK(runs[0].results[0].ruleId == "nullPointer");
+
+        REQUIRE(runs[1].driver == "clang-tidy");
+        REQUIRE(runs[1].results.size() == 1);
+        CHECK(state(runs[1].results[0]) == "unchanged");
+
+        REQUIRE(runs[2].results.size() == 2);
+        CHECK(state(runs[2].results[0]) == "new");
+        CHECK(state(runs[2].results[1]) == "absent");
+        CHECK(runs[2].results[1].message.text == "unused 'y'");
+      }
+    }
+
+    WHEN("the current log references its files by index only")
+    {
+      const auto new_log = write_log("compact.sarif", R"({ "version": "2.1.0", "runs": [
+        { "tool": { "driver": { "name": "clang-tidy" } },
+          "artifacts": [ { "location": { "uri": "c.cpp" } }, { "location": { "uri": "a.cpp" } } ],
+          "results": [
+            { "ruleId": "misc-unused", "message": { "text": "unused 'x'" },
+              "locations": [ { "physicalLocation": { "artifactLocation": { "index": 1 }, "region": { "startLine": 3 } } } ] },
+            { "ruleId": "misc-unused", "message": { "text": "unused 'y'" },
+              "locations": [ { "physicalLocation": { "artifactLocation": { "index": 0 }, "region": { "startLine": 9 } } } ] }
+          ] },
+        { "tool": { "driver": { "name": "cppcheck" } } }
+      ] })");
+
+      std::ostringstream out;
+      auto               added = sharif::write_diff(new_log, *baseline, out);
+      REQUIRE(added);
+
+      THEN("the indices are resolved to the files they stand for before matching")
+      {
+        CHECK(*added == 1);
+        const auto runs = read_output(out.str());
+        REQUIRE(runs.size() == 2);
+        REQUIRE(runs[0].results.size() == 3);
+        CHECK(state(runs[0].results[0]) == "unchanged");
+        CHECK(state(runs[0].results[1]) == "new");
+        CHECK(state(runs[0].results[2]) == "absent");
+      }
+    }
+
+    WHEN("the current log has a single run of a renamed tool")
+    {
+      const auto new_log = write_log("renamed.sarif", R"({ "version": "2.1.0", "runs": [
+        { "tool": { "driver": { "name": "clang-tidy-19" } },
+          "results": [
+            { "ruleId": "misc-unused", "message": { "text": "unused 'x'" },
+              "locations": [ { "physicalLocation": { "artifactLocation": { "uri": "a.cpp" }, "region": { "startLine": 4 } } } ] }
+          ] }
+      ] })");
+
+      std::ostringstream out;
+      auto               added = sharif::write_diff(new_log, *baseline, out, true);
+      REQUIRE(added);
+      CHECK(*added == 0);
+
+      THEN("its results match every tool and all absent results are reported in it")
+      {
+        const auto runs = read_output(out.str());
+        REQUIRE(runs.size() == 1);
+        REQUIRE(runs[0].results.size() == 3);
+        CHECK(state(runs[0].results[0]) == "updated");
+        CHECK(state(runs[0].results[1]) == "absent");
+        CHECK(state(runs[0].results[2]) == "absent");
+      }
+    }
+  }
+}
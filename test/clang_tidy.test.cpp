@@ -0,0 +1,136 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/parse/compile_command.hpp>
+#include <sharif/tool/clang_tidy.hpp>
+#include <sharif/util/executable.hpp>
+#include <sharif/util/filesystem.hpp>
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("ClangTidy runs one process per file and merges their diagnostics", "[clang_tidy]")  // NOLINT
+{
+  // Stands in for clang-tidy: one warning in the file it is given, and one in a shared header
+  const auto dir = sharif::fs::temp_directory_path() / "sharif_clang_tidy";
+  const auto exe = dir / "sharif-fake-clang-tidy";
+  sharif::fs::create_directories(dir);
+  {
+    std::ofstream stream{ exe };
+    stream << "#!/bin/sh\n"
+              "for arg; do file=$arg; done\n"
+              "echo \"$file:3:5: warning: unused variable 'x' [misc-unused]\"\n"
+              "echo '    3 |   int x;'\n"
+              "echo \"common.h:1:1: warning: header guard missing [llvm-header-guard]\" >&2\n"
+              "case $file in *fail*) exit 1;; esac\n";
+  }
+  sharif::fs::permissions(exe, sharif::fs::perms::owner_all);
+
+  const std::string original = std::getenv("PATH");  // NOLINT(concurrency-mt-unsafe)
+  ::setenv("PATH", (dir.string() + ':' + original).c_str(), 1);  // NOLINT(concurrency-mt-unsafe)
+  sharif::clear_executable_cache();
+
+  const auto history = dir / "history.json";
+  sharif::fs::remove(history);
+
+  GIVEN("three translation units, one of which makes the tool fail")
+  {
+    std::vector<sharif::CompileCommand> commands(3);
+    commands[0].file = "a.cpp";
+    commands[1].file = "b.cpp";
+    commands[2].file = "fail.cpp";
+
+    sharif::ClangTidy tidy;
+    tidy.set_exe("sharif-fake-clang-tidy");
+    tidy.with_jobs(2).with_history(history);
+
+    WHEN("it is run")
+    {
+      auto run = tidy.run(commands);
+
+      THEN("every file's diagnostics are reported, and the header's only once")
+      {
+        REQUIRE(run.tool.driver.name == "clang-tidy");
+        REQUIRE(run.results);
+        REQUIRE(run.results->size() == 4);
+
+        std::vector<std::string> rules;
+        for (const auto& result : *run.results)
+        {
+          rules.push_back(result.ruleId.value_or(""));
+          if (result.ruleId == "llvm-header-guard")
+          {
+            CHECK(result.occurrenceCount == 3U);
+          }
+        }
+        CHECK(std::ranges::count(rules, "misc-unused") == 3);
+        CHECK(std::ranges::count(rules, "llvm-header-guard") == 1);
+      }
+
+      THEN("the run times are recorded for the next run")
+      {
+        CHECK(sharif::fs::exists(history));
+      }
+
+      THEN("the invocation succeeded, as the tool ran on every file")
+      {
+        REQUIRE(run.invocations);
+        CHECK(run.invocations->front().executionSuccessful);
+      }
+    }
+  }
+
+  GIVEN("an executable that does not exist")
+  {
+    std::vector<sharif::CompileCommand> commands(2);
+    commands[0].file = "a.cpp";
+    commands[1].file = "b.cpp";
+
+    sharif::ClangTidy tidy;
+    tidy.set_exe((dir / "sharif-no-such-clang-tidy").string());
+    tidy.with_jobs(2).with_history(history);
+
+    WHEN("it is run")
+    {
+      auto run = tidy.run(commands);
+
+      THEN("every file is reported as not analyzed instead of as clean")
+      {
+        CHECK(run.results->empty());
+        REQUIRE(run.invocations);
+        REQUIRE(run.invocations->size() == 1);
+
+        const auto& invocation = run.invocations->front();
+        CHECK_FALSE(invocation.executionSuccessful);
+        REQUIRE(invocation.toolExecutionNotifications);
+        REQUIRE(invocation.toolExecutionNotifications->size() == 2);
+        for (const auto& notification : *invocation.toolExecutionNotifications)
+        {
+          CHECK(notification.level == sharif::sarif::Level::error);
+          CHECK(notification.locations->front().physicalLocation->artifactLocation->uri.has_value());
+        }
+      }
+
+      THEN("no run time is recorded for the files")
+      {
+        std::ifstream      stream{ history };
+        std::ostringstream text;
+        text << stream.rdbuf();
+        CHECK(text.str().find("a.cpp") == std::string::npos);
+      }
+    }
+  }
+
+  ::setenv("PATH", original.c_str(), 1);  // NOLINT(concurrency-mt-unsafe)
+  sharif::clear_executable_cache();
+}
@@ -0,0 +1,151 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/parse/sarif.hpp>
+#include <sharif/report/columns.hpp>
+#include <sharif/util/filesystem.hpp>
+#include <sharif/util/source_cache.hpp>
+
+/* Constants
+ ******************************************************************************/
+// Byte offsets: a(0) é(1-2) 中(3-5) 😀(6-9) b(10)
+constexpr std::string_view LINE = "aé中\U0001F600b = 1;";
+
+/* Functions
+ ******************************************************************************/
+namespace {
+const auto ROOT = sharif::fs::temp_directory_path() / "sharif_columns";
+
+auto write_source(const sharif::fs::path& path, std::string_view text) -> void
+{
+  sharif::fs::create_directories(path.parent_path());
+  std::ofstream stream{ path, std::ios::binary };
+  stream << text;
+}
+
+auto make_location(std::string uri, uint32_t line, uint32_t column) -> sharif::sarif::Location
+{
+  sharif::sarif::Region region;
+  region.startLine   = line;
+  region.startColumn = column;
+
+  sharif::sarif::Location location;
+  auto& physical            = location.physicalLocation.emplace();
+  physical.artifactLocation = sharif::sarif::ArtifactLocation{ .uri = std::move(uri) };
+  physical.region           = std::move(region);
+  return location;
+}
+
+auto region(const sharif::sarif::Location& location) -> const sharif::sarif::Region&
+{
+  return *location.physicalLocation->region;
+}
+}  // namespace
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Byte columns are converted to SARIF column kinds", "[columns]")  // NOLINT
+{
+  using sharif::sarif::ColumnKind;
+
+  REQUIRE(sharif::count_code_points(LINE) == 10);
+  REQUIRE(sharif::count_utf16_units(LINE) == 11);
+
+  SECTION("Code points")
+  {
+    REQUIRE(sharif::ColumnConverter::convert(LINE, 1, ColumnKind::unicodeCodePoints) == 1);
+    REQUIRE(sharif::ColumnConverter::convert(LINE, 4, ColumnKind::unicodeCodePoints) == 3);
+    REQUIRE(sharif::ColumnConverter::convert(LINE, 11, ColumnKind::unicodeCodePoints) == 5);
+  }
+
+  SECTION("UTF-16 code units count surrogate pairs twice")
+  {
+    REQUIRE(sharif::ColumnConverter::convert(LINE, 7, ColumnKind::utf16CodeUnits) == 4);
+    REQUIRE(sharif::ColumnConverter::convert(LINE, 11, ColumnKind::utf16CodeUnits) == 6);
+  }
+
+  SECTION("Columns past the end of the line count one unit per byte")
+  {
+    REQUIRE(sharif::ColumnConverter::convert("ab", 5, ColumnKind::utf16CodeUnits) == 5);
+    REQUIRE(sharif::ColumnConverter::convert(LINE, static_cast<uint32_t>(LINE.size()) + 2, ColumnKind::unicodeCodePoints) == 12);
+  }
+}
+
+SCENARIO("The regions of a run are rewritten to its column kind", "[columns]")  // NOLINT
+{
+  using sharif::sarif::ColumnKind;
+
+  // Byte offsets of line 3: 中(0-2) 中(3-5) ' '(6)
+  const auto relative = ROOT / "src" / "a.cpp";
+  const auto absolute = ROOT / "b.cpp";
+  write_source(relative, std::string{ LINE } + "\nx\n中中 = 2;\n");
+  write_source(absolute, "\U0001F600\U0001F600x\n");
+
+  sharif::sarif::Run run;
+  run.tool.driver.name = "gcc";
+  run.results.emplace(3);
+
+  // Results across both files, out of line order, one spanning from line 1 to line 3
+  auto& spanning = (*run.results)[0].locations.emplace().emplace_back(make_location("src/a.cpp", 1, 11));
+  spanning.physicalLocation->region->endLine   = 3;
+  spanning.physicalLocation->region->endColumn = 7;
+
+  (*run.results)[1].locations.emplace().push_back(make_location(sharif::sarif::to_uri(absolute.string()), 1, 9));
+  (*run.results)[1].relatedLocations.emplace().push_back(make_location("src/a.cpp", 1, 4));
+
+  auto& same_line = (*run.results)[2].locations.emplace().emplace_back(make_location("src/a.cpp", 3, 4));
+  same_line.physicalLocation->region->endColumn = 7;
+
+  sharif::SourceCache cache;
+  auto                converter = sharif::ColumnConverter{ cache, ROOT.string() };
+
+  GIVEN("a run without a column kind")
+  {
+    converter.apply(run, ColumnKind::utf16CodeUnits);
+    const auto& results = *run.results;
+
+    THEN("the kind is set and every region is converted against its own file and lines")
+    {
+      CHECK(run.columnKind == "utf16CodeUnits");
+
+      CHECK(region(results[0].locations->front()).startColumn == 6U);
+      CHECK(region(results[0].locations->front()).endColumn == 3U);
+
+      CHECK(region(results[1].locations->front()).startColumn == 5U);
+      CHECK(region(results[1].relatedLocations->front()).startColumn == 3U);
+
+      CHECK(region(results[2].locations->front()).startColumn == 2U);
+      CHECK(region(results[2].locations->front()).endColumn == 3U);
+    }
+
+    THEN("the files were read through the cache, which still serves them once they are gone")
+    {
+      sharif::fs::remove_all(ROOT);
+      CHECK(cache.line(relative, 3) == "中中 = 2;");
+      CHECK(cache.line(absolute, 1) == "\U0001F600\U0001F600x");
+    }
+  }
+
+  GIVEN("a run that already declares a column kind")
+  {
+    run.columnKind = "unicodeCodePoints";
+    converter.apply(run, ColumnKind::utf16CodeUnits);
+
+    THEN("it is left as it is")
+    {
+      CHECK(run.columnKind == "unicodeCodePoints");
+      CHECK(region(run.results->front().locations->front()).startColumn == 11U);
+      CHECK(region(run.results->back().locations->front()).endColumn == 7U);
+    }
+  }
+}
@@ -0,0 +1,139 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/parse/cppcheck.hpp>
+#include <sharif/tool/cppcheck.hpp>
+#include <sharif/util/executable.hpp>
+#include <sharif/util/filesystem.hpp>
+
+/* Functions
+ ******************************************************************************/
+namespace {
+auto make_error(std::string id, std::string file, uint32_t line) -> sharif::cppcheck::Error
+{
+  sharif::cppcheck::Error error;
+  error.id       = std::move(id);
+  error.msg      = "message";
+  error.severity = sharif::cppcheck::Severity::WARNING;
+  error.locations.push_back({ .file = std::move(file), .info = {}, .line = line, .column = 1 });
+  return error;
+}
+}  // namespace
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("cppcheck reports from several shards are merged", "[cppcheck]")  // NOLINT
+{
+  GIVEN("two shards that both report an error in a shared header")
+  {
+    std::vector<sharif::cppcheck::Report> reports(2);
+    reports[0].errors = { make_error("nullPointer", "common.h", 3), make_error("uninitvar", "a.cpp", 10) };
+    reports[1].errors = { make_error("nullPointer", "common.h", 3), make_error("uninitvar", "b.cpp", 10), make_error("nullPointer", "common.h", 4) };
+
+    auto merged = sharif::cppcheck::merge(std::move(reports));
+
+    THEN("the shared error is kept once, in order of first appearance")
+    {
+      REQUIRE(merged.version == 2);
+      REQUIRE(merged.errors.size() == 4);
+      CHECK(merged.errors[0].id == "nullPointer");
+      CHECK(merged.errors[1].locations.front().file == "a.cpp");
+      CHECK(merged.errors[2].locations.front().file == "b.cpp");
+      CHECK(merged.errors[3].locations.front().line == 4);
+    }
+  }
+
+  GIVEN("errors without a location")
+  {
+    std::vector<sharif::cppcheck::Report> reports(2);
+    reports[0].errors.emplace_back().id = "missingInclude";
+    reports[1].errors.emplace_back().id = "missingInclude";
+    reports[1].errors.emplace_back().id = "toomanyconfigs";
+
+    THEN("they are de-duplicated on their id")
+    {
+      auto merged = sharif::cppcheck::merge(std::move(reports));
+      REQUIRE(merged.errors.size() == 2);
+    }
+  }
+
+  GIVEN("no reports")
+  {
+    THEN("the result is an empty report")
+    {
+      CHECK(sharif::cppcheck::merge({}).errors.empty());
+    }
+  }
+}
+
+SCENARIO("Cppcheck runs each shard in a directory of its own", "[cppcheck]")  // NOLINT
+{
+  // Stands in for cppcheck: an error in a shared header and one per shard, or a crash that
+  // leaves half a report behind for a shard containing fail.cpp
+  const auto dir = sharif::fs::temp_directory_path() / "sharif_cppcheck";
+  const auto exe = dir / "bin" / "sharif-fake-cppcheck";
+  sharif::fs::remove_all(dir);
+  sharif::fs::create_directories(exe.parent_path());
+  {
+    std::ofstream stream{ exe };
+    stream << "#!/bin/sh\n"
+              "for arg; do\n"
+              "  case $arg in --output-file=*) out=${arg#--output-file=};; --project=*) project=${arg#--project=};; esac\n"
+              "done\n"
+              "if grep -q fail.cpp \"$project\"; then echo '<results version=\"2\"><errors><error id=\"stale\"' > \"$out\"; exit 3; fi\n"
+              "cat > \"$out\" <<EOF\n"
+              "<results version=\"2\"><errors>\n"
+              "<error id=\"nullPointer\" severity=\"error\" msg=\"m\"><location file=\"common.h\" line=\"1\" column=\"1\"/></error>\n"
+              "<error id=\"uninitvar\" severity=\"error\" msg=\"m\"><location file=\"$project\" line=\"2\" column=\"1\"/></error>\n"
+              "</errors></results>\n"
+              "EOF\n";
+  }
+  sharif::fs::permissions(exe, sharif::fs::perms::owner_all);
+
+  const std::string original = std::getenv("PATH");  // NOLINT(concurrency-mt-unsafe)
+  ::setenv("PATH", (exe.parent_path().string() + ':' + original).c_str(), 1);  // NOLINT(concurrency-mt-unsafe)
+  sharif::clear_executable_cache();
+
+  GIVEN("three translation units, one per shard, one of which crashes cppcheck")
+  {
+    std::vector<sharif::CompileCommand> commands(3);
+    commands[0].file = "a.cpp";
+    commands[1].file = "b.cpp";
+    commands[2].file = "fail.cpp";
+
+    const auto work = dir / "work";
+
+    sharif::Cppcheck cppcheck;
+    cppcheck.set_exe("sharif-fake-cppcheck");
+    cppcheck.with_work_dir(work).with_jobs(2);
+
+    WHEN("it is run")
+    {
+      auto report = cppcheck.run(commands);
+
+      THEN("only the shards that succeeded are merged")
+      {
+        CHECK(report.errors.size() == 3);
+        CHECK(std::ranges::none_of(report.errors, [](const auto& error) { return error.id == "stale"; }));
+      }
+
+      THEN("the run's shard files are removed")
+      {
+        CHECK(sharif::fs::is_empty(work));
+      }
+    }
+  }
+
+  ::setenv("PATH", original.c_str(), 1);  // NOLINT(concurrency-mt-unsafe)
+  sharif::clear_executable_cache();
+}
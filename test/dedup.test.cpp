@@ -0,0 +1,59 @@
+/* Includes
+ ******************************************************************************/
+// std
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/report/dedup.hpp>
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Duplicate diagnostics are collapsed", "[dedup]")  // NOLINT
+{
+  auto header = sharif::Diagnostic{
+    .file     = "src/foo.hpp",
+    .line     = 10,
+    .column   = 8,
+    .severity = "warning",
+    .message  = "unused   variable ‘x’",
+    .category = "-Wunused-variable",
+    .source   = {},
+  };
+
+  sharif::Deduplicator dedup;
+  REQUIRE(dedup.add(header));
+
+  SECTION("Path separators and whitespace are normalized")
+  {
+    auto copy    = header;
+    copy.file    = "src\\foo.hpp";
+    copy.message = " unused variable\t‘x’ ";
+    REQUIRE_FALSE(dedup.add(copy));
+    REQUIRE(dedup.size() == 1);
+    REQUIRE(dedup.occurrences()[0] == 2);
+  }
+
+  SECTION("Different locations are kept")
+  {
+    auto other = header;
+    other.line = 11;
+    REQUIRE(dedup.add(other));
+    REQUIRE(dedup.size() == 2);
+  }
+
+  SECTION("Shards merge their occurrence counts")
+  {
+    sharif::Deduplicator shard;
+    shard.add(header);
+    shard.add(header);
+    dedup.merge(std::move(shard));
+    REQUIRE(dedup.size() == 1);
+    REQUIRE(dedup.occurrences()[0] == 3);
+
+    auto results = dedup.to_results();
+    REQUIRE(results.size() == 1);
+    REQUIRE(results[0].occurrenceCount == 3U);
+  }
+}
@@ -177,3 +177,24 @@ SCENARIO("Diagnostic with brackets")  // NOLINT
   REQUIRE(diagnostic->category == "-Wsomething");
 }
 
+
+SCENARIO("Diagnostic stream split across chunks")  // NOLINT
+{
+  sharif::DiagnosticStream stream;
+
+  stream.feed("/src/foo.cpp:10:8: warning: variable ‘parse’ set but not used [-Wunused-but-set-variable]\n   10 |   auto parse = Parser(str);");
+  REQUIRE(stream.diagnostics().empty());
+
+  stream.feed("      |        ^~~~~\n3 warnings generated.\n/src/bar.cpp:324:8: error: Missing attribute");
+  REQUIRE(stream.diagnostics().size() == 1);
+  REQUIRE(stream.diagnostics()[0].file == "/src/foo.cpp");
+  REQUIRE(stream.diagnostics()[0].source == R"(   10 |   auto parse = Parser(str);
+      |        ^~~~~
+)");
+
+  stream.finish();
+  REQUIRE(stream.diagnostics().size() == 2);
+  REQUIRE(stream.diagnostics()[1].file == "/src/bar.cpp");
+  REQUIRE(stream.diagnostics()[1].line == 324);
+  REQUIRE(stream.diagnostics()[1].message == "Missing attribute");
+}
@@ -0,0 +1,67 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/util/executable.hpp>
+#include <sharif/util/filesystem.hpp>
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Executables are resolved once per PATH", "[executable]")  // NOLINT
+{
+  const auto dir = sharif::fs::temp_directory_path() / "sharif_executable";
+  const auto exe = dir / "sharif-test-tool";
+  sharif::fs::create_directories(dir);
+  {
+    std::ofstream stream{ exe };
+    stream << "#!/bin/sh\n";
+  }
+  sharif::fs::permissions(exe, sharif::fs::perms::owner_all);
+
+  const std::string original = std::getenv("PATH");  // NOLINT(concurrency-mt-unsafe)
+  sharif::clear_executable_cache();
+
+  GIVEN("a tool that is not on PATH")
+  {
+    REQUIRE(sharif::find_executable("sharif-test-tool").empty());
+
+    WHEN("PATH changes to include it")
+    {
+      ::setenv("PATH", (dir.string() + ':' + original).c_str(), 1);  // NOLINT(concurrency-mt-unsafe)
+
+      THEN("the cached miss is dropped")
+      {
+        REQUIRE(sharif::find_executable("sharif-test-tool") == exe.string());
+        REQUIRE(sharif::find_executable("sharif-test-tool") == exe.string());
+      }
+    }
+  }
+
+  GIVEN("a tool that is on PATH")
+  {
+    ::setenv("PATH", (dir.string() + ':' + original).c_str(), 1);  // NOLINT(concurrency-mt-unsafe)
+    REQUIRE(sharif::find_executable("sharif-test-tool") == exe.string());
+
+    WHEN("it is removed but PATH is unchanged")
+    {
+      sharif::fs::remove(exe);
+
+      THEN("the cached path is still returned until the cache is cleared")
+      {
+        REQUIRE(sharif::find_executable("sharif-test-tool") == exe.string());
+        sharif::clear_executable_cache();
+        REQUIRE(sharif::find_executable("sharif-test-tool").empty());
+      }
+    }
+  }
+
+  ::setenv("PATH", original.c_str(), 1);  // NOLINT(concurrency-mt-unsafe)
+  sharif::fs::remove_all(dir);
+}
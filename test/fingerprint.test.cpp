@@ -0,0 +1,164 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/parse/diagnostic.hpp>
+#include <sharif/parse/sarif.hpp>
+#include <sharif/report/fingerprint.hpp>
+#include <sharif/util/filesystem.hpp>
+#include <sharif/util/source_cache.hpp>
+
+/* Functions
+ ******************************************************************************/
+namespace {
+const auto ROOT = sharif::fs::temp_directory_path() / "sharif_fingerprint";
+
+auto write_source(std::string_view name, std::string_view text) -> void
+{
+  sharif::fs::create_directories(ROOT);
+  std::ofstream stream{ ROOT / name, std::ios::binary };
+  stream << text;
+}
+
+auto make_result(std::string_view file, uint32_t line, std::string message, std::string rule = "misc-unused") -> sharif::sarif::Result
+{
+  return sharif::sarif::to_result(sharif::Diagnostic{
+    .file     = std::string{ file },
+    .line     = line,
+    .column   = 1,
+    .severity = "warning",
+    .message  = std::move(message),
+    .category = std::move(rule),
+    .source   = {},
+  });
+}
+
+/** Fingerprints `result` against a fresh cache, as a later run would. */
+auto fingerprint(sharif::sarif::Result result) -> sharif::sarif::Result
+{
+  sharif::SourceCache   sources;
+  sharif::Fingerprinter hasher{ sources, ROOT.string() };
+  hasher.apply(result);
+  return result;
+}
+
+auto key(const sharif::sarif::Result& result, std::string_view name) -> std::string
+{
+  return result.partialFingerprints->at(std::string{ name });
+}
+}  // namespace
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Messages are reduced to a template", "[fingerprint]")  // NOLINT
+{
+  using sharif::Fingerprinter;
+  CHECK(Fingerprinter::message_template("unused variable 'x' [-Wunused]") == "unused variable '{}' [-Wunused]");
+  CHECK(Fingerprinter::message_template("variable ‘parse’ set but not used") == "variable '{}' set but not used");
+  CHECK(Fingerprinter::message_template("function has 123 lines, limit is 80") == "function has 0 lines, limit is 0");
+  CHECK(Fingerprinter::message_template("unterminated 'quote") == "unterminated 'quote");
+}
+
+SCENARIO("Fingerprints survive unrelated edits", "[fingerprint]")  // NOLINT
+{
+  GIVEN("a result on a line of a file")
+  {
+    write_source("shift.cpp", "int main()\n{\n  int unused = 0;\n}\n");
+    const auto before = fingerprint(make_result("shift.cpp", 3, "unused variable 'unused'"));
+
+    WHEN("lines are inserted above it")
+    {
+      write_source("shift.cpp", "#include <cstdio>\n\nint main()\n{\n  int unused = 0;\n}\n");
+      const auto after = fingerprint(make_result("shift.cpp", 5, "unused variable 'unused'"));
+
+      THEN("both fingerprints are unchanged")
+      {
+        CHECK(key(before, sharif::FINGERPRINT_KEY) == key(after, sharif::FINGERPRINT_KEY));
+        CHECK(key(before, sharif::LINE_HASH_KEY) == key(after, sharif::LINE_HASH_KEY));
+        CHECK(key(after, sharif::LINE_HASH_KEY).ends_with(":1"));
+      }
+    }
+
+    WHEN("the line itself changes")
+    {
+      write_source("shift.cpp", "int main()\n{\n  int unused = 1;\n}\n");
+      const auto after = fingerprint(make_result("shift.cpp", 3, "unused variable 'unused'"));
+
+      THEN("both fingerprints change")
+      {
+        CHECK(key(before, sharif::FINGERPRINT_KEY) != key(after, sharif::FINGERPRINT_KEY));
+        CHECK(key(before, sharif::LINE_HASH_KEY) != key(after, sharif::LINE_HASH_KEY));
+      }
+    }
+
+    WHEN("only whitespace and quoted names in the message change")
+    {
+      write_source("shift.cpp", "int main()\n{\n\tint   unused = 0;   \n}\n");
+      const auto after = fingerprint(make_result("shift.cpp", 3, "unused variable 'renamed'"));
+
+      THEN("the fingerprint is unchanged")
+      {
+        CHECK(key(before, sharif::FINGERPRINT_KEY) == key(after, sharif::FINGERPRINT_KEY));
+      }
+    }
+
+    WHEN("a different rule fires on the same line")
+    {
+      const auto other = fingerprint(make_result("shift.cpp", 3, "unused variable 'unused'", "other-rule"));
+
+      THEN("the fingerprint differs but the line hash does not")
+      {
+        CHECK(key(before, sharif::FINGERPRINT_KEY) != key(other, sharif::FINGERPRINT_KEY));
+        CHECK(key(before, sharif::LINE_HASH_KEY) == key(other, sharif::LINE_HASH_KEY));
+      }
+    }
+  }
+}
+
+SCENARIO("Identical lines are numbered in file order", "[fingerprint]")  // NOLINT
+{
+  GIVEN("a file with the same line three times")
+  {
+    write_source("dup.cpp", "x = 0;\ny = 1;\n  x = 0;\nz = 2;\nx   = 0;\n");
+
+    sharif::SourceCache   sources;
+    sharif::Fingerprinter hasher{ sources, ROOT.string() };
+
+    WHEN("only the last occurrence has a result")
+    {
+      std::vector results{ make_result("dup.cpp", 5, "m") };
+      hasher.apply(results);
+
+      THEN("its ordinal counts the identical lines above it, not the results")
+      {
+        CHECK(key(results[0], sharif::LINE_HASH_KEY).ends_with(":2"));
+      }
+    }
+
+    WHEN("every occurrence has a result, in any order")
+    {
+      std::vector results{ make_result("dup.cpp", 3, "m"), make_result("dup.cpp", 1, "m"), make_result("dup.cpp", 5, "m") };
+      hasher.apply(results);
+
+      THEN("each line gets its own ordinal with the same hash")
+      {
+        const auto third = key(results[0], sharif::LINE_HASH_KEY);
+        const auto first = key(results[1], sharif::LINE_HASH_KEY);
+        const auto fifth = key(results[2], sharif::LINE_HASH_KEY);
+        CHECK(first.ends_with(":1"));
+        CHECK(third.ends_with(":2"));
+        CHECK(fifth.ends_with(":3"));
+        CHECK(first.substr(0, 16) == fifth.substr(0, 16));
+        CHECK(key(results[0], sharif::FINGERPRINT_KEY) == key(results[1], sharif::FINGERPRINT_KEY));
+      }
+    }
+  }
+}
@@ -0,0 +1,68 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/util/line_buffer.hpp>
+
+/* Functions
+ ******************************************************************************/
+namespace {
+auto write(sharif::LineBuffer& buffer, std::string_view data) -> void
+{
+  auto space = buffer.prepare(data.size());
+  std::memcpy(space.data(), data.data(), data.size());
+  buffer.commit(data.size());
+}
+}  // namespace
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Complete lines are read in place", "[line_buffer]")  // NOLINT
+{
+  sharif::LineBuffer buffer{ 16 };
+
+  SECTION("Partial lines wait for their newline")
+  {
+    write(buffer, "first\nsec");
+    REQUIRE(buffer.lines() == "first");
+    REQUIRE_FALSE(buffer.lines());
+
+    write(buffer, "ond\nthird\n");
+    REQUIRE(buffer.lines() == "second\nthird");
+    REQUIRE(buffer.unread().empty());
+  }
+
+  SECTION("Empty lines are still lines")
+  {
+    write(buffer, "\n");
+    REQUIRE(buffer.lines() == "");
+  }
+
+  SECTION("A line longer than the buffer grows it")
+  {
+    const auto line = std::string(40, 'x');
+    write(buffer, line.substr(0, 10));
+    REQUIRE_FALSE(buffer.lines());
+    write(buffer, line.substr(10));
+    write(buffer, "\ntail");
+    REQUIRE(buffer.lines() == line);
+    REQUIRE(buffer.capacity() >= 40);
+    REQUIRE(buffer.rest() == "tail");
+  }
+
+  SECTION("The partial line is moved to make room")
+  {
+    write(buffer, "0123456789\nab");
+    REQUIRE(buffer.lines() == "0123456789");
+    write(buffer, "cdefghij\n");
+    REQUIRE(buffer.lines() == "abcdefghij");
+    REQUIRE(buffer.capacity() == 16);
+  }
+}
@@ -0,0 +1,438 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/parse/sarif.hpp>
+#include <sharif/parse/sarif_reader.hpp>
+#include <sharif/report/merge.hpp>
+#include <sharif/report/tables.hpp>
+#include <sharif/util/filesystem.hpp>
+
+/* Functions
+ ******************************************************************************/
+namespace {
+const auto ROOT = sharif::fs::temp_directory_path() / "sharif_merge";
+
+auto write_log(std::string_view name, std::string_view text) -> sharif::fs::path
+{
+  sharif::fs::create_directories(ROOT);
+  const auto    path = ROOT / name;
+  std::ofstream stream{ path, std::ios::binary };
+  stream << text;
+  return path;
+}
+
+struct Output {
+  sharif::sarif::Run                 run;
+  std::vector<sharif::sarif::Result> results;
+};
+
+/** Reads back what `Merger::write()` wrote, one entry per run. */
+auto read_output(std::string_view document) -> std::vector<Output>
+{
+  auto                  reader = sharif::SarifReader{ document };
+  std::vector<Output>   runs;
+  sharif::sarif::Result result;
+  while (reader.next_run().value())
+  {
+    runs.push_back({ .run = reader.run(), .results = {} });
+    while (reader.next_result(result).value())
+    {
+      runs.back().results.push_back(std::move(result));
+    }
+  }
+  return runs;
+}
+
+auto make_run(std::string driver) -> sharif::sarif::Run
+{
+  sharif::sarif::Run run;
+  run.tool.driver.name = std::move(driver);
+  return run;
+}
+
+auto make_rule(std::string id) -> sharif::sarif::ReportingDescriptor
+{
+  sharif::sarif::ReportingDescriptor rule;
+  rule.id = std::move(id);
+  return rule;
+}
+
+auto make_artifact(std::string uri) -> sharif::sarif::Artifact
+{
+  sharif::sarif::Artifact artifact;
+  artifact.location = sharif::sarif::ArtifactLocation{ .uri = std::move(uri) };
+  return artifact;
+}
+
+/** A result referencing rule and artifact `idx` of its run. */
+auto make_result(int32_t idx) -> sharif::sarif::Result
+{
+  sharif::sarif::Result result;
+  result.ruleIndex    = idx;
+  result.message.text = "message";
+
+  auto& location                                       = result.locations.emplace().emplace_back();
+  location.physicalLocation.emplace().artifactLocation = sharif::sarif::ArtifactLocation{ .index = idx };
+  return result;
+}
+
+auto artifact_index(const sharif::sarif::Result& result) -> int32_t
+{
+  return sharif::sarif::primary_location(result)->artifactLocation->index.value_or(-1);
+}
+}  // namespace
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Rule and artifact tables store each entry once", "[merge]")  // NOLINT
+{
+  GIVEN("a rule table")
+  {
+    sharif::RuleTable rules;
+    REQUIRE(rules.add(make_rule("a")) == 0);
+    REQUIRE(rules.add("b") == 1);
+
+    THEN("known ids map to their first index")
+    {
+      CHECK(rules.add(make_rule("a")) == 0);
+      CHECK(rules.add("b") == 1);
+      CHECK(rules.find("b") == 1);
+      CHECK(rules.find("c") == -1);
+      CHECK(rules.size() == 2);
+    }
+  }
+
+  GIVEN("an artifact table")
+  {
+    sharif::ArtifactTable artifacts;
+    REQUIRE(artifacts.add(make_artifact("a.cpp")) == 0);
+
+    THEN("locations are keyed by URI and base id")
+    {
+      CHECK(artifacts.add(sharif::sarif::ArtifactLocation{ .uri = "a.cpp" }) == 0);
+      CHECK(artifacts.add(sharif::sarif::ArtifactLocation{ .uri = "a.cpp", .uriBaseId = "SRCROOT" }) == 1);
+      CHECK(artifacts.add(sharif::sarif::ArtifactLocation{}) == -1);
+      CHECK(artifacts.artifacts()[1].location->index == 1);
+    }
+  }
+
+  GIVEN("two runs whose tables overlap in a different order")
+  {
+    auto first               = make_run("gcc");
+    first.tool.driver.rules  = std::vector{ make_rule("a"), make_rule("b") };
+    first.artifacts          = std::vector{ make_artifact("a.cpp"), make_artifact("b.cpp") };
+    auto second              = make_run("gcc");
+    second.tool.driver.rules = std::vector{ make_rule("b"), make_rule("c") };
+    second.artifacts         = std::vector{ make_artifact("b.cpp"), make_artifact("c.cpp") };
+
+    sharif::RunTables tables;
+    const auto        first_map  = sharif::absorb_tables(first, tables);
+    const auto        second_map = sharif::absorb_tables(second, tables);
+
+    THEN("the second run's indices are remapped into the shared tables")
+    {
+      CHECK(first_map.rules == std::vector<int32_t>{ 0, 1 });
+      CHECK(second_map.rules == std::vector<int32_t>{ 1, 2 });
+      CHECK(second_map.artifacts == std::vector<int32_t>{ 1, 2 });
+      CHECK_FALSE(second.tool.driver.rules);
+      CHECK_FALSE(second.artifacts);
+
+      auto result = make_result(1);
+      sharif::reindex(result, second_map, tables);
+      CHECK(result.ruleIndex == 2);
+      CHECK(tables.rules.rules()[2].id == "c");
+      CHECK(result.ruleId == "c");
+      CHECK(artifact_index(result) == 2);
+    }
+  }
+}
+
+SCENARIO("SARIF logs are merged into one run per tool", "[merge]")  // NOLINT
+{
+  GIVEN("shards of two tools, some of them clean")
+  {
+    const auto a = write_log("a.sarif", R"({ "version": "2.1.0", "runs": [
+      { "tool": { "driver": { "name": "clang-tidy", "rules": [ { "id": "misc-unused" }, { "id": "bugprone-x" } ] } },
+        "artifacts": [ { "location": { "uri": "a.cpp" } } ],
+        "results": [
+          { "ruleId": "bugprone-x", "ruleIndex": 1, "message": { "text": "x" },
+            "locations": [ { "physicalLocation": { "artifactLocation": { "uri": "a.cpp", "index": 0 } } } ] }
+        ] },
+      { "tool": { "driver": { "name": "cppcheck" } }, "results": [] }
+    ] })");
+    const auto b = write_log("b.sarif", R"({ "version": "2.1.0", "runs": [
+      { "tool": { "driver": { "name": "clang-tidy", "rules": [ { "id": "bugprone-x" }, { "id": "misc-other" } ] } },
+        "artifacts": [ { "location": { "uri": "b.cpp" } }, { "location": { "uri": "a.cpp" } } ],
+        "results": [
+          { "ruleId": "bugprone-x", "ruleIndex": 0, "message": { "text": "y" },
+            "locations": [ { "physicalLocation": { "artifactLocation": { "uri": "a.cpp", "index": 1 } } } ] },
+          { "ruleId": "misc-other", "ruleIndex": 1, "message": { "text": "z" },
+            "locations": [ { "physicalLocation": { "artifactLocation": { "uri": "b.cpp", "index": 0 } } } ] }
+        ] }
+    ] })");
+    const auto clean = write_log("clean.sarif", R"({ "version": "2.1.0", "runs": [
+      { "tool": { "driver": { "name": "gcc" } } }
+    ] })");
+
+    auto merger = sharif::Merger{};
+    auto count  = merger.with_jobs(2).read({ a, b, clean });
+    REQUIRE(count);
+    CHECK(*count == 3);
+    REQUIRE(merger.runs() == 3);
+
+    std::ostringstream out;
+    REQUIRE(merger.write(out));
+    const auto runs = read_output(out.str());
+
+    THEN("runs without results are kept, in order of first appearance")
+    {
+      REQUIRE(runs.size() == 3);
+      CHECK(runs[0].run.tool.driver.name == "clang-tidy");
+      CHECK(runs[1].run.tool.driver.name == "cppcheck");
+      CHECK(runs[1].results.empty());
+      CHECK(runs[2].run.tool.driver.name == "gcc");
+      CHECK(runs[2].results.empty());
+    }
+
+    THEN("every result references the shared rule and artifact it had before")
+    {
+      const auto& merged = runs[0];
+      REQUIRE(merged.results.size() == 3);
+      REQUIRE(merged.run.tool.driver.rules->size() == 3);
+      REQUIRE(merged.run.artifacts->size() == 2);
+
+      for (const auto& result : merged.results)
+      {
+        const auto& rule     = merged.run.tool.driver.rules->at(static_cast<size_t>(*result.ruleIndex));
+        const auto& artifact = merged.run.artifacts->at(static_cast<size_t>(artifact_index(result)));
+        CHECK(rule.id == result.ruleId);
+        CHECK(artifact.location->uri == sharif::sarif::primary_location(result)->artifactLocation->uri);
+      }
+    }
+  }
+
+  GIVEN("shards whose results reference artifacts from code flows, fixes and attachments, and extension rules")
+  {
+    const auto shard = [](std::string_view artifacts, std::string_view rules) {
+      return std::string{ R"({ "version": "2.1.0", "runs": [
+      { "tool": { "driver": { "name": "analyzer" },
+                  "extensions": [ { "name": "plugin", "rules": [ )" } + std::string{ rules } + R"( ] } ] },
+        "artifacts": [ )" + std::string{ artifacts } + R"( ],
+        "results": [
+          { "rule": { "index": 1, "toolComponent": { "index": 0 } }, "message": { "text": "flow" },
+            "analysisTarget": { "index": 1 },
+            "locations": [ { "physicalLocation": { "artifactLocation": { "index": 0 } } } ],
+            "codeFlows": [ { "threadFlows": [ { "locations": [
+              { "location": { "physicalLocation": { "artifactLocation": { "index": 1 } } } },
+              { "location": { "physicalLocation": { "artifactLocation": { "index": 0 } } } } ] } ] } ],
+            "attachments": [ { "artifactLocation": { "index": 1 } } ],
+            "fixes": [ { "artifactChanges": [ { "artifactLocation": { "index": 0 }, "replacements": [] } ] } ] }
+        ] }
+    ] })";
+    };
+    const auto a = write_log("flow_a.sarif", shard(R"({ "location": { "uri": "a.cpp" } }, { "location": { "uri": "b.cpp" } })", R"({ "id": "p-x" }, { "id": "p-y" })"));
+    const auto b = write_log("flow_b.sarif", shard(R"({ "location": { "uri": "c.cpp" } }, { "location": { "uri": "a.cpp" } })", R"({ "id": "p-z" }, { "id": "p-x" })"));
+
+    auto merger = sharif::Merger{};
+    REQUIRE(merger.read({ a, b }));
+    std::ostringstream out;
+    REQUIRE(merger.write(out));
+    const auto runs = read_output(out.str());
+    REQUIRE(runs.size() == 1);
+
+    THEN("every artifact index resolves to the file it named in its own log")
+    {
+      const auto& run     = runs[0].run;
+      const auto& results = runs[0].results;
+      REQUIRE(results.size() == 2);
+      REQUIRE(run.artifacts->size() == 3);
+
+      const auto uri = [&](const sharif::sarif::ArtifactLocation& location) {
+        return *run.artifacts->at(static_cast<size_t>(*location.index)).location->uri;
+      };
+      const auto flow = [](const sharif::sarif::Result& result, size_t step) -> const sharif::sarif::ArtifactLocation& {
+        return *result.codeFlows->front().threadFlows.front().locations[step].location->physicalLocation->artifactLocation;
+      };
+      for (const auto& [result, first, second] : { std::tuple{ &results[0], "a.cpp", "b.cpp" }, std::tuple{ &results[1], "c.cpp", "a.cpp" } })
+      {
+        CHECK(uri(*sharif::sarif::primary_location(*result)->artifactLocation) == first);
+        CHECK(uri(*result->analysisTarget) == second);
+        CHECK(uri(flow(*result, 0)) == second);
+        CHECK(uri(flow(*result, 1)) == first);
+        CHECK(uri(result->attachments->front().artifactLocation) == second);
+        CHECK(uri(result->fixes->front().artifactChanges.front().artifactLocation) == first);
+      }
+    }
+
+    THEN("the extension is stored once and each rule reference resolves to its rule")
+    {
+      const auto& run     = runs[0].run;
+      const auto& results = runs[0].results;
+      REQUIRE(run.tool.extensions->size() == 1);
+      const auto& rules = *run.tool.extensions->front().rules;
+      REQUIRE(rules.size() == 3);
+
+      for (const auto& [result, id] : { std::pair{ &results[0], "p-y" }, std::pair{ &results[1], "p-x" } })
+      {
+        CHECK(result->rule->toolComponent->index == 0);
+        CHECK(rules.at(static_cast<size_t>(*result->rule->index)).id == id);
+        CHECK(result->ruleId == id);
+      }
+    }
+  }
+
+  GIVEN("runs of one tool whose column kinds and base ids agree or conflict")
+  {
+    const auto run = [](std::string_view kind, std::string_view base, std::string_view root, std::string_view command) {
+      auto value       = make_run("gcc");
+      value.columnKind = std::string{ kind };
+      value.originalUriBaseIds.emplace();
+      value.originalUriBaseIds->try_emplace(std::string{ base }, sharif::sarif::ArtifactLocation{ .uri = std::string{ root } });
+
+      value.invocations.emplace().emplace_back().commandLine = std::string{ command };
+      auto& result                                = value.results.emplace().emplace_back(make_result(-1));
+      result.ruleId                               = "warning";
+      result.provenance.emplace().invocationIndex = 0;
+      return value;
+    };
+
+    auto merger = sharif::Merger{};
+    merger.add(run("unicodeCodePoints", "SRCROOT", "file:///src/", "gcc a.cpp"));
+    merger.add(run("unicodeCodePoints", "BUILD", "file:///build/", "gcc b.cpp"));
+    merger.add(run("utf16CodeUnits", "SRCROOT", "file:///src/", "gcc c.cpp"));
+    merger.add(run("unicodeCodePoints", "SRCROOT", "file:///elsewhere/", "gcc d.cpp"));
+    REQUIRE(merger.runs() == 3);
+
+    std::ostringstream out;
+    REQUIRE(merger.write(out));
+    const auto runs = read_output(out.str());
+    REQUIRE(runs.size() == 3);
+
+    THEN("compatible runs share a run with the base ids and invocations of both")
+    {
+      const auto& merged = runs[0];
+      CHECK(merged.run.columnKind == "unicodeCodePoints");
+      REQUIRE(merged.run.originalUriBaseIds);
+      CHECK(merged.run.originalUriBaseIds->at("SRCROOT").uri == "file:///src/");
+      CHECK(merged.run.originalUriBaseIds->at("BUILD").uri == "file:///build/");
+
+      REQUIRE(merged.run.invocations->size() == 2);
+      REQUIRE(merged.results.size() == 2);
+      for (size_t idx = 0; idx < merged.results.size(); ++idx)
+      {
+        CHECK(merged.results[idx].provenance->invocationIndex == static_cast<int32_t>(idx));
+      }
+      CHECK(merged.run.invocations->at(1).commandLine == "gcc b.cpp");
+    }
+
+    THEN("runs counting columns differently or redefining a base id are kept apart")
+    {
+      CHECK(runs[1].run.columnKind == "utf16CodeUnits");
+      CHECK(runs[1].run.invocations->front().commandLine == "gcc c.cpp");
+      CHECK(runs[2].run.originalUriBaseIds->at("SRCROOT").uri == "file:///elsewhere/");
+      CHECK(runs[2].results.front().provenance->invocationIndex == 0);
+    }
+  }
+
+  GIVEN("a log that is not SARIF")
+  {
+    const auto broken = write_log("broken.sarif", R"({ "runs": [ { "results": [ )");
+
+    THEN("reading fails")
+    {
+      CHECK_FALSE(sharif::Merger{}.read({ broken }));
+    }
+  }
+}
+
+SCENARIO("Compacted runs keep every reference resolvable", "[merge]")  // NOLINT
+{
+  GIVEN("a run whose results repeat rules and files, some already in its tables")
+  {
+    auto run              = make_run("clang-tidy");
+    run.tool.driver.rules = std::vector{ make_rule("misc-unused"), make_rule("never-reported") };
+    run.artifacts         = std::vector{ make_artifact("b.cpp") };
+
+    std::vector<sharif::sarif::Result> original;
+    for (const auto* file : { "a.cpp", "b.cpp", "a.cpp", "c.cpp" })
+    {
+      for (const auto* rule : { "misc-unused", "bugprone-x" })
+      {
+        auto& result        = original.emplace_back();
+        result.ruleId       = rule;
+        result.message.text = "message";
+
+        auto& location = result.locations.emplace().emplace_back();
+        location.physicalLocation.emplace().artifactLocation = sharif::sarif::ArtifactLocation{ .uri = file };
+        auto& related = result.relatedLocations.emplace().emplace_back();
+        related.physicalLocation.emplace().artifactLocation = sharif::sarif::ArtifactLocation{ .uri = "common.h" };
+      }
+    }
+    run.results = original;
+
+    WHEN("it is compacted, written and read back")
+    {
+      sharif::compact(run);
+      auto log = sharif::Sarif{};
+      log.runs.push_back(std::move(run));
+
+      std::string buffer;
+      REQUIRE(log.write(buffer));
+      const auto runs = read_output(buffer);
+      REQUIRE(runs.size() == 1);
+
+      const auto& rules     = *runs[0].run.tool.driver.rules;
+      const auto& artifacts = *runs[0].run.artifacts;
+      const auto& results   = runs[0].results;
+
+      THEN("each rule and file is stored once")
+      {
+        CHECK(rules.size() == 3);
+        CHECK(artifacts.size() == 4);
+      }
+
+      THEN("every result resolves to the rule and files it referenced by name")
+      {
+        REQUIRE(results.size() == original.size());
+        for (size_t i = 0; i < results.size(); ++i)
+        {
+          const auto& result = results[i];
+          REQUIRE(result.ruleIndex);
+          CHECK(rules.at(static_cast<size_t>(*result.ruleIndex)).id == original[i].ruleId);
+
+          const auto& location = *sharif::sarif::primary_location(result)->artifactLocation;
+          CHECK_FALSE(location.uri);
+          CHECK(artifacts.at(static_cast<size_t>(*location.index)).location->uri == sharif::sarif::primary_location(original[i])->artifactLocation->uri);
+
+          const auto& related = *result.relatedLocations->front().physicalLocation->artifactLocation;
+          CHECK_FALSE(related.uri);
+          CHECK(artifacts.at(static_cast<size_t>(*related.index)).location->uri == "common.h");
+        }
+      }
+    }
+  }
+
+  GIVEN("a result whose location is not in the artifact table")
+  {
+    auto result = make_result(-1);
+    sharif::sarif::primary_location(result)->artifactLocation->uri = "a.cpp";
+
+    THEN("stripping keeps its URI, the only reference it has")
+    {
+      sharif::strip_indexed_uris(result);
+      CHECK(sharif::sarif::primary_location(result)->artifactLocation->uri == "a.cpp");
+    }
+  }
+}
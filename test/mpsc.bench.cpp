@@ -0,0 +1,175 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 3rd
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/util/mpsc_queue.hpp>
+#include <sharif/util/object_pool.hpp>
+
+/* Constants
+ ******************************************************************************/
+constexpr size_t PRODUCERS = 64;
+constexpr size_t ITEMS     = 2000;
+
+/* Types
+ ******************************************************************************/
+namespace {
+/// What the queue replaces: a vector behind a mutex, swapped out whole by the consumer.
+template <typename T>
+class LockedQueue {
+public:
+  auto try_push(T& value) -> bool
+  {
+    std::lock_guard lock{ _mutex };
+    _items.push_back(std::move(value));
+    return true;
+  }
+
+  auto drain(std::vector<T>& out) -> void
+  {
+    out.clear();
+    std::lock_guard lock{ _mutex };
+    out.swap(_items);
+  }
+
+private:
+  std::mutex     _mutex;
+  std::vector<T> _items;
+};
+}  // namespace
+
+/* Functions
+ ******************************************************************************/
+namespace {
+/** Has `PRODUCERS` threads push `ITEMS` lines each through `Queue` to the calling thread.
+ * @returns the number of bytes received.
+ */
+template <typename Queue, typename Make, typename Done>
+auto transfer(Queue& queue, Make make, Done done) -> size_t
+{
+  std::vector<std::jthread> producers;
+  for (size_t p = 0; p < PRODUCERS; ++p)
+  {
+    producers.emplace_back([&queue, &make] {
+      for (size_t i = 0; i < ITEMS; ++i)
+      {
+        auto line = make();
+        while (!queue.try_push(line))
+        {
+          std::this_thread::yield();
+        }
+      }
+    });
+  }
+
+  size_t bytes    = 0;
+  size_t received = 0;
+  if constexpr (requires(std::vector<std::string> out) { queue.drain(out); })
+  {
+    std::vector<std::string> batch;
+    while (received < PRODUCERS * ITEMS)
+    {
+      queue.drain(batch);
+      if (batch.empty())
+      {
+        std::this_thread::yield();
+      }
+      for (auto& line : batch)
+      {
+        bytes += line.size();
+        done(std::move(line));
+      }
+      received += batch.size();
+    }
+  }
+  else
+  {
+    while (received < PRODUCERS * ITEMS)
+    {
+      if (auto line = queue.try_pop())
+      {
+        bytes += line->size();
+        done(std::move(*line));
+        ++received;
+      }
+      else
+      {
+        std::this_thread::yield();
+      }
+    }
+  }
+  return bytes;
+}
+
+auto fresh_line() -> std::string
+{
+  return std::string(80, 'x');
+}
+
+auto pooled_line() -> std::string
+{
+  auto line = sharif::ObjectPool<std::string>::take();
+  line.assign(80, 'x');
+  return line;
+}
+}  // namespace
+
+/* Benchmarks
+ ******************************************************************************/
+TEST_CASE("Handing 64 x 2000 lines to one consumer", "[!benchmark][mpsc]")  // NOLINT
+{
+  auto drop    = [](std::string&&) {};
+  auto recycle = [](std::string&& line) { sharif::ObjectPool<std::string>::give(std::move(line)); };
+
+  BENCHMARK("mutex + vector")
+  {
+    LockedQueue<std::string> queue;
+    return transfer(queue, fresh_line, drop);
+  };
+
+  BENCHMARK("MpscQueue")
+  {
+    sharif::MpscQueue<std::string> queue{ 1024 };
+    return transfer(queue, fresh_line, drop);
+  };
+
+  BENCHMARK("MpscQueue + ObjectPool")
+  {
+    sharif::MpscQueue<std::string> queue{ 1024 };
+    return transfer(queue, pooled_line, recycle);
+  };
+}
+
+TEST_CASE("Taking and giving back strings on one thread", "[!benchmark][mpsc]")  // NOLINT
+{
+  BENCHMARK("new std::string")
+  {
+    size_t bytes = 0;
+    for (size_t i = 0; i < ITEMS; ++i)
+    {
+      bytes += fresh_line().size();
+    }
+    return bytes;
+  };
+
+  BENCHMARK("ObjectPool<std::string>")
+  {
+    size_t bytes = 0;
+    for (size_t i = 0; i < ITEMS; ++i)
+    {
+      auto line = pooled_line();
+      bytes += line.size();
+      sharif::ObjectPool<std::string>::give(std::move(line));
+    }
+    return bytes;
+  };
+}
@@ -0,0 +1,137 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/util/mpsc_queue.hpp>
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("An MpscQueue is bounded and first-in first-out", "[mpsc_queue]")  // NOLINT
+{
+  GIVEN("a queue of capacity 3")
+  {
+    sharif::MpscQueue<std::string> queue{ 3 };
+
+    THEN("the capacity is rounded up to a power of two")
+    {
+      CHECK(queue.capacity() == 4);
+    }
+
+    WHEN("it is filled")
+    {
+      for (int i = 0; i < 4; ++i)
+      {
+        REQUIRE(queue.try_push(std::to_string(i)));
+      }
+
+      THEN("further pushes fail and keep their value")
+      {
+        std::string value = "rejected";
+        CHECK_FALSE(queue.try_push(value));
+        CHECK(value == "rejected");
+      }
+
+      THEN("elements come out in order, then it is empty")
+      {
+        for (int i = 0; i < 4; ++i)
+        {
+          CHECK(queue.try_pop() == std::to_string(i));
+        }
+        CHECK(queue.empty());
+        CHECK_FALSE(queue.try_pop());
+      }
+    }
+  }
+
+  GIVEN("a queue left with elements in it")
+  {
+    auto counter = std::make_shared<int>(0);
+    {
+      sharif::MpscQueue<std::shared_ptr<int>> queue{ 8 };
+      queue.try_push(std::shared_ptr<int>{ counter });
+      queue.try_push(std::shared_ptr<int>{ counter });
+      REQUIRE(counter.use_count() == 3);
+    }
+
+    THEN("destroying it destroys them")
+    {
+      CHECK(counter.use_count() == 1);
+    }
+  }
+}
+
+SCENARIO("An MpscQueue under contention loses and reorders nothing", "[mpsc_queue]")  // NOLINT
+{
+  // Run with SHARIF_TSAN=ON to check the slot handoff, not just the totals
+  constexpr uint32_t PRODUCERS = 64;
+  constexpr uint32_t ITEMS     = 2000;
+
+  GIVEN("64 producers sharing a queue much smaller than their output")
+  {
+    sharif::MpscQueue<std::string> queue{ 64 };
+    std::atomic<bool>              start{ false };
+    std::vector<std::jthread>      producers;
+    for (uint32_t p = 0; p < PRODUCERS; ++p)
+    {
+      producers.emplace_back([&, p] {
+        while (!start.load(std::memory_order_acquire))
+        {
+          std::this_thread::yield();
+        }
+        for (uint32_t i = 0; i < ITEMS; ++i)
+        {
+          // Heap-allocated payloads, so a torn handoff shows up as a data race
+          auto item = std::to_string(p) + ':' + std::to_string(i) + std::string(32, 'x');
+          while (!queue.try_push(item))
+          {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+
+    WHEN("a single consumer drains it while they push")
+    {
+      std::vector<uint32_t> next(PRODUCERS, 0);
+      size_t                received = 0;
+      bool                  in_order = true;
+      start.store(true, std::memory_order_release);
+      while (received < PRODUCERS * ITEMS)
+      {
+        auto item = queue.try_pop();
+        if (!item)
+        {
+          std::this_thread::yield();
+          continue;
+        }
+        const auto colon    = item->find(':');
+        const auto producer = std::stoul(item->substr(0, colon));
+        const auto index    = std::stoul(item->substr(colon + 1));
+        in_order            = in_order && index == next[producer];
+        next[producer]      = index + 1;
+        ++received;
+      }
+
+      THEN("every item arrives exactly once, in each producer's order")
+      {
+        CHECK(in_order);
+        CHECK(queue.empty());
+        for (uint32_t p = 0; p < PRODUCERS; ++p)
+        {
+          CHECK(next[p] == ITEMS);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,128 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/parse/diagnostic.hpp>
+#include <sharif/util/mpsc_queue.hpp>
+#include <sharif/util/object_pool.hpp>
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("An ObjectPool hands back cleared objects with their buffers", "[object_pool]")  // NOLINT
+{
+  sharif::ObjectPool<std::string>::trim();
+  sharif::ObjectPool<sharif::Diagnostic>::trim();
+
+  GIVEN("an empty pool")
+  {
+    THEN("take() default-constructs")
+    {
+      CHECK(sharif::ObjectPool<std::string>::take().empty());
+    }
+  }
+
+  GIVEN("a string given back to the pool")
+  {
+    std::string text(1000, 'x');
+    const auto* buffer = text.data();
+    sharif::ObjectPool<std::string>::give(std::move(text));
+
+    WHEN("a string is taken on the same thread")
+    {
+      auto reused = sharif::ObjectPool<std::string>::take();
+
+      THEN("it is the same buffer, emptied")
+      {
+        CHECK(reused.empty());
+        CHECK(reused.capacity() >= 1000);
+        CHECK(reused.data() == buffer);
+      }
+    }
+  }
+
+  GIVEN("a diagnostic given back to the pool")
+  {
+    auto diagnostic = *sharif::Diagnostic::from_string("file.cpp:10:8: warning: unused variable 'x' [-Wunused-variable]\n");
+    sharif::ObjectPool<sharif::Diagnostic>::give(std::move(diagnostic));
+
+    THEN("it comes back with every field cleared")
+    {
+      auto reused = sharif::ObjectPool<sharif::Diagnostic>::take();
+      CHECK(reused.file.empty());
+      CHECK(reused.line == 0);
+      CHECK(reused.column == 0);
+      CHECK(reused.message.empty());
+      CHECK(reused.category.empty());
+      CHECK(reused.message.capacity() > 0);
+    }
+  }
+}
+
+SCENARIO("Objects flow between threads through an ObjectPool", "[object_pool]")  // NOLINT
+{
+  // Run with SHARIF_TSAN=ON to check the depot handoff
+  using Pool                 = sharif::ObjectPool<std::string>;
+  constexpr size_t PRODUCERS = 16;
+  constexpr size_t ITEMS     = 2000;
+  Pool::trim();
+
+  GIVEN("producers taking strings and a consumer giving them back")
+  {
+    sharif::MpscQueue<std::string> queue{ 256 };
+    std::atomic<size_t>            reused{ 0 };
+    std::vector<std::jthread>      producers;
+    for (size_t p = 0; p < PRODUCERS; ++p)
+    {
+      producers.emplace_back([&] {
+        for (size_t i = 0; i < ITEMS; ++i)
+        {
+          auto text = Pool::take();
+          if (text.capacity() >= 100)
+          {
+            reused.fetch_add(1, std::memory_order_relaxed);
+          }
+          text.assign(100, 'x');
+          while (!queue.try_push(text))
+          {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+
+    WHEN("the consumer drains the queue")
+    {
+      size_t received = 0;
+      bool   intact   = true;
+      while (received < PRODUCERS * ITEMS)
+      {
+        if (auto text = queue.try_pop())
+        {
+          intact = intact && *text == std::string(100, 'x');
+          Pool::give(std::move(*text));
+          ++received;
+        }
+        else
+        {
+          std::this_thread::yield();
+        }
+      }
+      producers.clear();
+
+      THEN("every string arrives intact and buffers make it back to the producers")
+      {
+        CHECK(intact);
+        CHECK(reused > 0);
+      }
+    }
+  }
+}
@@ -1,6 +1,9 @@
 /* Includes
  ******************************************************************************/
 // std
+#include <cstddef>
+#include <string>
+#include <vector>
 
 // 3rd
 #include <catch2/catch_test_macros.hpp>
@@ -8,6 +11,59 @@
 // local
 #include <sharif/parse/parser.hpp>
 
+/* Functions
+ ******************************************************************************/
+namespace {
+using sharif::Parser;
+
+/** Every string of up to `length` chars drawn from `alphabet`. */
+auto all_strings(std::string_view alphabet, size_t length) -> std::vector<std::string>
+{
+  std::vector<std::string> strings{ "" };
+  for (size_t begin = 0, n = 0; n < length; ++n)
+  {
+    const auto end = strings.size();
+    for (auto i = begin; i < end; ++i)
+    {
+      for (const auto chr : alphabet)
+      {
+        strings.push_back(strings[i] + chr);
+      }
+    }
+    begin = end;
+  }
+  return strings;
+}
+
+/** @returns whether `consume<Delimiter, Opts>()` and `consume_uint<Delimiter, Opts>()` read
+ * `source` token by token exactly like the runtime builder calls in `build`.
+ */
+template <sharif::FixedString Delimiter, Parser::Options Opts, typename Build>
+auto same_as_builder(std::string_view source, Build build) -> bool
+{
+  auto runtime  = Parser{ source };
+  auto compiled = Parser{ source };
+  for (size_t i = 0; i <= source.size(); ++i)
+  {
+    if (build(runtime).consume_str() != compiled.template consume<Delimiter, Opts>() || runtime.pos() != compiled.pos())
+    {
+      return false;
+    }
+  }
+
+  runtime  = Parser{ source };
+  compiled = Parser{ source };
+  for (size_t i = 0; i <= source.size(); ++i)
+  {
+    if (build(runtime).consume_uint() != compiled.template consume_uint<Delimiter, Opts>() || runtime.pos() != compiled.pos())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace
+
 /* Tests
  ******************************************************************************/
 SCENARIO("to_lower", "[parser]")  // NOLINT
@@ -183,3 +239,130 @@ SCENARIO("Parser", "[example]")  // NOLINT
   REQUIRE("mismatching types: 'int' and 'const char *'" == str);
   REQUIRE(parse.string() == "");
 }
+
+SCENARIO("Parser with compile-time delimiters", "[consume]")  // NOLINT
+{
+  using sharif::Parser;
+
+  GIVEN("a diagnostic line")
+  {
+    auto parse = Parser("test-labelled-ranges.c:9:6: error: mismatching types: 'int' and 'const char *'");
+
+    THEN("it parses like the runtime builder")
+    {
+      REQUIRE("test-labelled-ranges.c" == parse.consume<":", Parser::PASS | Parser::RTRIM>());
+      REQUIRE(9 == parse.consume_uint<":", Parser::PASS | Parser::RTRIM>());
+      REQUIRE(6 == parse.consume_uint<":", Parser::PASS | Parser::RTRIM>());
+      REQUIRE("error" == parse.consume<":", Parser::PASS | Parser::RTRIM>());
+      REQUIRE("mismatching types: 'int' and 'const char *'" == parse.consume<"">());
+      REQUIRE(parse.string() == "");
+      REQUIRE_FALSE(parse.consume<":">());
+    }
+  }
+
+  GIVEN("mixed line endings")
+  {
+    auto parse = Parser("Hello\r\nWorld\nAnd\rGoodbye\n\n");
+
+    THEN("an empty delimiter with TO_CRLF reads line by line")
+    {
+      REQUIRE("Hello" == parse.consume<"", Parser::TO_CRLF>());
+      REQUIRE("World" == parse.consume<"", Parser::TO_CRLF>());
+      REQUIRE("And" == parse.consume<"", Parser::TO_CRLF>());
+      REQUIRE("Goodbye" == parse.consume<"", Parser::TO_CRLF>());
+      REQUIRE("" == parse.consume<"", Parser::TO_CRLF>());
+      REQUIRE_FALSE(parse.consume<"", Parser::TO_CRLF>());
+    }
+  }
+
+  GIVEN("a path")
+  {
+    auto parse = Parser("  foo::bar/baz.h");
+
+    WHEN("consuming until a multi-char delimiter, including it")
+    {
+      auto str = parse.consume<"::", Parser::INCLUDE | Parser::LTRIM>();
+
+      THEN("the delimiter is part of the result")
+      {
+        REQUIRE("foo::" == str);
+        REQUIRE("bar/baz.h" == parse.string());
+      }
+    }
+
+    WHEN("consuming until a single char without passing it")
+    {
+      parse.skip(2);
+      auto str = parse.consume<"/">();
+
+      THEN("the cursor stops on the delimiter")
+      {
+        REQUIRE("foo::bar" == str);
+        REQUIRE("/baz.h" == parse.string());
+      }
+    }
+
+    WHEN("the delimiter never occurs")
+    {
+      auto str = parse.consume<"#", Parser::LTRIM>();
+
+      THEN("the rest of the input is consumed")
+      {
+        REQUIRE("foo::bar/baz.h" == str);
+        REQUIRE(parse.string().empty());
+      }
+    }
+  }
+
+  GIVEN("a number followed by other text")
+  {
+    auto parse = Parser("10abc: rest");
+
+    THEN("consume_uint stops at the first non-digit, like consume_uint()")
+    {
+      REQUIRE(10 == parse.consume_uint<":", Parser::PASS>());
+      REQUIRE("abc: rest" == parse.string());
+    }
+  }
+}
+
+SCENARIO("Compile-time delimiters parse like the runtime builder", "[consume]")  // NOLINT
+{
+  GIVEN("every short string of delimiters, digits, blanks and line endings")
+  {
+    const auto strings = all_strings("a1 :\t\n\r", 5);
+
+    THEN("each option matches its builder call, with 1-char and multi-char delimiters")
+    {
+      for (const auto& source : strings)
+      {
+        INFO("source: '" << source << "'");
+        CHECK(same_as_builder<":", Parser::DEFAULT>(source, [](Parser& p) -> Parser& { return p.until(":"); }));
+        CHECK(same_as_builder<":a", Parser::DEFAULT>(source, [](Parser& p) -> Parser& { return p.until(":a"); }));
+        CHECK(same_as_builder<":", Parser::PASS>(source, [](Parser& p) -> Parser& { return p.until_and_past(":"); }));
+        CHECK(same_as_builder<"::", Parser::PASS>(source, [](Parser& p) -> Parser& { return p.until_and_past("::"); }));
+        CHECK(same_as_builder<":", Parser::INCLUDE>(source, [](Parser& p) -> Parser& { return p.until_and_including(":"); }));
+        CHECK(same_as_builder<":a", Parser::INCLUDE>(source, [](Parser& p) -> Parser& { return p.until_and_including(":a"); }));
+        CHECK(same_as_builder<"", Parser::TO_CRLF>(source, [](Parser& p) -> Parser& { return p.to_newline().to_eof(); }));
+        CHECK(same_as_builder<":", Parser::PASS | Parser::TO_CRLF>(source, [](Parser& p) -> Parser& { return p.until_and_past(":").to_newline(); }));
+        CHECK(same_as_builder<"::", Parser::PASS | Parser::TO_CRLF>(source, [](Parser& p) -> Parser& { return p.until_and_past("::").to_newline(); }));
+        CHECK(same_as_builder<":", Parser::PASS | Parser::RTRIM>(source, [](Parser& p) -> Parser& { return p.until_and_past(":").and_rtrim(); }));
+        CHECK(same_as_builder<":", Parser::PASS | Parser::LTRIM>(source, [](Parser& p) -> Parser& { return p.until_and_past(":").and_ltrim(); }));
+        CHECK(same_as_builder<":a", Parser::INCLUDE | Parser::LTRIM | Parser::RTRIM>(source, [](Parser& p) -> Parser& { return p.until_and_including(":a").and_trim(); }));
+      }
+    }
+  }
+
+  GIVEN("options left pending by the builder")
+  {
+    auto parse = Parser("a: b:c");
+    parse.until_and_past(":").and_rtrim();
+
+    THEN("a compile-time consume ignores them and clears them")
+    {
+      REQUIRE("a:" == parse.consume<" ">());
+      REQUIRE(" b" == parse.until(":").consume_str());
+      REQUIRE(":c" == parse.string());
+    }
+  }
+}
@@ -0,0 +1,185 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/util/pipeline.hpp>
+#include <sharif/util/thread_pool.hpp>
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Items flow through the stages of a pipeline", "[pipeline]")  // NOLINT
+{
+  sharif::ThreadPool pool{ 4 };
+
+  GIVEN("parse, filter and dedup stages feeding a sink, with small queues")
+  {
+    sharif::Pipeline             pipeline{ pool, 8 };
+    std::vector<uint32_t>        output;
+    std::unordered_set<uint32_t> seen;
+
+    auto& collect = pipeline.sink<uint32_t>([&](uint32_t&& value) { output.push_back(value); });
+    auto& dedup   = pipeline.stage<uint32_t>(collect, [&](uint32_t&& value, sharif::Node<uint32_t>& next) {
+      if (seen.insert(value).second)
+      {
+        next.push(value);
+      }
+    });
+    auto& filter  = pipeline.stage<uint32_t>(dedup, [](uint32_t&& value, sharif::Node<uint32_t>& next) {
+      if (value % 3 == 0)
+      {
+        next.push(value);
+      }
+    });
+    auto& parse   = pipeline.stage<std::string>(filter, [](std::string&& line, sharif::Node<uint32_t>& next) {
+      uint32_t value = 0;
+      std::from_chars(line.data(), line.data() + line.size(), value);
+      next.push(value);
+    });
+
+    WHEN("lines are pushed from outside the pool and the input is closed")
+    {
+      for (uint32_t i = 0; i < 2000; ++i)
+      {
+        parse.push(std::to_string(i % 1000));
+      }
+      parse.close();
+      pipeline.wait();
+
+      THEN("every stage saw its input in order")
+      {
+        REQUIRE(output.size() == 334);
+        CHECK(std::ranges::is_sorted(output));
+        CHECK(output.front() == 0);
+        CHECK(output.back() == 999);
+      }
+    }
+  }
+
+  GIVEN("a stage fed by several producers")
+  {
+    constexpr uint32_t PRODUCERS = 8;
+    constexpr uint32_t ITEMS     = 5000;
+
+    sharif::Pipeline pipeline{ pool, 16 };
+    uint64_t         sum   = 0;
+    size_t           count = 0;
+
+    auto& total = pipeline.sink<uint64_t>([&](uint64_t&& value) {
+      sum += value;
+      ++count;
+    });
+    for (uint32_t i = 1; i < PRODUCERS; ++i)
+    {
+      total.open();
+    }
+
+    WHEN("each producer pushes from its own thread and closes")
+    {
+      std::vector<std::jthread> producers;
+      for (uint32_t p = 0; p < PRODUCERS; ++p)
+      {
+        producers.emplace_back([&total] {
+          for (uint64_t i = 1; i <= ITEMS; ++i)
+          {
+            total.push(i);
+          }
+          total.close();
+        });
+      }
+      pipeline.wait();
+
+      THEN("the stage sees every item and finishes after the last close")
+      {
+        CHECK(count == PRODUCERS * ITEMS);
+        CHECK(sum == uint64_t{ PRODUCERS } * ITEMS * (ITEMS + 1) / 2);
+      }
+    }
+  }
+
+  GIVEN("pool jobs producing into a pipeline")
+  {
+    sharif::Pipeline    pipeline{ pool, 4 };
+    std::atomic<size_t> count{ 0 };
+
+    auto& sink = pipeline.sink<size_t>([&](size_t&&) { count.fetch_add(1, std::memory_order_relaxed); });
+    for (size_t i = 1; i < 64; ++i)
+    {
+      sink.open();
+    }
+
+    WHEN("more producers than workers block on the full queue")
+    {
+      std::vector<sharif::Task<void>> tasks;
+      for (size_t i = 0; i < 64; ++i)
+      {
+        tasks.push_back(pool.submit([&sink] {
+          for (size_t j = 0; j < 100; ++j)
+          {
+            sink.push(j);
+          }
+          sink.close();
+        }));
+      }
+      pipeline.wait();
+
+      THEN("the workers keep the stage running instead of deadlocking")
+      {
+        CHECK(count == 6400);
+      }
+    }
+  }
+}
+
+SCENARIO("An exception fails the whole pipeline", "[pipeline]")  // NOLINT
+{
+  sharif::ThreadPool pool{ 2 };
+
+  GIVEN("a stage that throws on one item")
+  {
+    sharif::Pipeline    pipeline{ pool, 4 };
+    std::atomic<size_t> written{ 0 };
+
+    auto& write = pipeline.sink<int>([&](int&&) { written.fetch_add(1); });
+    auto& check = pipeline.stage<int>(write, [](int&& value, sharif::Node<int>& next) {
+      if (value == 10)
+      {
+        throw std::runtime_error{ "bad input" };
+      }
+      next.push(value);
+    });
+
+    WHEN("input keeps coming after the failure")
+    {
+      for (int i = 0; i < 1000; ++i)
+      {
+        if (!check.push(i))
+        {
+          break;
+        }
+      }
+      check.close();
+
+      THEN("wait() rethrows it once every stage has finished")
+      {
+        CHECK_THROWS_AS(pipeline.wait(), std::runtime_error);
+        CHECK(pipeline.failed());
+        CHECK(written < 1000);
+        CHECK_NOTHROW(pipeline.wait());
+      }
+    }
+  }
+}
@@ -0,0 +1,110 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// 3rd
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/util/parallel.hpp>
+#include <sharif/util/proc.hpp>
+
+/* Constants
+ ******************************************************************************/
+constexpr unsigned CONCURRENCY = 64;
+
+/* Functions
+ ******************************************************************************/
+namespace {
+/** Runs `count` copies of `exe` with up to `CONCURRENCY` alive at once.
+ * @returns the number of stdout bytes seen, so the work cannot be optimized away.
+ */
+auto run_many(sharif::Process::Backend backend, size_t count, std::string_view exe, std::vector<std::string> args) -> size_t
+{
+  std::atomic<size_t> bytes{ 0 };
+  sharif::parallel_for(count, CONCURRENCY, [&](size_t) {
+    sharif::Process proc{ exe, args };
+    proc.with_backend(backend);
+    proc.on_stdout(
+      [](void* ctx, std::string_view chunk) {
+        static_cast<std::atomic<size_t>*>(ctx)->fetch_add(chunk.size(), std::memory_order_relaxed);
+      },
+      &bytes
+    );
+    proc.on_stderr([](void*, std::string_view) {});
+    proc.run();
+  });
+  return bytes.load();
+}
+}  // namespace
+
+/* Benchmarks
+ ******************************************************************************/
+TEST_CASE("Spawn rate with 64 concurrent children", "[!benchmark][proc]")  // NOLINT
+{
+  BENCHMARK("asio: 256 x true")
+  {
+    return run_many(sharif::Process::Backend::ASIO, 256, "true", {});
+  };
+
+  BENCHMARK("uvw: 256 x true")
+  {
+    return run_many(sharif::Process::Backend::UVW, 256, "true", {});
+  };
+
+  BENCHMARK("spawn: 256 x true")
+  {
+    return run_many(sharif::Process::Backend::SPAWN, 256, "true", {});
+  };
+}
+
+TEST_CASE("Spawn rate of one Process run repeatedly", "[!benchmark][proc]")  // NOLINT
+{
+  // Re-running a Process reuses its resolved executable, and on SPAWN its argv and envp
+  auto rerun = [](sharif::Process::Backend backend, size_t count) {
+    sharif::Process proc{ "true", { "--some", "--typical", "--arguments" } };
+    proc.with_backend(backend);
+    proc.with_env({ { "LC_ALL", "C" }, { "PATH", "/usr/bin:/bin" } });
+    int32_t codes = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+      codes += proc.run();
+    }
+    return codes;
+  };
+
+  BENCHMARK("asio: 128 x true")
+  {
+    return rerun(sharif::Process::Backend::ASIO, 128);
+  };
+
+  BENCHMARK("spawn: 128 x true")
+  {
+    return rerun(sharif::Process::Backend::SPAWN, 128);
+  };
+}
+
+TEST_CASE("Output throughput with 64 concurrent children", "[!benchmark][proc]")  // NOLINT
+{
+  BENCHMARK("asio: 64 x seq 100000")
+  {
+    return run_many(sharif::Process::Backend::ASIO, CONCURRENCY, "seq", { "100000" });
+  };
+
+  BENCHMARK("uvw: 64 x seq 100000")
+  {
+    return run_many(sharif::Process::Backend::UVW, CONCURRENCY, "seq", { "100000" });
+  };
+
+  BENCHMARK("spawn: 64 x seq 100000")
+  {
+    return run_many(sharif::Process::Backend::SPAWN, CONCURRENCY, "seq", { "100000" });
+  };
+}
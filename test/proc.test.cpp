@@ -0,0 +1,354 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <semaphore>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/util/proc.hpp>
+
+/* Constants
+ ******************************************************************************/
+using Backend = sharif::Process::Backend;
+using Flow    = sharif::Process::Flow;
+
+constexpr std::array BACKENDS = { Backend::ASIO, Backend::UVW, Backend::SPAWN };
+
+/* Functions
+ ******************************************************************************/
+namespace {
+auto name(Backend backend) -> std::string_view
+{
+  switch (backend)
+  {
+    case Backend::ASIO:
+      return "asio";
+    case Backend::UVW:
+      return "uvw";
+    case Backend::SPAWN:
+      return "spawn";
+  }
+  return "";
+}
+
+auto sh_args(std::string script, std::vector<std::string> args) -> std::vector<std::string>
+{
+  args.insert(args.begin(), { "-c", std::move(script), "sh" });
+  return args;
+}
+
+/** A child running `script` with `sh -c` on `backend`; further arguments become `$1`... */
+struct Sh : sharif::Process {
+  Sh(Backend backend, std::string script, std::vector<std::string> args = {})
+    : sharif::Process("sh", sh_args(std::move(script), std::move(args)))
+  {
+    with_backend(backend);
+  }
+};
+
+/** Checks that chunks of `yes` output arrive whole and in order. */
+struct YesConsumer {
+  sharif::Process*      proc;
+  size_t                bytes{ 0 };
+  size_t                chunks{ 0 };
+  bool                  intact{ true };
+  std::binary_semaphore paused{ 0 };
+
+  auto take(std::string_view chunk) -> void
+  {
+    for (const auto c : chunk)
+    {
+      intact = intact && c == ((bytes++ % 2 == 0) ? ('y') : ('\n'));
+    }
+    ++chunks;
+  }
+};
+}  // namespace
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Children run alike on every backend", "[proc]")  // NOLINT
+{
+  for (const auto backend : BACKENDS)
+  {
+    DYNAMIC_SECTION("on " << name(backend))
+    {
+      GIVEN("children that exit with a status or are killed by a signal")
+      {
+        THEN("the status is returned, or 128 + the signal")
+        {
+          CHECK(Sh{ backend, "exit 0" }.run() == 0);
+          CHECK(Sh{ backend, "exit 3" }.run() == 3);
+
+          Sh killed{ backend, "kill -TERM $$" };
+          CHECK(killed.run() == 128 + SIGTERM);
+          CHECK(killed.stats().signal == SIGTERM);
+        }
+      }
+
+      GIVEN("a child whose output does not end with a newline")
+      {
+        Sh proc{ backend, "printf 'one\\ntwo\\nthree'; printf 'err' >&2; exit 1" };
+
+        THEN("the last partial line of each stream is still delivered")
+        {
+          const auto lines = proc.run_lines();
+          CHECK(lines.exit_code == 1);
+          CHECK(lines.stdout == std::vector<std::string>{ "one", "two", "three" });
+          CHECK(lines.stderr == std::vector<std::string>{ "err" });
+        }
+      }
+
+      GIVEN("an executable that does not exist")
+      {
+        sharif::Process proc{ "/nonexistent/sharif-no-such-tool" };
+        proc.with_backend(backend);
+
+        THEN("run() returns -1")
+        {
+          CHECK(proc.run() == -1);
+        }
+      }
+
+      GIVEN("processes run from several threads at once")
+      {
+        constexpr size_t          THREADS = 8;
+        constexpr size_t          RUNS    = 10;
+        std::atomic<size_t>       matched{ 0 };
+        std::vector<std::jthread> threads;
+        for (size_t t = 0; t < THREADS; ++t)
+        {
+          threads.emplace_back([&, t] {
+            for (size_t i = 0; i < RUNS; ++i)
+            {
+              const auto expected = std::to_string(t * RUNS + i);
+              const auto text     = Sh{ backend, "echo \"$1\"; exit \"$2\"", { expected, std::to_string(i % 4) } }.run_text();
+              if (text.stdout == expected + '\n' && text.exit_code == static_cast<int32_t>(i % 4))
+              {
+                matched.fetch_add(1, std::memory_order_relaxed);
+              }
+            }
+          });
+        }
+        threads.clear();
+
+        THEN("every child's output and status reach the thread that ran it")
+        {
+          CHECK(matched == THREADS * RUNS);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Chunk consumers pause and resume the child's output", "[proc]")  // NOLINT
+{
+  constexpr size_t BYTES = 1 << 20;
+  const auto       yes   = "yes | head -c " + std::to_string(BYTES);
+
+  for (const auto backend : BACKENDS)
+  {
+    DYNAMIC_SECTION("on " << name(backend))
+    {
+      GIVEN("a consumer that pauses after every chunk and is resumed by another thread")
+      {
+        Sh          proc{ backend, yes };
+        YesConsumer consumer{ .proc = &proc };
+        proc.on_stdout_chunks(
+          [](void* context, std::string_view chunk) {
+            auto& self = *static_cast<YesConsumer*>(context);
+            self.take(chunk);
+            self.paused.release();
+            return Flow::PAUSE;
+          },
+          &consumer
+        );
+
+        std::atomic<bool> done{ false };
+        std::jthread      resumer{ [&] {
+          for (size_t i = 0;; ++i)
+          {
+            consumer.paused.acquire();
+            if (done)
+            {
+              return;
+            }
+            // Stall now and then so that the pipe fills and the child blocks
+            if (i % 4 == 0)
+            {
+              std::this_thread::sleep_for(std::chrono::milliseconds{ 2 });
+            }
+            proc.resume_stdout();
+          }
+        } };
+        const auto code = proc.run();
+        done            = true;
+        consumer.paused.release();
+        resumer.join();
+
+        THEN("the run completes with every byte delivered once, in order")
+        {
+          CHECK(code == 0);
+          CHECK(consumer.bytes == BYTES);
+          CHECK(consumer.intact);
+          CHECK(consumer.chunks > 1);
+        }
+      }
+
+      GIVEN("a consumer that resumes before it returns PAUSE")
+      {
+        Sh          proc{ backend, yes };
+        YesConsumer consumer{ .proc = &proc };
+        proc.on_stdout_chunks(
+          [](void* context, std::string_view chunk) {
+            auto& self = *static_cast<YesConsumer*>(context);
+            self.take(chunk);
+            self.proc->resume_stdout();
+            return Flow::PAUSE;
+          },
+          &consumer
+        );
+        const auto code = proc.run();
+
+        THEN("the early resume restarts reading as soon as it pauses")
+        {
+          CHECK(code == 0);
+          CHECK(consumer.bytes == BYTES);
+          CHECK(consumer.intact);
+        }
+      }
+
+      GIVEN("a consumer that never pauses")
+      {
+        Sh          proc{ backend, yes + " >&2" };
+        YesConsumer consumer{ .proc = &proc };
+        proc.on_stderr_chunks(
+          [](void* context, std::string_view chunk) {
+            static_cast<YesConsumer*>(context)->take(chunk);
+            return Flow::CONTINUE;
+          },
+          &consumer
+        );
+
+        THEN("chunks of stderr are delivered the same way")
+        {
+          CHECK(proc.run() == 0);
+          CHECK(consumer.bytes == BYTES);
+          CHECK(consumer.intact);
+        }
+      }
+    }
+  }
+}
+
+SCENARIO("Children are held to their limits and accounted for", "[proc]")  // NOLINT
+{
+  using std::chrono::milliseconds;
+  using std::chrono::seconds;
+
+  for (const auto backend : BACKENDS)
+  {
+    DYNAMIC_SECTION("on " << name(backend))
+    {
+      GIVEN("a child that outlives its timeout")
+      {
+        Sh proc{ backend, "exec sleep 10" };
+        proc.with_limits({ .timeout = milliseconds{ 100 } });
+
+        THEN("it is sent SIGTERM")
+        {
+          CHECK(proc.run() == 128 + SIGTERM);
+          CHECK(proc.stats().timed_out);
+          CHECK(proc.stats().signal == SIGTERM);
+          CHECK(proc.stats().wall_time < seconds{ 5 });
+        }
+      }
+
+      GIVEN("a child that ignores SIGTERM")
+      {
+        Sh proc{ backend, "trap '' TERM; exec sleep 10" };
+        proc.with_limits({ .timeout = milliseconds{ 100 }, .grace = milliseconds{ 100 } });
+
+        THEN("it is sent SIGKILL once the grace period passes")
+        {
+          CHECK(proc.run() == 128 + SIGKILL);
+          CHECK(proc.stats().timed_out);
+          CHECK(proc.stats().signal == SIGKILL);
+          CHECK(proc.stats().wall_time < seconds{ 5 });
+        }
+      }
+
+      GIVEN("a child that finishes within its timeout")
+      {
+        Sh proc{ backend, "exit 0" };
+        proc.with_limits({ .timeout = seconds{ 10 } });
+
+        THEN("it is not held up by the deadline")
+        {
+          CHECK(proc.run() == 0);
+          CHECK_FALSE(proc.stats().timed_out);
+          CHECK(proc.stats().wall_time < seconds{ 5 });
+        }
+      }
+
+      GIVEN("a child that spins for a while")
+      {
+        Sh proc{ backend, "i=0; while [ $i -lt 200000 ]; do i=$((i + 1)); done" };
+        REQUIRE(proc.run() == 0);
+
+        THEN("its wall time is measured, and its resource usage where wait4 reaps it")
+        {
+          const auto& stats = proc.stats();
+          CHECK(stats.wall_time > milliseconds{ 0 });
+          CHECK(stats.signal == 0);
+          if (backend != Backend::UVW)
+          {
+            CHECK(stats.user_time + stats.system_time > milliseconds{ 0 });
+            CHECK(stats.max_rss > 0);
+            CHECK(stats.voluntary_switches + stats.involuntary_switches > 0);
+          }
+        }
+      }
+
+      GIVEN("a child that spins past its CPU time limit")
+      {
+        Sh proc{ backend, "while :; do :; done" };
+        proc.with_limits({ .timeout = seconds{ 30 }, .cpu_time = 1 });
+
+        THEN("it is stopped with SIGXCPU, whatever the backend")
+        {
+          CHECK(proc.run() == 128 + SIGXCPU);
+          CHECK(proc.stats().signal == SIGXCPU);
+          CHECK_FALSE(proc.stats().timed_out);
+          CHECK(proc.stats().user_time + proc.stats().system_time >= milliseconds{ 900 });
+        }
+      }
+
+      GIVEN("a child that allocates past its address space limit")
+      {
+        const auto script = R"(x=$(head -c 50000000 /dev/zero | tr '\0' a); echo ${#x})";
+
+        THEN("it fails, whatever the backend, where it succeeds without the limit")
+        {
+          CHECK(Sh{ backend, script }.run_text().stdout == "50000000\n");
+
+          Sh proc{ backend, script };
+          proc.with_limits({ .address_space = uint64_t{ 32 } << 20U });
+          CHECK(proc.run() != 0);
+        }
+      }
+    }
+  }
+}
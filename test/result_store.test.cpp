@@ -0,0 +1,176 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/parse/sarif.hpp>
+#include <sharif/report/fingerprint.hpp>
+#include <sharif/report/result_store.hpp>
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Results round-trip through the binary store", "[store]")  // NOLINT
+{
+  const auto diagnostics = std::vector<sharif::Diagnostic>{
+    { .file = "src/b.cpp", .line = 3, .column = 1, .severity = "error", .message = "first", .category = "-Wshadow", .source = {} },
+    { .file = "src/a.cpp", .line = 4, .column = 7, .severity = "warning", .message = "second", .category = "-Wunused", .source = {} },
+    { .file = "src/a.cpp", .line = 9, .column = 2, .severity = "note", .message = "third", .category = "-Wshadow", .source = {} },
+  };
+
+  sharif::ResultTable table;
+  for (const auto& diagnostic : diagnostics)
+  {
+    table.add(diagnostic);
+  }
+
+  const auto bytes  = sharif::ResultStore::encode(table, "gcc");
+  auto       opened = sharif::ResultStore::from(bytes);
+  REQUIRE(opened.has_value());
+  const auto& store = opened.value();
+  REQUIRE(store.size() == 3);
+  REQUIRE(store.driver() == "gcc");
+
+  SECTION("Rows are indexed by file and rule")
+  {
+    const auto in_a = store.rows_for_file("src/a.cpp");
+    REQUIRE(in_a.size() == 2);
+    REQUIRE(in_a[0] == 1);
+    REQUIRE(in_a[1] == 2);
+
+    const auto shadow = store.rows_for_rule("-Wshadow");
+    REQUIRE(shadow.size() == 2);
+    REQUIRE(shadow[0] == 0);
+    REQUIRE(shadow[1] == 2);
+
+    REQUIRE(store.rows_for_rule("-Wall").empty());
+    REQUIRE(store.file_index().size() == 2);
+  }
+
+  SECTION("Diagnostics keep their fields")
+  {
+    const auto restored = store.to_diagnostics();
+    REQUIRE(restored.size() == diagnostics.size());
+    for (size_t i = 0; i < restored.size(); ++i)
+    {
+      REQUIRE(restored[i].file == diagnostics[i].file);
+      REQUIRE(restored[i].line == diagnostics[i].line);
+      REQUIRE(restored[i].column == diagnostics[i].column);
+      REQUIRE(restored[i].severity == diagnostics[i].severity);
+      REQUIRE(restored[i].message == diagnostics[i].message);
+      REQUIRE(restored[i].category == diagnostics[i].category);
+    }
+  }
+
+  SECTION("SARIF results keep their fields")
+  {
+    const auto sarif = store.to_sarif();
+    REQUIRE(sarif.runs.size() == 1);
+    REQUIRE(sarif.runs[0].tool.driver.name == "gcc");
+    REQUIRE(sarif.runs[0].results->size() == 3);
+    REQUIRE(sharif::sarif::to_diagnostic(sarif.runs[0].results->at(1)).message == "second");
+  }
+
+  SECTION("Corrupt stores are rejected")
+  {
+    auto corrupt = bytes;
+    corrupt[0]   = 'X';
+    REQUIRE_FALSE(sharif::ResultStore::from(corrupt).has_value());
+
+    const auto truncated = bytes.substr(0, bytes.size() / 2);
+    REQUIRE_FALSE(sharif::ResultStore::from(truncated).has_value());
+
+    // The spans of a store opened in memory point into its bytes
+    const auto level = reinterpret_cast<const char*>(store.levels().data()) - bytes.data();  // NOLINT(*-reinterpret-cast)
+    auto       bad   = bytes;
+    bad[static_cast<size_t>(level)] = static_cast<char>(std::to_underlying(sharif::sarif::Level::error) + 1);
+    REQUIRE_FALSE(sharif::ResultStore::from(bad).has_value());
+  }
+}
+
+SCENARIO("SARIF logs round-trip through the binary store", "[store]")  // NOLINT
+{
+  const auto make_result = [](std::string rule, sharif::sarif::Level level, std::string file, uint32_t line, uint32_t column, std::string_view fingerprint) {
+    sharif::sarif::Result result;
+    result.ruleId       = std::move(rule);
+    result.level        = level;
+    result.message.text = "message in " + file;
+
+    sharif::sarif::Region region;
+    region.startLine   = line;
+    region.startColumn = column;
+
+    auto& physical            = result.locations.emplace().emplace_back().physicalLocation.emplace();
+    physical.artifactLocation = sharif::sarif::ArtifactLocation{ .uri = std::move(file) };
+    physical.region           = std::move(region);
+
+    result.partialFingerprints = sharif::sarif::map_t<std::string, std::string>{ { std::string{ sharif::FINGERPRINT_KEY }, std::string{ fingerprint } } };
+    return result;
+  };
+
+  auto  sarif          = sharif::Sarif{};
+  auto& run            = sarif.runs.emplace_back();
+  run.tool.driver.name = "clang-tidy";
+  run.results          = std::vector{
+    make_result("misc-unused", sharif::sarif::Level::warning, "src/a.cpp", 3, 5, "00c0ffee12345678"),
+    make_result("bugprone-x", sharif::sarif::Level::error, "src/b.cpp", 10, 1, "0123456789abcdef"),
+    make_result("misc-unused", sharif::sarif::Level::note, "src/a.cpp", 7, 2, "fedcba9876543210"),
+  };
+
+  const auto encode = [&] {
+    sharif::ResultTable table;
+    for (const auto& result : *run.results)
+    {
+      table.add(result);
+    }
+    return sharif::ResultStore::encode(table, run.tool.driver.name);
+  };
+
+  GIVEN("results with only the properties the store keeps")
+  {
+    const auto bytes = encode();
+    auto       store = sharif::ResultStore::from(bytes);
+    REQUIRE(store.has_value());
+
+    THEN("the decoded log serializes exactly like the encoded one")
+    {
+      std::string expected;
+      std::string actual;
+      REQUIRE(sarif.write(expected));
+      REQUIRE(store.value().to_sarif().write(actual));
+      CHECK(actual == expected);
+    }
+  }
+
+  GIVEN("results with properties the store does not keep")
+  {
+    auto& result = run.results->front();
+    result.locations->front().physicalLocation->region->endLine = 4;
+    result.relatedLocations.emplace().push_back(result.locations->front());
+    result.ruleIndex = 0;
+
+    const auto bytes = encode();
+    auto       store = sharif::ResultStore::from(bytes);
+    REQUIRE(store.has_value());
+
+    THEN("those are dropped and the rest is kept")
+    {
+      const auto  decoded  = store.value().to_sarif();
+      const auto& restored = decoded.runs.front().results->front();
+      const auto* location = sharif::sarif::primary_location(restored);
+      CHECK(restored.ruleId == "misc-unused");
+      CHECK(location->artifactLocation->uri == "src/a.cpp");
+      CHECK(location->region->startLine == 3U);
+      CHECK_FALSE(location->region->endLine);
+      CHECK_FALSE(restored.relatedLocations);
+      CHECK(restored.ruleIndex == -1);
+    }
+  }
+}
@@ -0,0 +1,135 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <string>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/parse/diagnostic.hpp>
+#include <sharif/parse/sarif.hpp>
+#include <sharif/report/result_table.hpp>
+
+/* Functions
+ ******************************************************************************/
+namespace {
+auto make_results() -> std::vector<sharif::sarif::Result>
+{
+  const auto diagnostics = std::vector<sharif::Diagnostic>{
+    { .file = "src/b.cpp", .line = 3, .column = 1, .severity = "error", .message = "first", .category = "-Wshadow", .source = {} },
+    { .file = "src/a.cpp", .line = 9, .column = 2, .severity = "note", .message = "second", .category = "-Wshadow", .source = {} },
+    { .file = "", .line = 0, .column = 0, .severity = "warning", .message = "third", .category = "", .source = {} },
+    { .file = "src/a.cpp", .line = 4, .column = 7, .severity = "warning", .message = "fourth", .category = "-Wunused", .source = {} },
+    { .file = "src/a.cpp", .line = 4, .column = 7, .severity = "warning", .message = "fifth", .category = "-Wall", .source = {} },
+  };
+
+  std::vector<sharif::sarif::Result> results;
+  for (const auto& diagnostic : diagnostics)
+  {
+    results.push_back(sharif::sarif::to_result(diagnostic));
+  }
+  return results;
+}
+
+auto messages(const std::vector<sharif::sarif::Result>& results) -> std::vector<std::string>
+{
+  std::vector<std::string> texts;
+  for (const auto& result : results)
+  {
+    texts.push_back(result.message.text.value_or(""));
+  }
+  return texts;
+}
+}  // namespace
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("A ResultTable holds the fields of results in columns", "[result_table]")  // NOLINT
+{
+  const auto results = make_results();
+  const auto table   = sharif::ResultTable::from(results);
+  REQUIRE(table.size() == 5);
+
+  THEN("each row reads back the fields of its result")
+  {
+    const auto row = table.row(0);
+    CHECK(row.rule == "-Wshadow");
+    CHECK(row.level == sharif::sarif::Level::error);
+    CHECK(row.file == "src/b.cpp");
+    CHECK(row.line == 3);
+    CHECK(row.column == 1);
+    CHECK(row.message == "first");
+  }
+
+  THEN("strings are interned once and missing fields have no id")
+  {
+    CHECK(table.rules()[0] == table.rules()[1]);
+    CHECK(table.files()[1] == table.files()[3]);
+    CHECK(table.files()[2] == sharif::ResultTable::NONE);
+    CHECK(table.rules()[2] == sharif::ResultTable::NONE);
+    CHECK(table.file(2).empty());
+  }
+
+  THEN("rows convert back to results and diagnostics")
+  {
+    const auto result = table.to_result(3);
+    CHECK(result.ruleId == "-Wunused");
+    CHECK(sharif::sarif::primary_location(result)->region->startColumn == 7);
+
+    const auto diagnostic = table.row(1).to_diagnostic();
+    CHECK(diagnostic.file == "src/a.cpp");
+    CHECK(diagnostic.severity == "note");
+  }
+}
+
+SCENARIO("A ResultTable filters and sorts rows, then selects results", "[result_table]")  // NOLINT
+{
+  auto results = make_results();
+  auto table   = sharif::ResultTable::from(results);
+
+  WHEN("rows are sorted by location")
+  {
+    table.sort_by_location();
+
+    THEN("they are ordered by file, line, column and rule, with results without a file last")
+    {
+      CHECK(messages(table.select(results)) == std::vector<std::string>{ "fifth", "fourth", "second", "first", "third" });
+      CHECK(table.origins()[0] == 4);
+    }
+  }
+
+  WHEN("rows are filtered by level")
+  {
+    const auto removed = table.filter([&](uint32_t row) { return table.levels()[row] == sharif::sarif::Level::warning; });
+
+    THEN("the rest keep their order and their origin")
+    {
+      CHECK(removed == 2);
+      REQUIRE(table.size() == 3);
+      CHECK(table.message(0) == "third");
+      CHECK(messages(table.select(results)) == std::vector<std::string>{ "third", "fourth", "fifth" });
+    }
+
+    AND_WHEN("they are then sorted")
+    {
+      table.sort([&](uint32_t lhs, uint32_t rhs) { return table.message(lhs) < table.message(rhs); });
+
+      THEN("select() follows the final order")
+      {
+        CHECK(messages(table.select(results)) == std::vector<std::string>{ "fifth", "fourth", "third" });
+      }
+    }
+  }
+
+  WHEN("results are sorted in place")
+  {
+    sharif::sort_by_location(results);
+
+    THEN("they follow the table's order")
+    {
+      CHECK(messages(results) == std::vector<std::string>{ "fifth", "fourth", "second", "first", "third" });
+    }
+  }
+}
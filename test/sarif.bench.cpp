@@ -0,0 +1,104 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <cstddef>
+#include <ostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+// 3rd
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/parse/sarif.hpp>
+#include <sharif/util/fmt.hpp>
+#include <sharif/util/json.hpp>
+
+/* Types
+ ******************************************************************************/
+namespace {
+/// Counts what is written to it, so output cost does not hide serialization cost.
+class NullBuffer : public std::streambuf {
+public:
+  size_t written{ 0 };
+
+protected:
+  auto overflow(int_type ch) -> int_type override
+  {
+    ++written;
+    return ch;
+  }
+
+  auto xsputn(const char* /* str */, std::streamsize count) -> std::streamsize override
+  {
+    written += static_cast<size_t>(count);
+    return count;
+  }
+};
+}  // namespace
+
+/* Functions
+ ******************************************************************************/
+namespace {
+auto make_log(size_t count) -> sharif::Sarif
+{
+  sharif::sarif::Run run;
+  run.tool.driver.name = "gcc";
+  std::vector<sharif::sarif::Result> results;
+  results.reserve(count);
+  for (size_t i = 0; i < count; ++i)
+  {
+    const auto diagnostic = sharif::Diagnostic{
+      .file     = sharif::fmt::format("src/module_{}/file_{}.cpp", i % 17, i % 101),
+      .line     = static_cast<uint32_t>(i % 1000 + 1),
+      .column   = static_cast<uint32_t>(i % 80 + 1),
+      .severity = (i % 3 == 0) ? ("error") : ("warning"),
+      .message  = sharif::fmt::format("variable 'value_{}' set but not used", i),
+      .category = "-Wunused-but-set-variable",
+      .source   = "   10 |   auto value = parse(str);\n      |        ^~~~~",
+    };
+    results.push_back(sharif::sarif::to_result(diagnostic));
+  }
+
+  run.results = std::move(results);
+
+  sharif::Sarif sarif;
+  sarif.runs.push_back(std::move(run));
+  return sarif;
+}
+}  // namespace
+
+/* Benchmarks
+ ******************************************************************************/
+TEST_CASE("Serialize a SARIF log", "[!benchmark][sarif]")  // NOLINT
+{
+  const auto sarif = make_log(10'000);
+
+  BENCHMARK("serialize one result")
+  {
+    return sharif::json::write_json(sarif.runs.front().results->front()).value_or("").size();
+  };
+
+  BENCHMARK_ADVANCED("serialize the whole log, then write it")(Catch::Benchmark::Chronometer meter)
+  {
+    NullBuffer   sink;
+    std::ostream out{ &sink };
+    meter.measure([&] {
+      const auto text = sharif::json::write_json(sarif).value_or("");
+      out.write(text.data(), static_cast<std::streamsize>(text.size()));
+      return text.size();
+    });
+  };
+
+  BENCHMARK_ADVANCED("stream the log one result at a time")(Catch::Benchmark::Chronometer meter)
+  {
+    // Streaming releases results as it goes, so every run gets its own copy, made untimed
+    std::vector<sharif::Sarif> logs(static_cast<size_t>(meter.runs()), sarif);
+    NullBuffer                 sink;
+    std::ostream               out{ &sink };
+    std::string                buffer;
+    meter.measure([&](int run) { return logs[static_cast<size_t>(run)].write(out, buffer); });
+  };
+}
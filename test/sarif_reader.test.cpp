@@ -0,0 +1,98 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <string_view>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/parse/sarif_reader.hpp>
+
+/* Constants
+ ******************************************************************************/
+constexpr std::string_view LOG = R"({
+  "$schema": "https://json.schemastore.org/sarif-2.1.0.json",
+  "version": "2.1.0",
+  "runs": [
+    {
+      "results": [
+        { "ruleId": "A1", "message": { "text": "first \"quoted\" }" }, "webRequest": { "target": "]" } },
+        { "ruleId": "A2", "message": { "text": "second" }, "graphs": [ { "nodes": [] } ] }
+      ],
+      "tool": { "driver": { "name": "gcc" } },
+      "graphs": [ { "description": { "text": "{[" } } ]
+    },
+    { "tool": { "driver": { "name": "empty" } } },
+    {
+      "tool": { "driver": { "name": "codeql" } },
+      "results": [ { "ruleId": "B1", "message": { "text": "third" }, "level": "error" } ]
+    }
+  ]
+})";
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Results are streamed from every run", "[sarif]")  // NOLINT
+{
+  auto                  reader = sharif::SarifReader{ LOG };
+  sharif::sarif::Result result;
+
+  REQUIRE(reader.next(result).value());
+  REQUIRE(reader.version() == "2.1.0");
+  REQUIRE(result.ruleId == "A1");
+  REQUIRE(result.message.text == R"(first "quoted" })");
+  REQUIRE(reader.run().tool.driver.name == "gcc");
+  REQUIRE_FALSE(reader.run().graphs);
+
+  REQUIRE(reader.next(result).value());
+  REQUIRE(result.ruleId == "A2");
+  REQUIRE_FALSE(result.graphs);
+
+  REQUIRE(reader.next(result).value());
+  REQUIRE(result.ruleId == "B1");
+  REQUIRE(result.level == sharif::sarif::Level::error);
+  REQUIRE(reader.run().tool.driver.name == "codeql");
+  REQUIRE(reader.run_index() == 2);
+
+  REQUIRE_FALSE(reader.next(result).value());
+  REQUIRE_FALSE(reader.next(result).value());
+}
+
+SCENARIO("Malformed logs are reported", "[sarif]")  // NOLINT
+{
+  auto                  reader = sharif::SarifReader{ R"({ "runs": [ { "results": [ { "ruleId": "A1" )" };
+  sharif::sarif::Result result;
+  REQUIRE(reader.next(result).has_error());
+}
+
+SCENARIO("Runs are walked one at a time", "[sarif]")  // NOLINT
+{
+  auto                  reader = sharif::SarifReader{ LOG };
+  sharif::sarif::Result result;
+
+  GIVEN("a run whose results are not all read")
+  {
+    REQUIRE(reader.next_run().value());
+    REQUIRE(reader.run().tool.driver.name == "gcc");
+    REQUIRE(reader.next_result(result).value());
+    REQUIRE(result.ruleId == "A1");
+
+    THEN("the next run skips the rest and stops at runs without results")
+    {
+      REQUIRE(reader.next_run().value());
+      REQUIRE(reader.run().tool.driver.name == "empty");
+      REQUIRE(reader.run_index() == 1);
+      REQUIRE_FALSE(reader.next_result(result).value());
+
+      REQUIRE(reader.next_run().value());
+      REQUIRE(reader.run().tool.driver.name == "codeql");
+      REQUIRE(reader.next_result(result).value());
+      REQUIRE(result.ruleId == "B1");
+      REQUIRE_FALSE(reader.next_result(result).value());
+
+      REQUIRE_FALSE(reader.next_run().value());
+      REQUIRE_FALSE(reader.next(result).value());
+    }
+  }
+}
@@ -0,0 +1,163 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <array>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/util/slab_pool.hpp>
+
+/* Types
+ ******************************************************************************/
+namespace {
+/// Each scenario uses its own type, so the pools do not share state.
+template <int>
+struct Value {
+  std::array<std::byte, 48> bytes;
+};
+
+template <int N>
+using Pool = sharif::SlabPool<Value<N>>;
+
+/** Allocates `count` nodes from `Pool<N>` on the calling thread. */
+template <int N>
+auto allocate(size_t count) -> std::vector<void*>
+{
+  std::vector<void*> nodes(count);
+  for (auto& node : nodes)
+  {
+    node = Pool<N>::allocate();
+  }
+  return nodes;
+}
+
+template <int N>
+auto deallocate(const std::vector<void*>& nodes) -> void
+{
+  for (auto* node : nodes)
+  {
+    Pool<N>::deallocate(node);
+  }
+}
+}  // namespace
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("A SlabPool reuses freed storage", "[slab_pool]")  // NOLINT
+{
+  if (!Pool<0>::POOLED)
+  {
+    SKIP("storage comes from the heap under AddressSanitizer");
+  }
+
+  GIVEN("storage freed on the thread that allocated it")
+  {
+    auto* first = Pool<0>::allocate();
+    Pool<0>::deallocate(first);
+
+    THEN("the next allocation gets it back without another slab")
+    {
+      const auto slabs = Pool<0>::slabs();
+      CHECK(Pool<0>::allocate() == first);
+      CHECK(Pool<0>::slabs() == slabs);
+      Pool<0>::deallocate(first);
+    }
+  }
+}
+
+SCENARIO("Storage freed by another thread returns to the allocating one", "[slab_pool]")  // NOLINT
+{
+  if (!Pool<1>::POOLED)
+  {
+    SKIP("storage comes from the heap under AddressSanitizer");
+  }
+
+  GIVEN("many slabs' worth of storage allocated on one thread")
+  {
+    const auto count = 10 * Pool<1>::batch_size();
+    auto       nodes = allocate<1>(count);
+    const auto slabs = Pool<1>::slabs();
+
+    WHEN("another thread frees all of it")
+    {
+      size_t cached = 0;
+      std::jthread{ [&] {
+        deallocate<1>(nodes);
+        cached = Pool<1>::cached();
+      } }.join();
+
+      THEN("the freeing thread keeps at most two batches and the rest goes to the depot")
+      {
+        CHECK(cached <= 2 * Pool<1>::batch_size());
+        CHECK(Pool<1>::spare() >= count - cached);
+      }
+
+      THEN("the allocating thread reuses it without new slabs")
+      {
+        nodes = allocate<1>(count - 2 * Pool<1>::batch_size());
+        CHECK(Pool<1>::slabs() == slabs);
+        deallocate<1>(nodes);
+      }
+    }
+  }
+}
+
+SCENARIO("A thread's free storage outlives the thread", "[slab_pool]")  // NOLINT
+{
+  if (!Pool<2>::POOLED)
+  {
+    SKIP("storage comes from the heap under AddressSanitizer");
+  }
+
+  GIVEN("a thread that allocates, frees and exits")
+  {
+    const auto spare = Pool<2>::spare();
+    size_t     cached = 0;
+    std::jthread{ [&] {
+      deallocate<2>(allocate<2>(100));
+      cached = Pool<2>::cached();
+    } }.join();
+
+    THEN("its free list is handed to the depot")
+    {
+      CHECK(cached >= 100);
+      CHECK(Pool<2>::spare() == spare + cached);
+    }
+
+    THEN("another thread allocates from it without new slabs")
+    {
+      const auto slabs = Pool<2>::slabs();
+      const auto nodes = allocate<2>(cached);
+      CHECK(Pool<2>::slabs() == slabs);
+      deallocate<2>(nodes);
+    }
+  }
+
+  GIVEN("threads allocating and freeing concurrently")
+  {
+    // Run with SHARIF_TSAN=ON to check the depot handoff
+    constexpr size_t          THREADS = 8;
+    const auto                before  = Pool<2>::slabs();
+    std::vector<std::jthread> threads;
+    for (size_t t = 0; t < THREADS; ++t)
+    {
+      threads.emplace_back([] {
+        for (int round = 0; round < 20; ++round)
+        {
+          deallocate<2>(allocate<2>(3 * Pool<2>::batch_size()));
+        }
+      });
+    }
+    threads.clear();
+
+    THEN("slabs stay bounded by what was live at once plus each thread's cache")
+    {
+      CHECK(Pool<2>::slabs() <= before + THREADS * 5);
+    }
+  }
+}
@@ -0,0 +1,65 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/util/source_cache.hpp>
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Source lines are looked up from the line index", "[source]")  // NOLINT
+{
+  const auto file = sharif::fs::temp_directory_path() / "sharif_source_cache.txt";
+  {
+    std::ofstream stream{ file, std::ios::binary };
+    stream << "first\r\nsecond\n\nfourth";
+  }
+
+  sharif::SourceCache sources;
+  REQUIRE(sources.line_count(file) == 4);
+  REQUIRE(sources.line(file, 1) == "first");
+  REQUIRE(sources.line(file, 3) == "");
+  REQUIRE(sources.line(file, 4) == "fourth");
+  REQUIRE_FALSE(sources.line(file, 5));
+
+  SECTION("Positions map to byte offsets")
+  {
+    REQUIRE(sources.offset(file, 2, 1) == 7U);
+    REQUIRE(sources.offset(file, 2, 7) == 13U);
+    REQUIRE_FALSE(sources.offset(file, 2, 8));
+  }
+
+  SECTION("Threads share one mapping")
+  {
+    std::vector<std::thread> threads;
+    std::vector<size_t>      counts(8);
+    for (size_t i = 0; i < counts.size(); ++i)
+    {
+      threads.emplace_back([&, i] { counts[i] = sources.line_count(file); });
+    }
+    for (auto& thread : threads)
+    {
+      thread.join();
+    }
+    for (const auto count : counts)
+    {
+      REQUIRE(count == 4);
+    }
+  }
+
+  SECTION("Newlines are counted a word at a time")
+  {
+    REQUIRE(sharif::count_newlines("") == 0);
+    REQUIRE(sharif::count_newlines("\n\n\n") == 3);
+    REQUIRE(sharif::count_newlines("0123456\n89abcdef\n\xff\x8a\n") == 3);
+  }
+
+  sharif::fs::remove(file);
+}
@@ -0,0 +1,65 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <string>
+#include <utility>
+
+// 3rd
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/util/string_pool.hpp>
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("A StringPool stores each string once", "[string_pool]")  // NOLINT
+{
+  GIVEN("a pool with a few strings, one of them added twice")
+  {
+    sharif::StringPool pool;
+    REQUIRE(pool.intern("src/a.cpp") == 0);
+    REQUIRE(pool.intern("-Wshadow") == 1);
+    REQUIRE(pool.intern(std::string{ "src/a.cpp" }) == 0);
+
+    THEN("ids are dense and in insertion order")
+    {
+      CHECK(pool.size() == 2);
+      CHECK(pool[0] == "src/a.cpp");
+      CHECK(pool[1] == "-Wshadow");
+      CHECK(pool.find("-Wshadow") == 1);
+    }
+
+    THEN("unknown strings and ids are reported as such")
+    {
+      CHECK(pool.find("src/b.cpp") == sharif::StringPool::NONE);
+      CHECK(pool[sharif::StringPool::NONE].empty());
+      CHECK(pool.size() == 2);
+    }
+
+    WHEN("it is copied and the original goes away")
+    {
+      auto copy = sharif::StringPool{ pool };
+      pool      = sharif::StringPool{};
+
+      THEN("the copy keeps the same ids with its own storage")
+      {
+        CHECK(copy[0] == "src/a.cpp");
+        CHECK(copy.find("-Wshadow") == 1);
+        CHECK(copy.intern("src/b.cpp") == 2);
+        CHECK(pool.size() == 0);
+      }
+    }
+
+    WHEN("it is moved")
+    {
+      const auto* data  = pool[0].data();
+      auto        moved = std::move(pool);
+
+      THEN("views into it stay valid")
+      {
+        CHECK(moved[0].data() == data);
+        CHECK(moved.find("src/a.cpp") == 0);
+      }
+    }
+  }
+}
@@ -0,0 +1,192 @@
+/* Includes
+ ******************************************************************************/
+// std
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// 3rd
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+// local
+#include <sharif/util/thread_pool.hpp>
+
+// namespace
+namespace asio = boost::asio;
+
+/* Functions
+ ******************************************************************************/
+namespace {
+/// Recursive fan-out whose jobs wait on the jobs they submit.
+auto fib(sharif::ThreadPool& pool, uint32_t n) -> uint64_t
+{
+  if (n < 12)
+  {
+    return (n < 2) ? (n) : (fib(pool, n - 1) + fib(pool, n - 2));
+  }
+  auto left = pool.submit([&pool, n] { return fib(pool, n - 1); });
+  return fib(pool, n - 2) + left.get();
+}
+}  // namespace
+
+/* Tests
+ ******************************************************************************/
+SCENARIO("Jobs run on the pool and return their results", "[thread_pool]")  // NOLINT
+{
+  sharif::ThreadPool pool{ 4 };
+
+  GIVEN("many independent jobs")
+  {
+    std::vector<sharif::Task<uint64_t>> tasks;
+    for (uint64_t i = 0; i < 1000; ++i)
+    {
+      tasks.push_back(pool.submit([i] { return i * i; }));
+    }
+
+    THEN("each task yields its own result")
+    {
+      for (uint64_t i = 0; i < tasks.size(); ++i)
+      {
+        REQUIRE(tasks[i].get() == i * i);
+      }
+    }
+  }
+
+  GIVEN("jobs that wait on the jobs they submit")
+  {
+    THEN("waiting workers keep running work instead of deadlocking")
+    {
+      auto task = pool.submit([&pool] { return fib(pool, 25); });
+      REQUIRE(task.get() == 75025);
+    }
+  }
+
+  GIVEN("a job that throws")
+  {
+    auto task = pool.submit([]() -> int { throw std::runtime_error{ "boom" }; });
+
+    THEN("the exception reaches get() and skips continuations")
+    {
+      std::atomic<bool> ran{ false };
+      auto              next = task.then([&ran](int) { ran = true; });
+      REQUIRE_THROWS_AS(task.get(), std::runtime_error);
+      REQUIRE_THROWS_AS(next.get(), std::runtime_error);
+      REQUIRE_FALSE(ran);
+    }
+  }
+}
+
+SCENARIO("Continuations chain on the pool", "[thread_pool]")  // NOLINT
+{
+  sharif::ThreadPool pool{ 2 };
+
+  auto task = pool.submit([] { return 20; })
+                .then([](int value) { return value + 1; })
+                .then([](int value) { return value * 2; });
+  REQUIRE(task.get() == 42);
+
+  auto done = pool.submit([] {}).then([] { return std::string{ "done" }; });
+  REQUIRE(done.get() == "done");
+
+  GIVEN("a task read by several continuations and get() calls")
+  {
+    const auto text   = std::string(64, 'x');
+    auto       task   = pool.submit([&text] { return text; });
+    auto       first  = task.then([](std::string value) { return value.size(); });
+    auto       second = task.then([](const std::string& value) { return value.size(); });
+
+    THEN("each of them sees the whole value")
+    {
+      REQUIRE(first.get() == text.size());
+      REQUIRE(second.get() == text.size());
+      REQUIRE(task.get() == text);
+      REQUIRE(task.get() == text);
+      REQUIRE(std::move(task).get() == text);
+    }
+  }
+
+  GIVEN("a task whose value cannot be copied")
+  {
+    auto task = pool.submit([] { return std::make_unique<int>(3); }).then([](std::unique_ptr<int> value) { return *value + 1; });
+
+    THEN("its single continuation takes it")
+    {
+      REQUIRE(task.get() == 4);
+    }
+  }
+}
+
+SCENARIO("Tasks can be cancelled", "[thread_pool]")  // NOLINT
+{
+  sharif::ThreadPool pool{ 1 };
+
+  GIVEN("a task queued behind a busy worker")
+  {
+    std::promise<void> release;
+    auto               busy    = pool.submit([gate = release.get_future()]() mutable { gate.wait(); });
+    auto               waiting = pool.submit([] { return 1; });
+
+    WHEN("it is cancelled before it starts")
+    {
+      waiting.cancel();
+      release.set_value();
+      busy.get();
+
+      THEN("it completes as cancelled without running")
+      {
+        REQUIRE_THROWS_AS(waiting.get(), std::system_error);
+      }
+    }
+  }
+
+  GIVEN("a running job that watches its stop token")
+  {
+    std::atomic<bool> started{ false };
+    auto              task = pool.submit([&started](std::stop_token stop) {
+      started = true;
+      while (!stop.stop_requested())
+      {
+        std::this_thread::yield();
+      }
+      return 7;
+    });
+
+    while (!started)
+    {
+      std::this_thread::yield();
+    }
+    task.cancel();
+    REQUIRE(task.get() == 7);
+  }
+}
+
+SCENARIO("asio handlers run on the pool", "[thread_pool]")  // NOLINT
+{
+  sharif::ThreadPool pool{ 2 };
+  asio::io_context   ctx;
+
+  std::promise<bool> on_pool;
+  auto               result = on_pool.get_future();
+
+  asio::steady_timer timer{ ctx, std::chrono::milliseconds{ 1 } };
+  timer.async_wait(asio::bind_executor(pool.executor(), [&pool, &on_pool](const auto&) { on_pool.set_value(pool.is_worker()); }));
+  ctx.run();
+  REQUIRE(result.get());
+
+  std::promise<bool> posted;
+  asio::post(pool.executor(), [&pool, &posted] { posted.set_value(pool.is_worker()); });
+  REQUIRE(posted.get_future().get());
+}